@@ -0,0 +1,34 @@
+//#pragma once
+#if !defined(_BenchTimer_H_)
+#define _BenchTimer_H_
+
+// -------------------------------------------------
+// BenchTimer.H -- The timer shared by the benchmarks
+// -------------------------------------------------
+//
+// TimeBatch() runs fBatch at least 3 times and until at least fMinMS has passed, and returns the fastest run in milliseconds
+// (the run least disturbed by the rest of the system).
+//
+#include <chrono>
+
+template <class _t>
+static double TimeBatch(_t fBatch,double fMinMS = 300.0)
+{
+	using Clock = std::chrono::high_resolution_clock;
+	double fBest  = 1e30;
+	double fTotal = 0;
+	int iRuns = 0;
+
+	while (fTotal < fMinMS || iRuns < 3)
+	{
+		auto tStart = Clock::now();
+		fBatch();
+		double fTime = std::chrono::duration<double,std::milli>(Clock::now() - tStart).count();
+		if (fTime < fBest) fBest = fTime;
+		fTotal += fTime;
+		iRuns++;
+	}
+	return fBest;
+}
+
+#endif // _BenchTimer_H_
@@ -0,0 +1,169 @@
+
+// ---------------------------------------------------
+// SageBox -- Bitmap Copy Benchmark (Windows only)
+// ---------------------------------------------------
+//
+// Counts the allocations and pixel bytes copied when CSageBitmap and CSharedBitmap (see include/CRawBitmap.h) are passed
+// around an image pipeline, and times each case on a 1920x1080 bitmap:
+//
+//		Return by value	-- a CSageBitmap returned from a function (one return path, and a choice of two)
+//		Move			-- move construction and move assignment
+//		Copy			-- copy construction and copy assignment (the deep copies the other cases avoid)
+//		COW				-- CSharedBitmap: sharing, Read(), Write() when shared and not shared, Detach() when shared and not shared
+//
+// Deep copies and bytes copied come from CSageBitmap::GetCopyStats().  Allocations are counted with a replacement operator new,
+// so they include the shared_ptr blocks of CSharedBitmap as well as bitmaps from CSageBitmap::CreateBitmap().  Each case is
+// checked against the counts it should have.
+//
+// This links with the SageBox library:
+//
+//		cl /O2 /std:c++17 /EHsc /I..\..\include main.cpp ..\..\lib\SageBox64.lib Msimg32.lib
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include "CRawBitmap.h"
+
+static constexpr int kWidth		= 1920;
+static constexpr int kHeight	= 1080;
+static constexpr int kRuns		= 200;
+
+// Replacement operator new/delete -- counts allocations (all threads)
+
+static std::atomic<long long> iAllocations { 0 };
+
+void * operator new(size_t iSize)
+{
+	iAllocations.fetch_add(1,std::memory_order_relaxed);
+	if (void * pMem = malloc(iSize ? iSize : 1)) return pMem;
+	throw std::bad_alloc();
+}
+void operator delete(void * pMem) noexcept				{ free(pMem); }
+void operator delete(void * pMem,size_t) noexcept		{ free(pMem); }
+
+static CSageBitmap MakeBitmap()
+{
+	CSageBitmap cBitmap;
+	cBitmap.CreateBitmap(kWidth,kHeight);
+	return cBitmap;								// Returned in place (or moved)
+}
+
+static CSageBitmap ChooseBitmap(bool bFirst)
+{
+	CSageBitmap cFirst	= MakeBitmap();
+	CSageBitmap cSecond	= MakeBitmap();
+	if (bFirst) return cFirst;					// Two return paths -- each is moved out, not copied
+	return cSecond;
+}
+
+struct Counts_t
+{
+	long long iAllocations;
+	long long iCopies;
+	long long iBytesCopied;
+	long long iMoves;
+};
+
+// Measure() -- Run fCase kRuns times, and print the counts and time per run.  Returns false if the counts per run aren't
+// stExpected (iAllocations < 0 to skip checking allocations).
+
+template <class _t>
+static bool Measure(const char * sName,const Counts_t & stExpected,_t fCase)
+{
+	CSageBitmap::ResetCopyStats();
+	long long iStart = iAllocations.load();
+	auto tStart = std::chrono::high_resolution_clock::now();
+
+	for (int i=0;i<kRuns;i++) fCase();
+
+	double fMS = std::chrono::duration<double,std::milli>(std::chrono::high_resolution_clock::now() - tStart).count()/kRuns;
+	auto stStats = CSageBitmap::GetCopyStats();
+	Counts_t stCounts = { (iAllocations.load() - iStart)/kRuns, stStats.iCopies/kRuns, stStats.iBytesCopied/kRuns, stStats.iMoves/kRuns };
+
+	printf("%-34s %8lld %8lld %14lld %8lld %12.3f ms\n",sName,stCounts.iAllocations,stCounts.iCopies,stCounts.iBytesCopied,stCounts.iMoves,fMS);
+
+	bool bOk = stCounts.iCopies == stExpected.iCopies && stCounts.iBytesCopied == stExpected.iBytesCopied &&
+			   (stExpected.iAllocations < 0 || stCounts.iAllocations == stExpected.iAllocations);
+	if (!bOk) printf("    expected %lld allocations, %lld copies, %lld bytes copied\n",stExpected.iAllocations,stExpected.iCopies,stExpected.iBytesCopied);
+	return bOk;
+}
+
+int main()
+{
+	CSageBitmap cSource = MakeBitmap();
+	if (!cSource.isValid()) { printf("Couldn't create a %dx%d bitmap\n",kWidth,kHeight); return 1; }
+	cSource.FillColor((DWORD) RGB(0,128,255));
+
+	const long long iBitmapBytes = (long long) cSource.GetWidthBytes()*kHeight;
+
+	// Allocations per bitmap from CreateBitmap() (operator new, or 0 if the library uses malloc())
+
+	long long iStart = iAllocations.load();
+	{ CSageBitmap cTemp = MakeBitmap(); }
+	const long long iPerBitmap = iAllocations.load() - iStart;
+
+	printf("%dx%d bitmap, %lld bytes, %d runs per case\n\n",kWidth,kHeight,iBitmapBytes,kRuns);
+	printf("%-34s %8s %8s %14s %8s %15s\n","Case","Allocs","Copies","Bytes copied","Moves","Time");
+
+	bool bOk = true;
+
+	// Return by value
+
+	bOk &= Measure("Return by value",{ iPerBitmap, 0, 0 },[&] { CSageBitmap cBitmap = MakeBitmap(); });
+	bOk &= Measure("Return by value (two paths)",{ 2*iPerBitmap, 0, 0 },[&] { CSageBitmap cBitmap = ChooseBitmap(true); });
+	bOk &= Measure("Assign a returned bitmap",{ iPerBitmap, 0, 0 },[&] { CSageBitmap cBitmap; cBitmap = MakeBitmap(); });
+
+	// Move
+
+	CSageBitmap cHeld = MakeBitmap();
+	bOk &= Measure("Move construct",{ 0, 0, 0 },[&] { CSageBitmap cBitmap(std::move(cHeld)); cHeld = std::move(cBitmap); });
+	bOk &= Measure("Move assign",{ 0, 0, 0 },[&] { CSageBitmap cBitmap; cBitmap = std::move(cHeld); cHeld = std::move(cBitmap); });
+
+	// Copy -- one deep copy each
+
+	bOk &= Measure("Copy construct",{ -1, 1, iBitmapBytes },[&] { CSageBitmap cBitmap(cSource); });
+	bOk &= Measure("Copy assign",{ -1, 1, iBitmapBytes },[&] { CSageBitmap cBitmap; cBitmap = cSource; });
+
+	// Copy-on-write -- copies only when a shared bitmap is written to or detached
+
+	CSharedBitmap cShared = MakeBitmap();
+	bOk &= Measure("COW share x8",{ 0, 0, 0 },[&]
+	{
+		CSharedBitmap cCopies[8];
+		for (auto & cCopy : cCopies) cCopy = cShared;
+	});
+
+	volatile int iSum = 0;
+	bOk &= Measure("COW Read() shared",{ 0, 0, 0 },[&]
+	{
+		CSharedBitmap cCopy = cShared;
+		iSum = iSum + cCopy.Read().GetWidth() + cShared.Read().GetHeight();
+	});
+	bOk &= Measure("COW Write() shared",{ -1, 1, iBitmapBytes },[&]
+	{
+		CSharedBitmap cCopy = cShared;
+		cCopy.Write().FillColor((DWORD) RGB(255,0,0));		// Copied here, so cShared is untouched
+	});
+	bOk &= Measure("COW Write() not shared",{ 0, 0, 0 },[&] { cShared.Write().FillColor((DWORD) RGB(0,128,255)); });
+	bOk &= Measure("COW Detach() shared",{ -1, 1, iBitmapBytes },[&]
+	{
+		CSharedBitmap cCopy = cShared;
+		CSageBitmap cBitmap = cCopy.Detach();
+	});
+	bOk &= Measure("COW Detach() not shared",{ 1, 0, 0 },[&]
+	{
+		CSageBitmap cBitmap = cShared.Detach();					// Moved out...
+		cShared = std::move(cBitmap);							// ...and back in (a new shared_ptr block)
+	});
+
+	// The shared bitmap must not have seen the write to its copy
+
+	unsigned char * sPixel = cShared.Read().stBitmap.stMem;
+	if (!sPixel || sPixel[0] != 255 || sPixel[1] != 128 || sPixel[2] != 0) { printf("COW Write() changed the shared bitmap\n"); bOk = false; }
+
+	if (!bOk) printf("\nSome counts were not as expected.\n");
+	return bOk ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+
+// ------------------------------------------
+// SageBox -- Color Name Benchmark (Portable)
+// ------------------------------------------
+//
+// Times 1M color name resolutions (as for fgColor("Red"), bgColor("MyRed"), Cls("Blue"), etc.) three ways:
+//
+//		Linear		-- a case-insensitive search through the stock colors, then the user colors
+//		Table		-- Core::CColorTable (see include/Core/CColorTable.h): a compile-time perfect hash for the stock colors and an
+//					   open-addressing map for user colors
+//		Cached		-- COptParse::GetColor() on options already read once, as when a control reads its colors again on a redraw;
+//					   the resolved color is cached with the option
+//
+// Build:
+//
+//		g++ -O2 -std=c++17 -I../../include main.cpp -o ColorBench
+//		cl /O2 /std:c++17 /I..\..\include main.cpp
+//
+// Usage: ColorBench [UserColors]		-- Number of user colors made with MakeColor() (default 32)
+//
+// The names are 3/4 stock colors (in mixed case) and 1/4 user colors.  The results are checked against the linear search.
+//
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include "Core/COptParse.h"
+#include "../BenchTimer.h"
+
+using namespace Sage;
+
+static constexpr int kLookups = 1000000;
+
+// FindLinear() -- The linear search
+
+static bool FindLinear(const std::vector<Core::NamedColor_t> & vUser,const char * sName,Core::Color_t & rgbColor)
+{
+	for (auto & stColor : Core::kStockColors) if (Core::SameColorName(stColor.sName,sName)) { rgbColor = stColor.rgbColor; return true; }
+	for (auto & stColor : vUser) if (Core::SameColorName(stColor.sName,sName)) { rgbColor = stColor.rgbColor; return true; }
+	return false;
+}
+
+int main(int argc,char * argv[])
+{
+	int iUserColors = argc > 1 ? atoi(argv[1]) : 32;
+	if (iUserColors < 1)
+	{
+		printf("Usage: ColorBench [UserColors]\n");
+		return 1;
+	}
+
+	// User colors, in the table and in a list for the linear search
+
+	Core::CColorTable & cTable = Core::GetColorTable();
+	std::vector<std::string> vUserNames;
+	std::vector<Core::NamedColor_t> vUser;
+	for (int i=0;i<iUserColors;i++) vUserNames.push_back("MyColor" + std::to_string(i));
+	for (int i=0;i<iUserColors;i++)
+	{
+		Core::Color_t rgbColor = Core::MakeRGB(i*37,i*11,255 - i*5);
+		vUser.push_back({ vUserNames[i].c_str(), rgbColor });
+		cTable.MakeColor(vUserNames[i].c_str(),rgbColor);
+	}
+
+	// The names looked up: 3/4 stock (upper, lower or as written), 1/4 user
+
+	std::vector<std::string> vNames;
+	for (int i=0;i<1024;i++)
+	{
+		if (i % 4 == 3) { vNames.push_back(vUserNames[(i*7) % iUserColors]); continue; }
+		std::string sName = Core::kStockColors[(i*13) % Core::kStockColorCount].sName;
+		for (auto & c : sName) if (i % 3 == 1) c = (char) toupper(c); else if (i % 3 == 2) c = (char) tolower(c);
+		vNames.push_back(sName);
+	}
+
+	// Options strings for the cached reads, one per name
+
+	std::vector<Core::COptParse> vOpts(vNames.size());
+	for (size_t i=0;i<vNames.size();i++) vOpts[i].Parse(("fgColor=\"" + vNames[i] + "\"").c_str());
+
+	for (size_t i=0;i<vNames.size();i++)
+	{
+		Core::Color_t rgbLinear = 0, rgbTable = 1, rgbCached = 2;
+		bool bLinear = FindLinear(vUser,vNames[i].c_str(),rgbLinear);
+		bool bTable	 = cTable.GetColor(vNames[i].c_str(),rgbTable);
+		bool bCached = vOpts[i].GetColor(Core::OptKey::fgColor,rgbCached);
+		if (!bLinear || !bTable || !bCached || rgbLinear != rgbTable || rgbLinear != rgbCached) { printf("Mismatch: %s\n",vNames[i].c_str()); return 1; }
+	}
+
+	volatile unsigned int uiSum = 0;			// Keeps the lookups from being optimized away
+	auto fLookups = [&](auto fFind)
+	{
+		return TimeBatch([&]
+		{
+			Core::Color_t rgbColor = 0;
+			for (int i=0;i<kLookups;i++) { fFind(i & 1023,rgbColor); uiSum = uiSum + rgbColor; }
+		});
+	};
+
+	double fLinear	= fLookups([&](int i,Core::Color_t & rgbColor) { FindLinear(vUser,vNames[i].c_str(),rgbColor); });
+	double fTable	= fLookups([&](int i,Core::Color_t & rgbColor) { cTable.GetColor(vNames[i].c_str(),rgbColor); });
+	double fCached	= fLookups([&](int i,Core::Color_t & rgbColor) { vOpts[i].GetColor(Core::OptKey::fgColor,rgbColor); });
+
+	printf("%d stock colors, %d user colors, %d lookups\n\n",Core::kStockColorCount,iUserColors,kLookups);
+	printf("%-10s %12s %14s %10s\n","","Total","Per lookup","Speed-up");
+	printf("%-10s %9.2f ms %11.1f ns %9.1fx\n","Linear",fLinear,fLinear*1e6/kLookups,1.0);
+	printf("%-10s %9.2f ms %11.1f ns %9.1fx\n","Table",fTable,fTable*1e6/kLookups,fLinear/fTable);
+	printf("%-10s %9.2f ms %11.1f ns %9.1fx\n","Cached",fCached,fCached*1e6/kLookups,fLinear/fCached);
+	return 0;
+}
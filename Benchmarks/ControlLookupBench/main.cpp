@@ -0,0 +1,107 @@
+
+// ----------------------------------------------
+// SageBox -- Control Lookup Benchmark (Portable)
+// ----------------------------------------------
+//
+// Times finding controls by name and by ID, as button("MyButton") and button(1) do in event handlers, two ways:
+//
+//		Search		-- a search through the window's controls, as CWindow::button(), editbox(), etc. do
+//		Index		-- Core::CControlMap (see include/Core/CControlMap.h), the name and ID hash maps CControlIndex keeps for
+//					   each control type of a window (see include/CControlIndex.h)
+//
+// The controls here are stand-ins with a name and an ID.
+//
+// Build:
+//
+//		g++ -O2 -std=c++17 -I../../include main.cpp -o ControlLookupBench
+//		cl /O2 /std:c++17 /I..\..\include main.cpp
+//
+// Usage: ControlLookupBench [Controls] [Lookups]		-- Defaults are 1000 controls and 10000 lookups
+//
+// Lookups are spread evenly over the controls, half by name and half by ID.  The index results are checked against the search.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "Core/CControlMap.h"
+#include "../BenchTimer.h"
+
+using namespace Sage;
+
+struct Control_t
+{
+	std::string sName;
+	int iID;
+};
+
+// Search() -- The search through the controls, as CWindow does it
+
+static Control_t * Search(std::vector<Control_t> & vControls,const char * sName)
+{
+	for (auto & stControl : vControls) if (!strcmp(stControl.sName.c_str(),sName)) return &stControl;
+	return nullptr;
+}
+
+static Control_t * Search(std::vector<Control_t> & vControls,int iID)
+{
+	for (auto & stControl : vControls) if (stControl.iID == iID) return &stControl;
+	return nullptr;
+}
+
+int main(int argc,char * argv[])
+{
+	int iControls	= argc > 1 ? atoi(argv[1]) : 1000;
+	int iLookups	= argc > 2 ? atoi(argv[2]) : 10000;
+	if (iControls < 1 || iLookups < 1)
+	{
+		printf("Usage: ControlLookupBench [Controls] [Lookups]\n");
+		return 1;
+	}
+
+	std::vector<Control_t> vControls(iControls);
+	Core::CControlMap<Control_t> cMap;
+	for (int i=0;i<iControls;i++)
+	{
+		vControls[i] = { "Button" + std::to_string(i), 1000 + i };
+		cMap.Add(&vControls[i],vControls[i].sName.c_str(),vControls[i].iID);
+	}
+
+	// The lookups, spread over the controls (the same control isn't looked up twice in a row)
+
+	std::vector<std::string> vNames;
+	std::vector<int> vIDs;
+	for (int i=0;i<iLookups/2;i++)
+	{
+		int iControl = (int) ((i*7919LL) % iControls);
+		vNames.push_back(vControls[iControl].sName);
+		vIDs.push_back(vControls[iControl].iID);
+	}
+
+	for (size_t i=0;i<vNames.size();i++)
+		if (cMap.Find(vNames[i].c_str()) != Search(vControls,vNames[i].c_str()) || cMap.Find(vIDs[i]) != Search(vControls,vIDs[i]))
+		{
+			printf("Mismatch: %s\n",vNames[i].c_str());
+			return 1;
+		}
+
+	volatile int iSum = 0;			// Keeps the lookups from being optimized away
+	double fSearch = TimeBatch([&]
+	{
+		for (size_t i=0;i<vNames.size();i++) iSum = iSum + Search(vControls,vNames[i].c_str())->iID + Search(vControls,vIDs[i])->iID;
+	});
+	double fIndex = TimeBatch([&]
+	{
+		for (size_t i=0;i<vNames.size();i++) iSum = iSum + cMap.Find(vNames[i].c_str())->iID + cMap.Find(vIDs[i])->iID;
+	});
+
+	int iTotal = (int) vNames.size()*2;
+	printf("%d controls, %d lookups (half by name, half by ID)\n\n",iControls,iTotal);
+	printf("%-10s %12s %14s\n","","Total","Per lookup");
+	printf("%-10s %9.3f ms %11.1f ns\n","Search",fSearch,fSearch*1e6/iTotal);
+	printf("%-10s %9.3f ms %11.1f ns\n","Index",fIndex,fIndex*1e6/iTotal);
+	printf("\n%.0fx faster\n",fSearch/fIndex);
+	return 0;
+}
@@ -0,0 +1,206 @@
+
+// --------------------------------------------
+// SageBox -- Dirty Region Benchmark (Portable)
+// --------------------------------------------
+//
+// Simulates a text-heavy console window -- 8x16 character cells on a 1280x800 canvas -- drawing into a back buffer and
+// presenting it to a front buffer (as Update() and UpdateRegion() copy the window's bitmap to the screen), two ways:
+//
+//		Full		-- the whole canvas is presented each frame something was drawn, as Update() does now
+//		Dirty		-- only the rectangles drawn into are presented, merged by Core::CDirtyRegion (see include/Core/CDirtyRegion.h),
+//					   or the whole canvas past the coverage threshold
+//
+// Three consoles are run, each for 2000 frames:
+//
+//		Typing		-- a few characters typed on the current line each frame, with a new line now and then
+//		Dashboard	-- 24 fields of 12 characters, in a grid, with 6 of them changing each frame
+//		Scrolling	-- a log, scrolling a line every 4th frame (a scroll redraws everything, so those frames are full)
+//
+// For each, it reports the pixels and rectangles presented per frame, the full frames, and the time per frame.  The front buffer
+// is checked against the back buffer after every frame.
+//
+// Build:
+//
+//		g++ -O2 -std=c++17 -I../../include main.cpp -o DirtyRegionBench
+//		cl /O2 /std:c++17 /EHsc /I..\..\include main.cpp
+//
+// Usage: DirtyRegionBench [Threshold]		-- The coverage threshold, 0-1 (default 0.5)
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include "Core/CDirtyRegion.h"
+
+using namespace Sage;
+
+static constexpr int kWidth			= 1280;
+static constexpr int kHeight		= 800;
+static constexpr int kCharWidth		= 8;
+static constexpr int kCharHeight	= 16;
+static constexpr int kColumns		= kWidth/kCharWidth;
+static constexpr int kRows			= kHeight/kCharHeight;
+static constexpr int kFrames		= 2000;
+
+class CConsole
+{
+public:
+	std::vector<unsigned int> vBack;
+	std::vector<unsigned int> vFront;
+	Core::CDirtyRegion cRegion;
+	bool bDirty = false;			// Something was drawn (for Full)
+
+	CConsole() : vBack(kWidth*kHeight,0), vFront(kWidth*kHeight,0), cRegion(kWidth,kHeight) { }
+
+	// DrawText() -- "Draw" iLength characters at a cell: fill the cells with a value standing in for the glyphs
+
+	void DrawText(int iColumn,int iRow,int iLength,unsigned int uiValue)
+	{
+		if (iColumn + iLength > kColumns) iLength = kColumns - iColumn;
+		for (int y=0;y<kCharHeight;y++)
+		{
+			unsigned int * pRow = &vBack[(iRow*kCharHeight + y)*kWidth + iColumn*kCharWidth];
+			for (int x=0;x<iLength*kCharWidth;x++) pRow[x] = uiValue + x/kCharWidth;
+		}
+		cRegion.Add(iColumn*kCharWidth,iRow*kCharHeight,iLength*kCharWidth,kCharHeight);
+		bDirty = true;
+	}
+
+	// Scroll() -- Move the text up a line and clear the last line
+
+	void Scroll()
+	{
+		memmove(vBack.data(),vBack.data() + kWidth*kCharHeight,sizeof(unsigned int)*kWidth*(kHeight - kCharHeight));
+		memset(vBack.data() + kWidth*(kHeight - kCharHeight),0,sizeof(unsigned int)*kWidth*kCharHeight);
+		cRegion.AddAll();
+		bDirty = true;
+	}
+
+	void PresentRect(const Core::Rect_t & rRect)
+	{
+		for (int y=rRect.top;y<rRect.bottom;y++)
+			memcpy(&vFront[y*kWidth + rRect.left],&vBack[y*kWidth + rRect.left],sizeof(unsigned int)*(rRect.right - rRect.left));
+	}
+	void PresentFull() { memcpy(vFront.data(),vBack.data(),sizeof(unsigned int)*kWidth*kHeight); }
+
+	// Present() -- Present the frame, returning the pixels presented
+
+	long long Present(bool bRegions)
+	{
+		if (!bRegions)
+		{
+			cRegion.Clear();
+			if (!bDirty) return 0;
+			bDirty = false;
+			PresentFull();
+			return (long long) kWidth*kHeight;
+		}
+		bDirty = false;
+		if (!cRegion.Present([&](const Core::Rect_t & rRect) { PresentRect(rRect); },[&] { PresentFull(); })) return 0;
+		return cRegion.GetStats().iLastPixels;
+	}
+};
+
+struct Result_t
+{
+	long long iPixels;
+	long long iRects;
+	long long iFullFrames;
+	double fMSPerFrame;
+	bool bMatch;
+};
+
+// Run() -- Run one console; fFrame(cConsole,iFrame) draws a frame
+
+template <class _t>
+static Result_t Run(bool bRegions,double fThreshold,_t fFrame)
+{
+	CConsole cConsole;
+	cConsole.cRegion.SetThreshold(fThreshold);
+	Result_t stResult { 0, 0, 0, 0, true };
+
+	double fPresentMS = 0;
+	for (int i=0;i<kFrames;i++)
+	{
+		fFrame(cConsole,i);
+		auto tStart = std::chrono::high_resolution_clock::now();
+		long long iPixels = cConsole.Present(bRegions);
+		fPresentMS += std::chrono::duration<double,std::milli>(std::chrono::high_resolution_clock::now() - tStart).count();
+
+		stResult.iPixels += iPixels;
+		if (!bRegions && iPixels) { stResult.iRects++; stResult.iFullFrames++; }
+		if (cConsole.vFront != cConsole.vBack) stResult.bMatch = false;
+	}
+	if (bRegions)
+	{
+		stResult.iRects		 = cConsole.cRegion.GetStats().iRects;
+		stResult.iFullFrames = cConsole.cRegion.GetStats().iFullFrames;
+	}
+	stResult.fMSPerFrame = fPresentMS/kFrames;
+	return stResult;
+}
+
+template <class _t>
+static bool Compare(const char * sName,double fThreshold,_t fFrame)
+{
+	Result_t stFull		= Run(false,fThreshold,fFrame);
+	Result_t stDirty	= Run(true,fThreshold,fFrame);
+	if (!stFull.bMatch || !stDirty.bMatch) { printf("%s: the front buffer doesn't match the back buffer\n",sName); return false; }
+
+	auto fPrint = [&](const char * sLabel,const char * sMode,const Result_t & stResult)
+	{
+		printf("%-10s %-6s %12.0f %10.1f %8lld %12.1f us",sLabel,sMode,(double) stResult.iPixels/kFrames,(double) stResult.iRects/kFrames,
+			   stResult.iFullFrames,stResult.fMSPerFrame*1000);
+	};
+	fPrint(sName,"Full",stFull);
+	printf("\n");
+	fPrint("","Dirty",stDirty);
+	printf(" %8.1fx\n",stFull.fMSPerFrame/stDirty.fMSPerFrame);
+	return true;
+}
+
+int main(int argc,char * argv[])
+{
+	double fThreshold = argc > 1 ? atof(argv[1]) : 0.5;
+	if (fThreshold <= 0 || fThreshold > 1)
+	{
+		printf("Usage: DirtyRegionBench [Threshold]\n");
+		return 1;
+	}
+
+	printf("%dx%d canvas, %dx%d characters, %d frames, threshold %.2f\n\n",kWidth,kHeight,kColumns,kRows,kFrames,fThreshold);
+	printf("%-10s %-6s %12s %10s %8s %15s %9s\n","Console","","Pixels/frame","Rects","Full","Present/frame","Speed-up");
+
+	// Typing -- 3 characters a frame, a new line every 40 characters
+
+	bool bOk = Compare("Typing",fThreshold,[](CConsole & cConsole,int iFrame)
+	{
+		int iChar = iFrame*3;
+		cConsole.DrawText(iChar % 40,(iChar/40) % kRows,3,(unsigned int) iFrame);
+	});
+
+	// Dashboard -- 24 fields in a 4x6 grid, 6 changing each frame
+
+	bOk = bOk && Compare("Dashboard",fThreshold,[](CConsole & cConsole,int iFrame)
+	{
+		for (int i=0;i<6;i++)
+		{
+			int iField = (iFrame*5 + i*7) % 24;
+			cConsole.DrawText(2 + (iField % 4)*38,4 + (iField/4)*7,12,(unsigned int) (iFrame*31 + i));
+		}
+	});
+
+	// Scrolling -- a 60-character log line every 4th frame, scrolling when the window is full
+
+	bOk = bOk && Compare("Scrolling",fThreshold,[](CConsole & cConsole,int iFrame)
+	{
+		if (iFrame % 4) { cConsole.DrawText(kColumns - 10,0,8,(unsigned int) iFrame); return; }		// A clock in the corner
+		int iLine = iFrame/4;
+		if (iLine >= kRows - 1) cConsole.Scroll();
+		cConsole.DrawText(0,iLine < kRows - 1 ? iLine + 1 : kRows - 1,60,(unsigned int) iFrame);
+	});
+
+	return bOk ? 0 : 1;
+}
@@ -0,0 +1,162 @@
+
+// ------------------------------------------------
+// SageBox -- Event Coalescing Benchmark (Portable)
+// ------------------------------------------------
+//
+// An injector thread posts input-rate events -- mouse moves, wheel turns and two sliders being dragged, with a click now and then --
+// to a Core::CEventQueue (see include/Core/CEventQueue.h).  The event thread takes them with WaitBatch() and calls a handler for
+// each event, as a program redrawing on every change would.  The handler busy-waits for a set time to stand in for
+// UpdateRegion() and a redraw.  This is run twice:
+//
+//		Off		-- every event goes to the handler
+//		On		-- WaitBatch() coalesces runs of mouse moves, wheel and slider events, so the handler sees one event per run
+//
+// For each, it reports the events posted, the handler calls, the time the event thread took to catch up after the last event,
+// and the lag from an event being posted to its handler call (median and maximum).  The final mouse position, wheel total,
+// slider positions and click count seen by the handler are checked to be the same both ways.
+//
+// Build:
+//
+//		g++ -O2 -std=c++17 -pthread -I../../include main.cpp -o EventCoalesceBench
+//		cl /O2 /std:c++17 /EHsc /I..\..\include main.cpp
+//
+// Usage: EventCoalesceBench [Events] [IntervalUs] [WorkUs]	-- Events to post (default 10000), microseconds between events
+//															   (default 100), and microseconds of handler work (default 250)
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "Core/CEventQueue.h"
+
+using namespace Sage;
+
+// The state the handler keeps up to date
+
+struct State_t
+{
+	int iMouseX, iMouseY;
+	int iWheel;
+	int iSlider[2];
+	int iClicks;
+	bool operator == (const State_t & stState) const
+	{
+		return iMouseX == stState.iMouseX && iMouseY == stState.iMouseY && iWheel == stState.iWheel && iSlider[0] == stState.iSlider[0] &&
+			   iSlider[1] == stState.iSlider[1] && iClicks == stState.iClicks;
+	}
+};
+
+struct Result_t
+{
+	int iPosted;
+	int iHandled;
+	double fCatchUpMS;
+	long long iLagMedian, iLagMax;		// Microseconds
+	State_t stState;
+};
+
+// BusyWait() -- The handler's work
+
+static void BusyWait(int iUs)
+{
+	long long iEnd = Core::CEventQueue::GetTimeUs() + iUs;
+	while (Core::CEventQueue::GetTimeUs() < iEnd) { }
+}
+
+static Result_t Run(int iEvents,int iIntervalUs,int iWorkUs,bool bCoalesce)
+{
+	Core::CEventQueue cQueue;
+	Result_t stResult {};
+	std::vector<long long> vLag;
+	long long iLastPostUs = 0;
+
+	std::thread cEventThread([&]
+	{
+		std::vector<Core::Event_t> vEvents;
+		State_t & stState = stResult.stState;
+		while (cQueue.WaitBatch(vEvents,bCoalesce))
+		{
+			for (auto & stEvent : vEvents)
+			{
+				switch (stEvent.eType)
+				{
+					case Core::EventType::MouseMove:	stState.iMouseX = stEvent.iX; stState.iMouseY = stEvent.iY;			break;
+					case Core::EventType::MouseWheel:	stState.iWheel += stEvent.iDelta;										break;
+					case Core::EventType::SliderMoved:	stState.iSlider[stEvent.iID] = stEvent.iValue;							break;
+					case Core::EventType::LButtonDown:	stState.iClicks++;														break;
+					default:																									break;
+				}
+				BusyWait(iWorkUs);
+				vLag.push_back(Core::CEventQueue::GetTimeUs() - stEvent.iTimeUs);
+				stResult.iHandled++;
+			}
+			vEvents.clear();
+		}
+	});
+
+	// The injector -- mostly mouse moves, with the wheel and sliders in runs, and a click every 500 events
+
+	int iSliderPos[2] = { 0, 0 };
+	auto tNext = std::chrono::steady_clock::now();
+	for (int i=0;i<iEvents;i++)
+	{
+		tNext += std::chrono::microseconds(iIntervalUs);
+		std::this_thread::sleep_until(tNext);
+
+		Core::Event_t stEvent {};
+		int iPhase = (i / 50) % 4;
+		if (i % 500 == 499)		{ stEvent.eType = Core::EventType::LButtonDown; stEvent.iX = i % 640; stEvent.iY = i % 480; }
+		else if (iPhase == 1)	{ stEvent.eType = Core::EventType::MouseWheel; stEvent.iDelta = (i & 1) ? 120 : -40; }
+		else if (iPhase == 2)
+		{
+			int iSlider = (i / 7) & 1;
+			int iPos = (iSliderPos[iSlider] + 3) % 100;
+			stEvent.eType = Core::EventType::SliderMoved; stEvent.iID = iSlider; stEvent.iValue = iPos; stEvent.iDelta = iPos - iSliderPos[iSlider];
+			iSliderPos[iSlider] = iPos;
+		}
+		else { stEvent.eType = Core::EventType::MouseMove; stEvent.iX = i % 640; stEvent.iY = (i*3) % 480; }
+		cQueue.Post(stEvent);
+		stResult.iPosted++;
+	}
+	iLastPostUs = Core::CEventQueue::GetTimeUs();
+	cQueue.Close();
+	cEventThread.join();
+
+	stResult.fCatchUpMS = (Core::CEventQueue::GetTimeUs() - iLastPostUs)/1000.0;
+	std::sort(vLag.begin(),vLag.end());
+	stResult.iLagMedian = vLag.empty() ? 0 : vLag[vLag.size()/2];
+	stResult.iLagMax	= vLag.empty() ? 0 : vLag.back();
+	return stResult;
+}
+
+static void PrintResult(const char * sName,const Result_t & stResult)
+{
+	printf("%-6s %8d %10d %12.1f ms %10lld us %12lld us\n",sName,stResult.iPosted,stResult.iHandled,stResult.fCatchUpMS,stResult.iLagMedian,stResult.iLagMax);
+}
+
+int main(int argc,char * argv[])
+{
+	int iEvents		= argc > 1 ? atoi(argv[1]) : 10000;
+	int iIntervalUs	= argc > 2 ? atoi(argv[2]) : 100;
+	int iWorkUs		= argc > 3 ? atoi(argv[3]) : 250;
+	if (iEvents < 1 || iIntervalUs < 1 || iWorkUs < 0)
+	{
+		printf("Usage: EventCoalesceBench [Events] [IntervalUs] [WorkUs]\n");
+		return 1;
+	}
+
+	Result_t stOff	= Run(iEvents,iIntervalUs,iWorkUs,false);
+	Result_t stOn	= Run(iEvents,iIntervalUs,iWorkUs,true);
+
+	if (!(stOff.stState == stOn.stState) || stOff.iHandled != iEvents) { printf("Coalesced events don't give the same state\n"); return 1; }
+
+	printf("%d events every %d us, %d us handler work\n\n",iEvents,iIntervalUs,iWorkUs);
+	printf("%-6s %8s %10s %15s %13s %15s\n","","Posted","Handled","Catch-up","Median lag","Max lag");
+	PrintResult("Off",stOff);
+	PrintResult("On",stOn);
+	printf("\nHandler calls: %.1fx fewer\n",(double) stOff.iHandled/stOn.iHandled);
+	return 0;
+}
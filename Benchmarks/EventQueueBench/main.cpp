@@ -0,0 +1,171 @@
+
+// -------------------------------------------
+// SageBox -- Event Queue Benchmark (Portable)
+// -------------------------------------------
+//
+// An injector thread posts events (as a window's message thread does) to an event thread waiting for them, two ways:
+//
+//		Polling		-- event flags, as WaitforEvent() and MouseClicked()/button().Pressed() use: the injector sets the flag for the
+//					   event (overwriting an event not yet seen), and the event thread checks the flags, sleeping 1ms between checks
+//		Queue		-- Core::CEventQueue (see include/Core/CEventQueue.h): every event is queued, and the event thread sleeps in
+//					   Wait() until one is posted
+//
+// For each, it reports the events received out of those posted, and the latency from post to receipt (median, 99th
+// percentile and maximum).  It then times an idle Wait() of 1 second, to show the CPU time used while there are no events.
+//
+// Build:
+//
+//		g++ -O2 -std=c++17 -pthread -I../../include main.cpp -o EventQueueBench
+//		cl /O2 /std:c++17 /EHsc /I..\..\include main.cpp
+//
+// Usage: EventQueueBench [Events] [IntervalUs]		-- Events to post (default 20000), and microseconds between bursts (default 200)
+//
+// Events are posted in bursts of 1-4 (i.e. a click and the mouse moves around it), with 3 event types, so polling loses events.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <thread>
+#include <vector>
+#include "Core/CEventQueue.h"
+
+using namespace Sage;
+
+static constexpr int kTypes = 3;
+static const Core::EventType kEventTypes[kTypes] = { Core::EventType::LButtonDown, Core::EventType::MouseMove, Core::EventType::ButtonPressed };
+
+struct Result_t
+{
+	int iReceived;
+	std::vector<long long> vLatency;		// Microseconds
+};
+
+// Injector() -- Post iEvents events in bursts, calling fPost(iType,iSequence) for each
+
+template <class _t>
+static void Injector(int iEvents,int iIntervalUs,_t fPost)
+{
+	auto tNext = std::chrono::steady_clock::now();
+	for (int i=0;i<iEvents;)
+	{
+		tNext += std::chrono::microseconds(iIntervalUs);
+		std::this_thread::sleep_until(tNext);
+		int iBurst = 1 + (i*7) % 4;
+		for (int j=0;j<iBurst && i<iEvents;j++,i++) fPost(i % kTypes,i);
+	}
+}
+
+// RunPolling() -- One flag per event type, checked every 1ms
+
+static Result_t RunPolling(int iEvents,int iIntervalUs)
+{
+	struct Flag_t { std::atomic<long long> iTimeUs { 0 }; std::atomic<int> iSequence { -1 }; };
+	Flag_t stFlags[kTypes];
+	std::atomic<bool> bDone { false };
+	Result_t stResult { 0, {} };
+
+	std::thread cEventThread([&]
+	{
+		int iLast[kTypes] = { -1, -1, -1 };
+		for (;;)
+		{
+			bool bDoneNow = bDone.load();
+			for (int i=0;i<kTypes;i++)
+			{
+				int iSequence = stFlags[i].iSequence.load(std::memory_order_acquire);
+				if (iSequence == iLast[i]) continue;
+				iLast[i] = iSequence;
+				stResult.iReceived++;
+				stResult.vLatency.push_back(Core::CEventQueue::GetTimeUs() - stFlags[i].iTimeUs.load(std::memory_order_relaxed));
+			}
+			if (bDoneNow) break;
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	});
+
+	Injector(iEvents,iIntervalUs,[&](int iType,int iSequence)
+	{
+		stFlags[iType].iTimeUs.store(Core::CEventQueue::GetTimeUs(),std::memory_order_relaxed);
+		stFlags[iType].iSequence.store(iSequence,std::memory_order_release);
+	});
+	bDone = true;
+	cEventThread.join();
+	return stResult;
+}
+
+// RunQueue() -- Core::CEventQueue, with the event thread in Wait()
+
+static Result_t RunQueue(int iEvents,int iIntervalUs,bool & bInOrder)
+{
+	Core::CEventQueue cQueue;
+	Result_t stResult { 0, {} };
+	bInOrder = true;
+
+	std::thread cEventThread([&]
+	{
+		Core::Event_t stEvent;
+		while (cQueue.Wait(stEvent))
+		{
+			stResult.vLatency.push_back(Core::CEventQueue::GetTimeUs() - stEvent.iTimeUs);
+			if (stEvent.iValue != stResult.iReceived || stEvent.eType != kEventTypes[stEvent.iValue % kTypes]) bInOrder = false;
+			stResult.iReceived++;
+		}
+	});
+
+	Injector(iEvents,iIntervalUs,[&](int iType,int iSequence)
+	{
+		Core::Event_t stEvent {};
+		stEvent.eType	= kEventTypes[iType];
+		stEvent.iValue	= iSequence;
+		cQueue.Post(stEvent);
+	});
+	cQueue.Close();
+	cEventThread.join();
+	return stResult;
+}
+
+static void PrintResult(const char * sName,int iEvents,Result_t & stResult)
+{
+	auto & v = stResult.vLatency;
+	std::sort(v.begin(),v.end());
+	auto fAt = [&](double fPart) { return v.empty() ? 0 : v[std::min(v.size()-1,(size_t) (fPart*v.size()))]; };
+	printf("%-10s %8d / %-8d %10lld us %10lld us %10lld us\n",sName,stResult.iReceived,iEvents,fAt(0.5),fAt(0.99),v.empty() ? 0 : v.back());
+}
+
+int main(int argc,char * argv[])
+{
+	int iEvents		= argc > 1 ? atoi(argv[1]) : 20000;
+	int iIntervalUs	= argc > 2 ? atoi(argv[2]) : 200;
+	if (iEvents < 1 || iIntervalUs < 1)
+	{
+		printf("Usage: EventQueueBench [Events] [IntervalUs]\n");
+		return 1;
+	}
+
+	bool bInOrder = false;
+	Result_t stPolling	= RunPolling(iEvents,iIntervalUs);
+	Result_t stQueue	= RunQueue(iEvents,iIntervalUs,bInOrder);
+
+	if (stQueue.iReceived != iEvents || !bInOrder) { printf("Queue lost or reordered events (%d of %d received)\n",stQueue.iReceived,iEvents); return 1; }
+
+	printf("%d events, bursts every %d us\n\n",iEvents,iIntervalUs);
+	printf("%-10s %19s %13s %13s %13s\n","","Received","Median","99%","Max");
+	PrintResult("Polling",iEvents,stPolling);
+	PrintResult("Queue",iEvents,stQueue);
+
+	// Idle -- CPU time used by a 1 second Wait() with nothing posted
+
+	Core::CEventQueue cIdle;
+	Core::Event_t stEvent;
+	std::clock_t tStart = std::clock();
+	auto tWallStart = std::chrono::steady_clock::now();
+	bool bEvent = cIdle.Wait(stEvent,1000);
+	double fWall = std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now() - tWallStart).count();
+	double fCPU	 = 1000.0*(std::clock() - tStart)/CLOCKS_PER_SEC;
+	printf("\nIdle Wait(): %s after %.0f ms, %.2f ms CPU\n",bEvent ? "event" : "timed out",fWall,fCPU);
+	return 0;
+}
@@ -0,0 +1,222 @@
+
+// -------------------------------------------
+// SageBox -- JPEG Decode Benchmark (Portable)
+// -------------------------------------------
+//
+// Times Core::CJpegDecoder (see include/Core/CJpegDecoder.h) over a directory of JPEG files.
+// Build:
+//
+//		g++ -O2 -std=c++17 -pthread -I../../include main.cpp -o JpegBench
+//		cl /O2 /std:c++17 /I..\..\include main.cpp
+//
+// Usage: JpegBench Directory [Threads]		-- Threads sets the thread pool size (default: one per hardware thread)
+//
+// The files are read into memory first, so the times are for decoding only.  The whole set is then decoded as a batch
+// with 1 to N threads, one image per task, and reported in images/s and MPixels/s.  With Sage::CJpeg's busy lock, every
+// thread count would give the 1-thread figure.
+//
+// Thumbnails (256x256 best fit, Lanczos3) are then timed two ways, on one thread: a full decode followed by ResizeBitmap(),
+// and a DCT-scaled decode (1/2, 1/4 or 1/8 -- see CJpegDecoder::SetScale()) followed by ResizeBitmap() from the smaller image.
+// The size of the decoded bitmap is shown for each, as that is most of the peak memory.
+//
+// Header probes (Core::ProbeJpeg/ProbeJpegFile -- see include/Core/CJpegInfo.h) are timed over every JPEG file in the
+// directory, progressive ones included, from memory and from the files, in microseconds per image.
+//
+// Files CJpegDecoder doesn't support (i.e. progressive JPEGs) are counted and left out of the decode timings.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "Core/CJpegDecoder.h"
+#include "Core/CResample.h"
+#include "../BenchTimer.h"
+
+using namespace Sage;
+
+struct JpegFile_t
+{
+	std::string sName;
+	std::vector<unsigned char> vData;
+	int iWidth;
+	int iHeight;
+};
+
+// ReadFile() -- Read a whole file into memory
+
+static bool ReadFile(const std::string & sPath,std::vector<unsigned char> & vData)
+{
+	FILE * fp = fopen(sPath.c_str(),"rb");
+	if (!fp) return false;
+	fseek(fp,0,SEEK_END);
+	long iSize = ftell(fp);
+	fseek(fp,0,SEEK_SET);
+	vData.resize(iSize > 0 ? (size_t) iSize : 0);
+	bool bRead = iSize > 0 && fread(vData.data(),1,vData.size(),fp) == vData.size();
+	fclose(fp);
+	return bRead;
+}
+
+// LoadFiles() -- Read every .jpg/.jpeg file in sDirectory that CJpegDecoder can decode
+
+static std::vector<JpegFile_t> LoadFiles(const char * sDirectory,int & iUnsupported,std::vector<JpegFile_t> & vAllFiles)
+{
+	std::vector<JpegFile_t> vFiles;
+	Core::CJpegDecoder cDecoder;
+	iUnsupported = 0;
+
+	std::error_code ecError;
+	for (auto & stEntry : std::filesystem::directory_iterator(sDirectory,ecError))
+	{
+		std::string sExt = stEntry.path().extension().string();
+		for (auto & c : sExt) c = (char) tolower(c);
+		if (sExt != ".jpg" && sExt != ".jpeg") continue;
+
+		JpegFile_t stFile;
+		stFile.sName = stEntry.path().string();
+		if (!ReadFile(stFile.sName,stFile.vData)) continue;
+		vAllFiles.push_back(stFile);
+
+		Core::JpegStatus eStatus = cDecoder.ReadHeader(stFile.vData.data(),stFile.vData.size());
+		if (eStatus == Core::JpegStatus::Unsupported) iUnsupported++;
+		if (eStatus != Core::JpegStatus::Ok) continue;
+
+		stFile.iWidth	= cDecoder.GetWidth();
+		stFile.iHeight	= cDecoder.GetHeight();
+		vFiles.push_back(std::move(stFile));
+	}
+	return vFiles;
+}
+
+// DecodeBatch() -- Decode every file once on iThreads threads.  Returns the number of images that failed.
+
+static int DecodeBatch(const std::vector<JpegFile_t> & vFiles,int iThreads)
+{
+	std::atomic<int> iFailed { 0 };
+	auto fTile = [&](int iFile)
+	{
+		Core::JpegStatus eStatus;
+		Core::Bitmap_t stBitmap = Core::DecodeJpeg(vFiles[iFile].vData.data(),vFiles[iFile].vData.size(),&eStatus);
+		if (eStatus != Core::JpegStatus::Ok) iFailed++;
+		Core::DeleteBitmap(stBitmap);
+	};
+	Core::GetThreadPool().Run((int) vFiles.size(),iThreads,fTile);
+	return iFailed;
+}
+
+static constexpr int kThumbSize = 256;
+
+// ThumbSize() -- Best-fit size of an iWidth x iHeight image in kThumbSize x kThumbSize
+
+static Core::Size_t ThumbSize(int iWidth,int iHeight)
+{
+	double fScale = iWidth > iHeight ? (double) kThumbSize/iWidth : (double) kThumbSize/iHeight;
+	if (fScale > 1.0) fScale = 1.0;
+	Core::Size_t szSize = { (int) (iWidth*fScale + 0.5), (int) (iHeight*fScale + 0.5) };
+	return { szSize.cx < 1 ? 1 : szSize.cx, szSize.cy < 1 ? 1 : szSize.cy };
+}
+
+// MakeThumbnail() -- Decode a file at 1/iScale size and resize it to a thumbnail.  Returns the decoded bitmap size in bytes.
+
+static size_t MakeThumbnail(const JpegFile_t & stFile,int iScale)
+{
+	Core::Bitmap_t stBitmap = Core::DecodeJpeg(stFile.vData.data(),stFile.vData.size(),nullptr,iScale);
+	Core::Size_t szThumb = ThumbSize(stFile.iWidth,stFile.iHeight);
+	Core::Bitmap_t stThumb = Core::CreateBitmap(szThumb.cx,szThumb.cy);
+	Core::ResizeBitmap(stBitmap,stThumb,Core::ResizeFilter::Lanczos3);
+
+	size_t iBytes = (size_t) stBitmap.iWidthBytes*stBitmap.iHeight;
+	Core::DeleteBitmap(stThumb);
+	Core::DeleteBitmap(stBitmap);
+	return iBytes;
+}
+
+int main(int argc,char * argv[])
+{
+	if (argc < 2)
+	{
+		printf("Usage: JpegBench Directory [Threads]\n");
+		return 1;
+	}
+	if (argc > 2) Core::SetThreadCount(atoi(argv[2]));
+
+	int iUnsupported;
+	std::vector<JpegFile_t> vAllFiles;
+	auto vFiles = LoadFiles(argv[1],iUnsupported,vAllFiles);
+	if (vFiles.empty())
+	{
+		printf("No supported JPEG files found in %s (%d unsupported)\n",argv[1],iUnsupported);
+		return 1;
+	}
+
+	double fMPixels = 0;
+	size_t iBytes = 0;
+	for (auto & stFile : vFiles) { fMPixels += (double) stFile.iWidth*stFile.iHeight/1e6; iBytes += stFile.vData.size(); }
+
+	printf("%d images, %.1f MPixels, %.1f MB of JPEG data (%d unsupported files left out)\n\n",(int) vFiles.size(),fMPixels,iBytes/1e6,iUnsupported);
+
+	// Header probes, over all files
+
+	int iProbed = 0;
+	for (auto & stFile : vAllFiles)
+	{
+		Core::JpegInfo_t stInfo;
+		if (Core::ProbeJpeg(stFile.vData.data(),stFile.vData.size(),stInfo) == Core::JpegStatus::Ok) iProbed++;
+	}
+	volatile int iSum = 0;			// Keeps the probes from being optimized away
+	double fProbeMem = TimeBatch([&]
+	{
+		Core::JpegInfo_t stInfo;
+		for (auto & stFile : vAllFiles) { Core::ProbeJpeg(stFile.vData.data(),stFile.vData.size(),stInfo); iSum = iSum + stInfo.iWidth; }
+	});
+	double fProbeFile = TimeBatch([&]
+	{
+		Core::JpegInfo_t stInfo;
+		for (auto & stFile : vAllFiles) { Core::ProbeJpegFile(stFile.sName.c_str(),stInfo); iSum = iSum + stInfo.iWidth; }
+	});
+	printf("Header probe: %d of %d files -- %.3f us/image from memory, %.1f us/image from file\n\n",iProbed,(int) vAllFiles.size(),
+			fProbeMem*1000.0/vAllFiles.size(),fProbeFile*1000.0/vAllFiles.size());
+
+	if (int iFailed = DecodeBatch(vFiles,1))
+	{
+		printf("%d images failed to decode\n",iFailed);
+		return 1;
+	}
+
+	// Batch decode at 1 to N threads
+
+	int iMaxThreads = Core::GetThreadCount(0);
+	double fSingle = 0;
+
+	printf("%-10s %12s %14s %16s %10s\n","Threads","Time","Images/s","MPixels/s","Speed-up");
+	for (int iThreads=1;iThreads<=iMaxThreads;iThreads++)
+	{
+		double fMS = TimeBatch([&] { DecodeBatch(vFiles,iThreads); });
+		if (iThreads == 1) fSingle = fMS;
+		printf("%-10d %9.1f ms %14.1f %16.1f %9.2fx\n",iThreads,fMS,vFiles.size()/(fMS/1000.0),fMPixels/(fMS/1000.0),fSingle/fMS);
+	}
+
+	// Thumbnails: full decode + resize vs. scaled decode + resize
+
+	printf("\n%-24s %-11s %5s %12s %10s %12s %10s %9s\n","Thumbnail","Image","Scale","Full","Decoded","Scaled","Decoded","Speed-up");
+	for (auto & stFile : vFiles)
+	{
+		Core::Size_t szThumb = ThumbSize(stFile.iWidth,stFile.iHeight);
+		int iScale = Core::CJpegDecoder::GetScaleFor(stFile.iWidth,stFile.iHeight,szThumb.cx,szThumb.cy);
+
+		size_t iFullBytes = 0, iScaledBytes = 0;
+		double fFull	= TimeBatch([&] { iFullBytes = MakeThumbnail(stFile,1); });
+		double fScaled	= TimeBatch([&] { iScaledBytes = MakeThumbnail(stFile,iScale); });
+
+		std::string sName = std::filesystem::path(stFile.sName).filename().string();
+		char sSize[32];
+		snprintf(sSize,sizeof(sSize),"%dx%d",stFile.iWidth,stFile.iHeight);
+		printf("%-24.24s %-11s %4s%d %9.1f ms %8.1fMB %9.1f ms %8.1fMB %8.1fx\n",sName.c_str(),sSize,"1/",iScale,
+				fFull,iFullBytes/1e6,fScaled,iScaledBytes/1e6,fFull/fScaled);
+	}
+
+	return 0;
+}
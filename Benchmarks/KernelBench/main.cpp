@@ -0,0 +1,547 @@
+
+// ---------------------------------------------
+// SageBox -- Pixel Kernel Benchmark (Portable)
+// ---------------------------------------------
+//
+// Times each Core pixel kernel (see include/Core/CPixelKernels.h) over bitmap sizes from 256x256 to 8K (7680x4320).
+// Build:
+//
+//		g++ -O2 -std=c++17 -I../../include main.cpp -o KernelBench
+//		cl /O2 /std:c++17 /I..\..\include main.cpp
+//
+// Usage: KernelBench [MaxWidth] [Threads]		-- i.e. "KernelBench 1024" stops at 1024x1024; Threads sets the thread pool size
+//
+// Each kernel is timed with TimeBatch() (see ../BenchTimer.h): the best-case time per call is reported along with MPixels/s.
+//
+// The mask blends are also timed at each SIMD level the CPU supports (Scalar, SSE2, AVX2).  Before timing, each level is
+// checked to give bit-exact output against the scalar reference over a range of odd sizes and offsets.
+//
+// The planar float <-> 24-bit conversions (ConverttoFloat/ConverttoBitmap) are timed at each SIMD level and with 1 to N threads.
+// The tiled (multi-threaded) bitmap kernels are timed with 1 to N threads, after checking they match the single-threaded output.
+// CopyBitmap() within one bitmap is checked in every direction against a copy from a separate snapshot.
+//
+// ResizeBitmap() is timed making 256x256 (best fit) thumbnails of a 24MP (6000x4000) image with each filter, in images per second,
+// at each SIMD level and with 1 to N threads.  This runs when MaxWidth is at least 6000 (the default).
+//
+// Scratch bitmap allocation is timed with malloc() (Core::CreateBitmap) and with the bitmap pool (Core::CreatePooledBitmap), both
+// on its own and with a FillBitmap() in between, as a per-frame scratch bitmap would be used.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "Core/CPixelKernels.h"
+#include "Core/CFloatKernels.h"
+#include "Core/CBitmapPool.h"
+#include "Core/CResample.h"
+#include "../BenchTimer.h"
+
+using namespace Sage;
+
+struct stSize_t
+{
+	int iWidth;
+	int iHeight;
+	const char * sName;
+};
+
+static const stSize_t stSizes[] =
+{
+	{ 256,	256,	"256x256"	},
+	{ 512,	512,	"512x512"	},
+	{ 1024,	1024,	"1024x1024"	},
+	{ 1920,	1080,	"1920x1080"	},
+	{ 3840,	2160,	"3840x2160"	},
+	{ 7680,	4320,	"7680x4320"	},
+};
+
+// FillRandom() -- Fill a bitmap (and its mask plane) with repeatable pseudo-random data
+
+static void FillRandom(Core::Bitmap_t & stBitmap,unsigned int uiSeed)
+{
+	for (int i=0;i<stBitmap.iHeight;i++)
+	{
+		unsigned char * sRow = stBitmap.Row(i);
+		for (int j=0;j<stBitmap.iWidthBytes;j++) { uiSeed = uiSeed*1103515245 + 12345; sRow[j] = (unsigned char) (uiSeed >> 16); }
+		if (stBitmap.sMask)
+		{
+			unsigned char * sMask = stBitmap.MaskRow(i);
+			for (int j=0;j<stBitmap.iWidth;j++) { uiSeed = uiSeed*1103515245 + 12345; sMask[j] = (unsigned char) (uiSeed >> 16); }
+		}
+	}
+}
+
+static void Report(const char * sKernel,const stSize_t & stSize,double fMS,const char * sNote = "")
+{
+	double fMPixels = (double) stSize.iWidth*stSize.iHeight/1e6;
+	printf("%-20s %-10s %10.3f ms %10.1f MPixels/s %s\n",sKernel,stSize.sName,fMS,fMPixels/(fMS/1000.0),sNote);
+}
+
+static const Core::SimdLevel eLevels[] = { Core::SimdLevel::Scalar, Core::SimdLevel::SSE2, Core::SimdLevel::AVX2 };
+
+// SameBitmap() -- Compare the pixels of two bitmaps of the same size (row padding is ignored)
+
+static bool SameBitmap(const Core::Bitmap_t & stBitmap1,const Core::Bitmap_t & stBitmap2)
+{
+	for (int i=0;i<stBitmap1.iHeight;i++)
+		if (memcmp(stBitmap1.Row(i),stBitmap2.Row(i),stBitmap1.iWidth*3)) return false;
+	return true;
+}
+
+// VerifyFloat() -- Check the float conversions at each SIMD level against the scalar versions, including out-of-range and NaN values
+
+static bool VerifyFloat()
+{
+	int iWidth = 77, iHeight = 5;
+	auto fSource		= Core::CreateFloatBitmap(iWidth,iHeight);
+	auto stReference	= Core::CreateBitmap(iWidth,iHeight);
+	auto stDest			= Core::CreateBitmap(iWidth,iHeight);
+	auto fReference		= Core::CreateFloatBitmap(iWidth,iHeight);
+	auto fDest			= Core::CreateFloatBitmap(iWidth,iHeight);
+
+	unsigned int uiSeed = 7;
+	float * fPlanes[3] = { fSource.fRed, fSource.fGreen, fSource.fBlue };
+	for (int i=0;i<iWidth*iHeight;i++)
+		for (auto fPlane : fPlanes)
+		{
+			uiSeed = uiSeed*1103515245 + 12345;
+			fPlane[i] = (float) ((uiSeed >> 8) % 30000)/100.0f - 20.0f;		// -20 to 280, with fractions of .5 included
+		}
+	fSource.fRed[3] = NAN;
+	fSource.fGreen[9] = -INFINITY;
+	fSource.fBlue[20] = INFINITY;
+
+	bool bResult = true;
+	Core::SetSimdLevel(Core::SimdLevel::Scalar);
+	Core::ConverttoBitmap(fSource,stReference);
+	Core::ConverttoFloat(stReference,fReference);
+
+	for (auto eLevel : eLevels)
+	{
+		if (eLevel == Core::SimdLevel::Scalar || !Core::SetSimdLevel(eLevel)) continue;
+
+		Core::ConverttoBitmap(fSource,stDest);
+		Core::ConverttoFloat(stReference,fDest);
+
+		size_t iSize = (size_t) iWidth*iHeight*sizeof(float);
+		if (!SameBitmap(stReference,stDest) || memcmp(fReference.fRed,fDest.fRed,iSize) ||
+			memcmp(fReference.fGreen,fDest.fGreen,iSize) || memcmp(fReference.fBlue,fDest.fBlue,iSize))
+		{
+			printf("SIMD mismatch: %s, float conversion\n",Core::GetRowKernels().sName);
+			bResult = false;
+		}
+	}
+	Core::SetSimdLevel(Core::SimdLevel::Auto);
+
+	Core::DeleteFloatBitmap(fSource);
+	Core::DeleteFloatBitmap(fReference);
+	Core::DeleteFloatBitmap(fDest);
+	Core::DeleteBitmap(stReference);
+	Core::DeleteBitmap(stDest);
+	return bResult;
+}
+
+// VerifySimd() -- Check that every supported SIMD level gives the same output as the scalar kernels.
+// Odd widths and offsets are used so the vector loops and their scalar tails are both covered.
+//
+static bool VerifySimd()
+{
+	bool bResult = true;
+	for (int iWidth=1;iWidth<=133 && bResult;iWidth += 11)
+	{
+		int iHeight = 7;
+		auto stSource		= Core::CreateBitmap(iWidth,iHeight,true);
+		auto stMask			= Core::CreateBitmap(iWidth,iHeight);
+		auto stBackground	= Core::CreateBitmap(iWidth,iHeight);
+		auto stReference	= Core::CreateBitmap(iWidth,iHeight);
+		auto stDest			= Core::CreateBitmap(iWidth,iHeight);
+
+		FillRandom(stSource,iWidth);
+		FillRandom(stMask,iWidth+1);
+		FillRandom(stBackground,iWidth+2);
+
+		Core::Point_t pOffset = { iWidth/3, 1 };
+		Core::Size_t szSize = { iWidth - iWidth/3, iHeight-2 };
+
+		for (auto eLevel : eLevels)
+		{
+			if (eLevel == Core::SimdLevel::Scalar || !Core::GetRowKernelTable(eLevel)) continue;
+
+			for (int iTest=0;iTest<4;iTest++)
+			{
+				for (int iPass=0;iPass<2;iPass++)
+				{
+					Core::SetSimdLevel(iPass ? eLevel : Core::SimdLevel::Scalar);
+					auto & stOut = iPass ? stDest : stReference;
+					Core::CopyBitmap(stBackground,stOut);
+
+					switch (iTest)
+					{
+						case 0: Core::ApplyMaskGraphic(stSource,stMask,stBackground,stOut);							break;
+						case 1: Core::ApplyMaskColor(Core::MakeRGB(255,37,190),stMask,pOffset,stOut,{ 0,1 },szSize);	break;
+						case 2: Core::ApplyMaskColor(Core::MakeRGB(9,200,64),stMask,{ 0,0 },stOut,pOffset,szSize,true);	break;
+						case 3: Core::ApplyMaskGraphic(stSource,pOffset,stOut,{ 0,0 },szSize);						break;
+					}
+				}
+				if (!SameBitmap(stReference,stDest))
+				{
+					printf("SIMD mismatch: %s, test %d, width %d\n",Core::GetRowKernelTable(eLevel)->sName,iTest,iWidth);
+					bResult = false;
+				}
+			}
+		}
+		Core::SetSimdLevel(Core::SimdLevel::Auto);
+
+		Core::DeleteBitmap(stSource);
+		Core::DeleteBitmap(stMask);
+		Core::DeleteBitmap(stBackground);
+		Core::DeleteBitmap(stReference);
+		Core::DeleteBitmap(stDest);
+	}
+	return bResult && VerifyFloat();
+}
+
+// VerifyThreads() -- Check that the tiled kernels give the same output on any number of threads.
+// The threshold is turned off and the pool is given extra threads so tiles are stolen even on small machines.
+//
+static bool VerifyThreads()
+{
+	int iWidth = 1031, iHeight = 517;
+	auto stSource		= Core::CreateBitmap(iWidth,iHeight,true);
+	auto stMask			= Core::CreateBitmap(iWidth,iHeight);
+	auto stBackground	= Core::CreateBitmap(iWidth,iHeight);
+	auto stReference	= Core::CreateBitmap(iWidth,iHeight);
+	auto stDest			= Core::CreateBitmap(iWidth,iHeight);
+
+	FillRandom(stSource,11);
+	FillRandom(stMask,12);
+	FillRandom(stBackground,13);
+
+	int iPoolThreads = Core::GetThreadCount(0);
+	Core::SetThreadCount(iPoolThreads < 4 ? 4 : iPoolThreads);
+	Core::SetParallelThreshold(0);
+
+	Core::Point_t pOffset = { 17, 9 };
+	Core::Size_t szSize = { iWidth - 40, iHeight - 20 };
+
+	bool bResult = true;
+	for (int iTest=0;iTest<7;iTest++)
+	{
+		for (int iPass=0;iPass<2;iPass++)
+		{
+			int iThreads = iPass ? 0 : 1;
+			auto & stOut = iPass ? stDest : stReference;
+			Core::CopyBitmap(stBackground,stOut);
+
+			switch (iTest)
+			{
+				case 0: Core::ApplyMaskGraphic(stSource,stMask,stBackground,stOut,iThreads);									break;
+				case 1: Core::ApplyMaskColor(Core::MakeRGB(255,37,190),stMask,pOffset,stOut,{ 0,1 },szSize,false,iThreads);	break;
+				case 2: Core::ApplyMaskColor(Core::MakeRGB(9,200,64),stMask,{ 0,0 },stOut,pOffset,szSize,true,iThreads);		break;
+				case 3: Core::ApplyMaskGraphic(stSource,pOffset,stOut,{ 0,0 },szSize,false,iThreads);							break;
+				case 4: Core::FillBitmap(stOut,Core::MakeRGB(1,2,3),pOffset,szSize,iThreads);									break;
+				case 5: Core::CopyBitmap(stSource,pOffset,stOut,{ 3,5 },szSize,iThreads);										break;
+				case 6: Core::ReverseBitmap(stOut,iThreads); Core::MasktoBmp(stSource,stOut,iThreads);						break;
+			}
+		}
+		if (!SameBitmap(stReference,stDest))
+		{
+			printf("Thread mismatch: test %d\n",iTest);
+			bResult = false;
+		}
+	}
+	Core::SetParallelThreshold(Core::kParallelMinPixels);
+	Core::SetThreadCount(iPoolThreads);
+
+	Core::DeleteBitmap(stSource);
+	Core::DeleteBitmap(stMask);
+	Core::DeleteBitmap(stBackground);
+	Core::DeleteBitmap(stReference);
+	Core::DeleteBitmap(stDest);
+	return bResult;
+}
+
+// VerifyOverlap() -- Check CopyBitmap() within one bitmap (overlapping source and destination) in every direction, against
+// a copy from a separate snapshot of the bitmap
+
+static bool VerifyOverlap()
+{
+	int iWidth = 257, iHeight = 131;
+	auto stBitmap		= Core::CreateBitmap(iWidth,iHeight);
+	auto stSnapshot		= Core::CreateBitmap(iWidth,iHeight);
+	auto stReference	= Core::CreateBitmap(iWidth,iHeight);
+
+	static const Core::Point_t pOffsets[] = { { 0,7 }, { 0,-7 }, { 5,0 }, { -5,0 }, { 3,1 }, { -3,-1 }, { 9,-4 }, { -9,4 } };
+	Core::Point_t pSource = { 20,20 };
+	Core::Size_t szSize = { iWidth - 40, iHeight - 40 };
+
+	bool bResult = true;
+	for (auto & pOffset : pOffsets)
+	{
+		FillRandom(stBitmap,pOffset.x*31 + pOffset.y);
+		Core::CopyBitmap(stBitmap,stSnapshot);
+		Core::CopyBitmap(stBitmap,stReference);
+
+		Core::Point_t pDest = { pSource.x + pOffset.x, pSource.y + pOffset.y };
+		Core::CopyBitmap(stSnapshot,pSource,stReference,pDest,szSize);
+		Core::CopyBitmap(stBitmap,pSource,stBitmap,pDest,szSize,0);
+
+		if (!SameBitmap(stReference,stBitmap))
+		{
+			printf("Overlapping copy mismatch: offset (%d,%d)\n",pOffset.x,pOffset.y);
+			bResult = false;
+		}
+	}
+
+	Core::DeleteBitmap(stBitmap);
+	Core::DeleteBitmap(stSnapshot);
+	Core::DeleteBitmap(stReference);
+	return bResult;
+}
+
+// VerifyResize() -- Check ResizeBitmap() at each SIMD level against the scalar version, reducing and enlarging with each filter
+
+static bool VerifyResize()
+{
+	static const Core::Size_t szSizes[][2] = { { { 131,97 }, { 50,171 } }, { { 600,5 }, { 256,4 } }, { { 7,64 }, { 700,3 } }, { { 2,2 }, { 3,1 } } };
+	static const Core::ResizeFilter eFilters[] = { Core::ResizeFilter::Box, Core::ResizeFilter::Bilinear, Core::ResizeFilter::Lanczos3 };
+
+	bool bResult = true;
+	for (auto & szPair : szSizes)
+	{
+		auto stSource		= Core::CreateBitmap(szPair[0].cx,szPair[0].cy);
+		auto stReference	= Core::CreateBitmap(szPair[1].cx,szPair[1].cy);
+		auto stDest			= Core::CreateBitmap(szPair[1].cx,szPair[1].cy);
+		FillRandom(stSource,szPair[0].cx);
+
+		for (auto eFilter : eFilters)
+		{
+			Core::SetSimdLevel(Core::SimdLevel::Scalar);
+			Core::ResizeBitmap(stSource,stReference,eFilter);
+
+			for (auto eLevel : eLevels)
+			{
+				if (eLevel == Core::SimdLevel::Scalar || !Core::SetSimdLevel(eLevel)) continue;
+				Core::ResizeBitmap(stSource,stDest,eFilter);
+				if (!SameBitmap(stReference,stDest))
+				{
+					printf("SIMD mismatch: %s, resize %dx%d -> %dx%d, filter %d\n",Core::GetRowKernels().sName,
+							szPair[0].cx,szPair[0].cy,szPair[1].cx,szPair[1].cy,(int) eFilter);
+					bResult = false;
+				}
+			}
+		}
+		Core::SetSimdLevel(Core::SimdLevel::Auto);
+
+		Core::DeleteBitmap(stSource);
+		Core::DeleteBitmap(stReference);
+		Core::DeleteBitmap(stDest);
+	}
+	return bResult;
+}
+
+// ThumbnailBench() -- 24MP -> 256x256 (best fit, so 256x171) thumbnails, in images per second
+
+static void ThumbnailBench()
+{
+	static const Core::ResizeFilter eFilters[]	= { Core::ResizeFilter::Box, Core::ResizeFilter::Bilinear, Core::ResizeFilter::Lanczos3 };
+	static const char * sFilters[]				= { "Box", "Bilinear", "Lanczos3" };
+
+	auto stSource	= Core::CreateBitmap(6000,4000);
+	auto stThumb	= Core::CreateBitmap(256,171);
+	if (!stSource.isValid() || !stThumb.isValid())
+	{
+		printf("Could not allocate the 24MP bitmap\n");
+		return;
+	}
+	FillRandom(stSource,5);
+
+	printf("Thumbnails: 6000x4000 -> 256x171\n");
+	for (int i=0;i<3;i++)
+	{
+		double fScalar = 0;
+		for (auto eLevel : eLevels)
+		{
+			if (!Core::SetSimdLevel(eLevel)) continue;
+			double fMS = TimeBatch([&] { Core::ResizeBitmap(stSource,stThumb,eFilters[i]); });
+			if (eLevel == Core::SimdLevel::Scalar) fScalar = fMS;
+			printf("%-20s %-10s %10.3f ms %12.1f images/s [%s, %.2fx]\n","ResizeBitmap",sFilters[i],fMS,1000.0/fMS,Core::GetRowKernels().sName,fScalar/fMS);
+		}
+		Core::SetSimdLevel(Core::SimdLevel::Auto);
+
+		for (int iThreads=2;iThreads<=Core::GetThreadCount(0);iThreads *= 2)
+		{
+			double fMS = TimeBatch([&] { Core::ResizeBitmap(stSource,stThumb,eFilters[i],iThreads); });
+			printf("%-20s %-10s %10.3f ms %12.1f images/s [%d threads]\n","ResizeBitmap",sFilters[i],fMS,1000.0/fMS,iThreads);
+		}
+	}
+	printf("\n");
+
+	Core::DeleteBitmap(stSource);
+	Core::DeleteBitmap(stThumb);
+}
+
+int main(int argc,char * argv[])
+{
+	int iMaxWidth = argc > 1 ? atoi(argv[1]) : 7680;
+	if (argc > 2) Core::SetThreadCount(atoi(argv[2]));
+	Core::CBitmapPool::SetMaxBytes(Core::CBitmapPool::kDefaultMaxTotalBytes);		// An 8K bitmap with a mask (133MB) is over the per-thread default
+
+	if (!VerifySimd() || !VerifyResize() || !VerifyThreads() || !VerifyOverlap()) return 1;
+	printf("SIMD kernels match the scalar reference, and tiled kernels match on any thread count.\n");
+	printf("Default level: %s, %d threads\n\n",Core::GetRowKernels().sName,Core::GetThreadCount(0));
+
+	printf("%-20s %-10s %13s %20s\n","Kernel","Size","Time","Throughput");
+
+	for (auto & stSize : stSizes)
+	{
+		if (stSize.iWidth > iMaxWidth) break;
+
+		int iWidth = stSize.iWidth, iHeight = stSize.iHeight;
+
+		auto stSource		= Core::CreateBitmap(iWidth,iHeight,true);
+		auto stMask			= Core::CreateBitmap(iWidth,iHeight);
+		auto stBackground	= Core::CreateBitmap(iWidth,iHeight);
+		auto stDest			= Core::CreateBitmap(iWidth,iHeight);
+
+		if (!stSource.isValid() || !stMask.isValid() || !stBackground.isValid() || !stDest.isValid())
+		{
+			printf("Could not allocate %s bitmaps\n",stSize.sName);
+			break;
+		}
+
+		FillRandom(stSource,1);
+		FillRandom(stMask,2);
+		FillRandom(stBackground,3);
+		FillRandom(stDest,4);
+
+		Core::Size_t szSize = { iWidth, iHeight };
+
+		Report("CopyBitmap",stSize,			TimeBatch([&] { Core::CopyBitmap(stSource,stDest); }));
+		Report("FillBitmap",stSize,			TimeBatch([&] { Core::FillBitmap(stDest,Core::MakeRGB(255,128,0)); }));
+		Report("ApplyMaskColor",stSize,		TimeBatch([&] { Core::ApplyMaskColor(Core::MakeRGB(255,128,0),stMask,{ 0,0 },stDest,{ 0,0 },szSize); }));
+		Report("ApplyMaskColorR",stSize,	TimeBatch([&] { Core::ApplyMaskColor(Core::MakeRGB(255,128,0),stMask,{ 0,0 },stDest,{ 0,0 },szSize,true); }));
+		Report("ApplyMaskGraphic",stSize,	TimeBatch([&] { Core::ApplyMaskGraphic(stSource,stMask,stBackground,stDest); }));
+		Report("ApplyMaskGraphic8",stSize,	TimeBatch([&] { Core::ApplyMaskGraphic(stSource,{ 0,0 },stDest,{ 0,0 },szSize); }));
+		Report("ReverseBitmap",stSize,		TimeBatch([&] { Core::ReverseBitmap(stDest); }));
+		Report("MasktoBmp",stSize,			TimeBatch([&] { Core::MasktoBmp(stSource,stDest); }));
+
+		// Mask blends at each SIMD level, with the speed-up over the scalar version
+
+		double fScalar[3] = {};
+		for (auto eLevel : eLevels)
+		{
+			if (!Core::SetSimdLevel(eLevel)) continue;
+			const char * sLevel = Core::GetRowKernels().sName;
+
+			double fTimes[3] =
+			{
+				TimeBatch([&] { Core::ApplyMaskColor(Core::MakeRGB(255,128,0),stMask,{ 0,0 },stDest,{ 0,0 },szSize); }),
+				TimeBatch([&] { Core::ApplyMaskGraphic(stSource,stMask,stBackground,stDest); }),
+				TimeBatch([&] { Core::ApplyMaskGraphic(stSource,{ 0,0 },stDest,{ 0,0 },szSize); }),
+			};
+			const char * sKernels[3] = { "ApplyMaskColor", "ApplyMaskGraphic", "ApplyMaskGraphic8" };
+
+			for (int i=0;i<3;i++)
+			{
+				if (eLevel == Core::SimdLevel::Scalar) fScalar[i] = fTimes[i];
+				char sNote[64];
+				snprintf(sNote,sizeof(sNote),"[%s, %.2fx]",sLevel,fScalar[i]/fTimes[i]);
+				Report(sKernels[i],stSize,fTimes[i],sNote);
+			}
+		}
+		Core::SetSimdLevel(Core::SimdLevel::Auto);
+
+		int iMaxThreads = Core::GetThreadCount(0);
+
+		// Planar float conversions at each SIMD level, then with 1 to N threads at the default level
+
+		auto fBitmap = Core::CreateFloatBitmap(iWidth,iHeight);
+		if (fBitmap.isValid())
+		{
+			Core::ConverttoFloat(stSource,fBitmap);
+
+			double fScalarFloat[2] = {};
+			for (auto eLevel : eLevels)
+			{
+				if (!Core::SetSimdLevel(eLevel)) continue;
+				double fTimes[2] =
+				{
+					TimeBatch([&] { Core::ConverttoFloat(stSource,fBitmap); }),
+					TimeBatch([&] { Core::ConverttoBitmap(fBitmap,stDest); }),
+				};
+				const char * sKernels[2] = { "ConverttoFloat", "ConverttoBitmap" };
+				for (int i=0;i<2;i++)
+				{
+					if (eLevel == Core::SimdLevel::Scalar) fScalarFloat[i] = fTimes[i];
+					char sNote[64];
+					snprintf(sNote,sizeof(sNote),"[%s, %.2fx]",Core::GetRowKernels().sName,fScalarFloat[i]/fTimes[i]);
+					Report(sKernels[i],stSize,fTimes[i],sNote);
+				}
+			}
+			Core::SetSimdLevel(Core::SimdLevel::Auto);
+
+			for (int iThreads=2;iThreads<=iMaxThreads;iThreads *= 2)
+			{
+				char sNote[64];
+				snprintf(sNote,sizeof(sNote),"[%d threads]",iThreads);
+				Report("ConverttoFloat",stSize,TimeBatch([&] { Core::ConverttoFloat(stSource,fBitmap,iThreads); }),sNote);
+				Report("ConverttoBitmap",stSize,TimeBatch([&] { Core::ConverttoBitmap(fBitmap,stDest,iThreads); }),sNote);
+			}
+			Core::DeleteFloatBitmap(fBitmap);
+		}
+
+		// Tiled kernels with 1 to N threads, with the speed-up over one thread
+
+		for (int iThreads=2;iThreads<=iMaxThreads;iThreads *= 2)
+		{
+			const char * sKernels[4] = { "FillBitmap", "CopyBitmap", "ApplyMaskColor", "ApplyMaskGraphic" };
+			double fTimes[4][2];
+			for (int iPass=0;iPass<2;iPass++)
+			{
+				int iRun = iPass ? iThreads : 1;
+				fTimes[0][iPass] = TimeBatch([&] { Core::FillBitmap(stDest,Core::MakeRGB(255,128,0),{ 0,0 },{ 0,0 },iRun); });
+				fTimes[1][iPass] = TimeBatch([&] { Core::CopyBitmap(stSource,stDest,iRun); });
+				fTimes[2][iPass] = TimeBatch([&] { Core::ApplyMaskColor(Core::MakeRGB(255,128,0),stMask,{ 0,0 },stDest,{ 0,0 },szSize,false,iRun); });
+				fTimes[3][iPass] = TimeBatch([&] { Core::ApplyMaskGraphic(stSource,stMask,stBackground,stDest,iRun); });
+			}
+			for (int i=0;i<4;i++)
+			{
+				char sNote[64];
+				snprintf(sNote,sizeof(sNote),"[%d threads, %.2fx]",iThreads,fTimes[i][0]/fTimes[i][1]);
+				Report(sKernels[i],stSize,fTimes[i][1],sNote);
+			}
+		}
+
+		// Scratch bitmap allocation: malloc() vs. the bitmap pool
+
+		double fMalloc[2], fPooled[2];
+		fMalloc[0] = TimeBatch([&] { auto stTemp = Core::CreateBitmap(iWidth,iHeight,true); Core::DeleteBitmap(stTemp); });
+		fMalloc[1] = TimeBatch([&] { auto stTemp = Core::CreateBitmap(iWidth,iHeight,true); Core::FillBitmap(stTemp,0); Core::DeleteBitmap(stTemp); });
+		fPooled[0] = TimeBatch([&] { auto stTemp = Core::CreatePooledBitmap(iWidth,iHeight,true); Core::ReleasePooledBitmap(stTemp); });
+		fPooled[1] = TimeBatch([&] { auto stTemp = Core::CreatePooledBitmap(iWidth,iHeight,true); Core::FillBitmap(stTemp,0); Core::ReleasePooledBitmap(stTemp); });
+
+		char sNote[64];
+		Report("CreateBitmap",stSize,fMalloc[0],"[malloc]");
+		snprintf(sNote,sizeof(sNote),"[pooled, %.2fx]",fMalloc[0]/fPooled[0]);
+		Report("CreateBitmap",stSize,fPooled[0],sNote);
+		Report("Create+Fill",stSize,fMalloc[1],"[malloc]");
+		snprintf(sNote,sizeof(sNote),"[pooled, %.2fx]",fMalloc[1]/fPooled[1]);
+		Report("Create+Fill",stSize,fPooled[1],sNote);
+		Core::CBitmapPool::Trim();
+
+		printf("\n");
+
+		Core::DeleteBitmap(stSource);
+		Core::DeleteBitmap(stMask);
+		Core::DeleteBitmap(stBackground);
+		Core::DeleteBitmap(stDest);
+	}
+
+	if (iMaxWidth >= 6000) ThumbnailBench();
+
+	auto stStats = Core::CBitmapPool::GetStats();
+	printf("Bitmap pool: %lld hits, %lld misses, %lld released, %lld freed, %lld bytes cached\n",stStats.iHits,stStats.iMisses,stStats.iReleased,stStats.iFreed,
+		   stStats.iCachedBytes);
+	return 0;
+}
@@ -0,0 +1,149 @@
+
+// --------------------------------------------------
+// SageBox -- Lazy Button Bitmap Benchmark (Portable)
+// --------------------------------------------------
+//
+// Compares the memory held by button state bitmaps when every state is decoded up front (as a style load does now) against
+// Core::CLazyBitmaps (see include/Core/CLazyBitmaps.h), which decodes each state the first time it is drawn.
+//
+// Build:
+//
+//		g++ -O2 -std=c++17 -pthread -I../../include main.cpp -o LazyBitmapBench
+//		cl /O2 /std:c++17 /I..\..\include main.cpp
+//
+// Usage: LazyBitmapBench [State.jpg]		-- State.jpg is decoded for every state (default: states are rendered, 160x40)
+//
+// The UI has 500 buttons with six states each (normal, high, pressed, checked-high, disabled, disabled-checked).
+// A session is simulated: every button is drawn normal, 60 are hovered, 15 pressed, 20 checked and hovered, and 30 are
+// disabled -- no button is ever disabled and checked.  The session is run with no budget and with budgets below the
+// lazy working set, showing the memory held and the decodes (including re-decodes after eviction) for each.
+//
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include "Core/CLazyBitmaps.h"
+
+using namespace Sage;
+
+static constexpr int kButtons	= 500;
+static constexpr int kStates	= 6;
+static constexpr int kWidth		= 160;
+static constexpr int kHeight	= 40;
+
+enum State { Normal, High, Pressed, CheckedHigh, Disabled, DisabledChecked };
+
+// RenderState() -- Stand-in decoder when no JPEG is given: a shaded button face, with the shade from the state
+
+struct StateSource_t { int iButton; int iState; };
+
+static bool RenderState(Core::Bitmap_t & stBitmap,const void * pSource,size_t)
+{
+	const StateSource_t & stSource = *(const StateSource_t *) pSource;
+	stBitmap = Core::CreateBitmap(kWidth,kHeight);
+	if (!stBitmap.isValid()) return false;
+	for (int y=0;y<kHeight;y++)
+	{
+		unsigned char * sRow = stBitmap.Row(y);
+		int iShade = 80 + y*3 + stSource.iState*20;
+		for (int x=0;x<kWidth;x++) sRow[x*3] = sRow[x*3+1] = sRow[x*3+2] = (unsigned char) ((iShade + x/4 + stSource.iButton) & 255);
+	}
+	return true;
+}
+
+// Session() -- The states drawn in a session, in order (each drawn twice, as on hover-in and a repaint)
+
+static std::vector<int> Session()
+{
+	std::vector<int> vDraws;
+	auto fDraw = [&](int iButton,int iState) { vDraws.push_back(iButton*kStates + iState); vDraws.push_back(iButton*kStates + iState); };
+
+	for (int i=0;i<kButtons;i++) fDraw(i,Normal);
+	for (int i=0;i<60;i++)	{ fDraw(i*7 % kButtons,High); fDraw(i*7 % kButtons,Normal); }
+	for (int i=0;i<15;i++)	{ fDraw(i*31 % kButtons,High); fDraw(i*31 % kButtons,Pressed); fDraw(i*31 % kButtons,High); }
+	for (int i=0;i<20;i++)	fDraw(i*13 % kButtons,CheckedHigh);
+	for (int i=0;i<30;i++)	fDraw(kButtons - 1 - i,Disabled);
+	for (int i=0;i<kButtons;i++) fDraw(i,Normal);				// A full repaint at the end
+	return vDraws;
+}
+
+static bool ReadFile(const char * sPath,std::vector<unsigned char> & vData)
+{
+	FILE * fp = fopen(sPath,"rb");
+	if (!fp) return false;
+	fseek(fp,0,SEEK_END);
+	long iSize = ftell(fp);
+	fseek(fp,0,SEEK_SET);
+	vData.resize(iSize > 0 ? (size_t) iSize : 0);
+	bool bRead = iSize > 0 && fread(vData.data(),1,vData.size(),fp) == vData.size();
+	fclose(fp);
+	return bRead;
+}
+
+int main(int argc,char * argv[])
+{
+	std::vector<unsigned char> vJpeg;
+	if (argc > 1 && !ReadFile(argv[1],vJpeg))
+	{
+		printf("Could not read %s\nUsage: LazyBitmapBench [State.jpg]\n",argv[1]);
+		return 1;
+	}
+
+	std::vector<StateSource_t> vSources;
+	for (int i=0;i<kButtons;i++) for (int j=0;j<kStates;j++) vSources.push_back({ i, j });
+
+	auto fAddAll = [&](Core::CLazyBitmaps & cBitmaps)
+	{
+		for (auto & stSource : vSources)
+			if (vJpeg.empty()) cBitmaps.Add(RenderState,&stSource);
+			else cBitmaps.AddJpeg(vJpeg.data(),vJpeg.size());
+	};
+
+	std::vector<int> vDraws = Session();
+	using Clock = std::chrono::high_resolution_clock;
+
+	// Eager: every state decoded when the style loads
+
+	size_t iEagerBytes;
+	double fEager;
+	{
+		Core::CLazyBitmaps cBitmaps;
+		fAddAll(cBitmaps);
+		auto tStart = Clock::now();
+		for (int i=0;i<cBitmaps.GetCount();i++)
+			if (!cBitmaps.Get(i)) { printf("State %d could not be decoded\n",i); return 1; }
+		for (int iDraw : vDraws) cBitmaps.Get(iDraw);
+		fEager = std::chrono::duration<double,std::milli>(Clock::now() - tStart).count();
+		iEagerBytes = cBitmaps.GetStats().iResidentBytes;
+	}
+
+	printf("%d buttons x %d states, %d draws in the session (%s)\n\n",kButtons,kStates,(int) vDraws.size(),vJpeg.empty() ? "rendered states" : argv[1]);
+	printf("%-22s %12s %12s %10s %10s %10s %9s\n","","Resident","Peak","Decodes","Evictions","Time","Saved");
+	printf("%-22s %9.1f MB %9.1f MB %10d %10d %7.1f ms %9s\n","Eager (all states)",iEagerBytes/1e6,iEagerBytes/1e6,kButtons*kStates,0,fEager,"--");
+
+	// Lazy, with no budget and with budgets at fractions of the lazy working set
+
+	size_t iWorkingSet = 0;
+	for (int iPass=0;iPass<4;iPass++)
+	{
+		static const double fBudgets[] = { 0, 1.0, 0.5, 0.25 };
+		Core::CLazyBitmaps cBitmaps;
+		fAddAll(cBitmaps);
+		if (iPass) cBitmaps.SetBudget((size_t) (iWorkingSet*fBudgets[iPass]));
+
+		auto tStart = Clock::now();
+		for (int iDraw : vDraws) if (!cBitmaps.Get(iDraw)) { printf("State %d could not be decoded\n",iDraw); return 1; }
+		double fTime = std::chrono::duration<double,std::milli>(Clock::now() - tStart).count();
+
+		const Core::LazyBitmapStats_t & stStats = cBitmaps.GetStats();
+		if (!iPass) iWorkingSet = stStats.iPeakBytes;
+
+		char sName[40];
+		if (!iPass) snprintf(sName,sizeof(sName),"Lazy (no budget)");
+		else snprintf(sName,sizeof(sName),"Lazy (%.1f MB budget)",cBitmaps.GetBudget()/1e6);
+		printf("%-22s %9.1f MB %9.1f MB %10lld %10lld %7.1f ms %8.0f%%\n",sName,stStats.iResidentBytes/1e6,stStats.iPeakBytes/1e6,
+				stStats.iDecodes,stStats.iEvictions,fTime,100.0*(1.0 - (double) stStats.iPeakBytes/iEagerBytes));
+	}
+	return 0;
+}
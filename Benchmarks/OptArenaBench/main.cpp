@@ -0,0 +1,146 @@
+
+// --------------------------------------------------------
+// SageBox -- Options Arena Contention Benchmark (Portable)
+// --------------------------------------------------------
+//
+// Times N threads building opt:: chains (i.e. fgColor("red") | Style("Panel") | Transparent() | Font("Arial,20")) at the same
+// time, with the temporary option objects taken from:
+//
+//		Global		-- one recycled array of 5000 objects for all threads, behind a process-wide spin lock, as cwfOpt::Temp() does
+//		Arena		-- Core::CThreadArena (see include/Core/CThreadArena.h), as cwfOpt::ThreadTemp() does: a bump allocator per
+//					   thread, released by a Scope after each chain, with no lock
+//
+// The option objects here are a stand-in for cwfOpt (the same 100-byte inline buffer).
+//
+// Build:
+//
+//		g++ -O2 -std=c++17 -pthread -I../../include main.cpp -o OptArenaBench
+//		cl /O2 /std:c++17 /I..\..\include main.cpp
+//
+// Usage: OptArenaBench [MaxThreads]		-- Runs with 1, 2, 4 ... MaxThreads threads (default: 2x the hardware threads, at least 4)
+//
+// Besides the lock, the global array is shared: once it wraps, one thread can be handed an object another thread is still
+// building.  Chains that come out wrong because of this are counted (Overlaps).  The arena never hands one thread's objects
+// to another, so it should always show 0.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "Core/CThreadArena.h"
+
+using namespace Sage;
+
+static constexpr int kChains = 200000;		// Chains built by each thread
+
+// TempOpt_t -- Stand-in for cwfOpt: options are appended to a 100-byte buffer
+
+struct TempOpt_t
+{
+	char sOpt[100];
+	int iLength;
+
+	void Clear() { sOpt[0] = 0; iLength = 0; }
+	TempOpt_t & Add(const char * sOption)
+	{
+		int iAdd = (int) strlen(sOption);
+		if (iLength + iAdd + 2 > (int) sizeof(sOpt)) return *this;
+		if (iLength) sOpt[iLength++] = ',';
+		memcpy(sOpt + iLength,sOption,iAdd + 1);
+		iLength += iAdd;
+		return *this;
+	}
+	TempOpt_t & operator | (TempOpt_t & stOpt) { return Add(stOpt.sOpt); }
+};
+
+// The global recycled array, as cwfOpt::Temp()
+
+static constexpr int kMaxArray = 5000;
+static TempOpt_t stOptArray[kMaxArray];
+static int iArrayIndex = 0;
+static std::atomic_flag bProcessLock = ATOMIC_FLAG_INIT;
+
+static TempOpt_t * GlobalTemp()
+{
+	while (bProcessLock.test_and_set(std::memory_order_acquire)) std::this_thread::yield();
+	TempOpt_t * stOpt = &stOptArray[iArrayIndex];
+	if (++iArrayIndex >= kMaxArray) iArrayIndex = 0;
+	bProcessLock.clear(std::memory_order_release);
+	stOpt->Clear();
+	return stOpt;
+}
+
+// The per-thread arena, as cwfOpt::ThreadTemp()
+
+static TempOpt_t * ArenaTemp()
+{
+	TempOpt_t * stOpt = Core::CThreadArena<TempOpt_t>::Next();
+	stOpt->Clear();
+	return stOpt;
+}
+
+static const char * sExpected = "fgColor=\"red\",Style=\"Panel\",Transparent,Font=\"Arial,20\"";
+
+// BuildChains() -- fgColor("red") | Style("Panel") | Transparent() | Font("Arial,20"), kChains times.
+// Returns the number of chains that didn't come out as sExpected.
+
+template <class _t>
+static int BuildChains(_t fTemp,bool bScope)
+{
+	int iOverlaps = 0;
+	for (int i=0;i<kChains;i++)
+	{
+		int iMark = bScope ? Core::CThreadArena<TempOpt_t>::GetMark() : 0;
+		TempOpt_t & stOpt = fTemp()->Add("fgColor=\"red\"") | fTemp()->Add("Style=\"Panel\"") | fTemp()->Add("Transparent") | fTemp()->Add("Font=\"Arial,20\"");
+		if (strcmp(stOpt.sOpt,sExpected)) iOverlaps++;
+		if (bScope) Core::CThreadArena<TempOpt_t>::Release(iMark);
+	}
+	return iOverlaps;
+}
+
+struct Result_t { double fRate; int iOverlaps; };
+
+// RunThreads() -- Chains per second with iThreads threads, and the overlaps
+
+template <class _t>
+static Result_t RunThreads(int iThreads,_t fTemp,bool bScope)
+{
+	using Clock = std::chrono::high_resolution_clock;
+	std::atomic<int> iOverlaps { 0 };
+	std::vector<std::thread> vThreads;
+
+	auto tStart = Clock::now();
+	for (int i=0;i<iThreads;i++) vThreads.emplace_back([&] { iOverlaps += BuildChains(fTemp,bScope); });
+	for (auto & cThread : vThreads) cThread.join();
+	double fTime = std::chrono::duration<double>(Clock::now() - tStart).count();
+
+	return { (double) iThreads*kChains/fTime, iOverlaps };
+}
+
+int main(int argc,char * argv[])
+{
+	int iHardware	= (int) std::thread::hardware_concurrency();
+	int iMaxThreads	= argc > 1 ? atoi(argv[1]) : (iHardware*2 > 4 ? iHardware*2 : 4);
+	if (iMaxThreads < 1)
+	{
+		printf("Usage: OptArenaBench [MaxThreads]\n");
+		return 1;
+	}
+
+	printf("%d hardware threads, %d chains of 4 options per thread\n\n",iHardware,kChains);
+	printf("%-8s %14s %10s %14s %10s %10s\n","Threads","Global (M/s)","Overlaps","Arena (M/s)","Overlaps","Speed-up");
+	for (int iThreads=1;;iThreads *= 2)
+	{
+		if (iThreads > iMaxThreads) iThreads = iMaxThreads;
+		Result_t stGlobal	= RunThreads(iThreads,GlobalTemp,false);
+		Result_t stArena	= RunThreads(iThreads,ArenaTemp,true);
+		printf("%-8d %14.2f %10d %14.2f %10d %9.1fx\n",iThreads,stGlobal.fRate/1e6,stGlobal.iOverlaps,stArena.fRate/1e6,stArena.iOverlaps,
+				stArena.fRate/stGlobal.fRate);
+		if (iThreads == iMaxThreads) break;
+	}
+	return 0;
+}
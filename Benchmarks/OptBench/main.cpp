@@ -0,0 +1,231 @@
+
+// -----------------------------------------------
+// SageBox -- Control Options Benchmark (Portable)
+// -----------------------------------------------
+//
+// Times reading the options when controls are created, two ways:
+//
+//		Scan		-- each option the control looks for is a search of the whole options string, returning a copy of the
+//					   value, as opt.GetOptInt(), GetOptString(), etc. do now
+//		Parsed		-- the string is split once with Core::COptParse (see include/Core/COptParse.h), and each option is then
+//					   an array lookup by OptKey
+//		Constant	-- for a constant chain only: the chain is built with copt:: (see include/Core/COptConst.h), so the string
+//					   and OptKey table are built at compile time and nothing is parsed at run time
+//
+// Build:
+//
+//		g++ -O2 -std=c++17 -I../../include main.cpp -o OptBench
+//		cl /O2 /std:c++17 /I..\..\include main.cpp
+//
+// Usage: OptBench [Controls]		-- Number of controls created (default 2000)
+//
+// Each control has an options string as opt:: builds them (i.e. Style("Panel") | fgColor(...) | Transparent() | ...) and
+// reads 12 options from it, as a button or slider does when it is created -- most of which aren't in the string.
+// The results are checked against each other.  The constant chain is timed separately, with every control using the same chain.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "Core/COptConst.h"
+#include "../BenchTimer.h"
+
+using namespace Sage;
+
+// ScanOpt() -- Find sName in the string and copy its value, as the opt.GetOpt*() functions do.
+// Returns false if it isn't there.  sValue is empty for a flag.
+
+static bool ScanOpt(const char * sOpt,const char * sName,std::string & sValue)
+{
+	size_t iName = strlen(sName);
+	for (const char * s = sOpt;*s;)
+	{
+		while (*s == ',' || *s == ' ') s++;
+		const char * sStart = s;
+		while (*s && *s != '=' && *s != ',') s++;
+		const char * sEnd = s;
+		while (sEnd > sStart && sEnd[-1] == ' ') sEnd--;
+		bool bMatch = (size_t) (sEnd - sStart) == iName && !Core::OptNameCompare(sStart,iName,sName);
+
+		sValue.clear();
+		if (*s == '=')
+		{
+			s++;
+			while (*s == ' ') s++;
+			if (*s == '"' || *s == '\'')
+			{
+				char cQuote = *s++;
+				while (*s && *s != cQuote) sValue += *s++;
+				if (*s) s++;
+				while (*s && *s != ',') s++;
+			}
+			else
+			{
+				while (*s && *s != ',') sValue += *s++;
+				while (!sValue.empty() && sValue.back() == ' ') sValue.pop_back();
+			}
+		}
+		if (bMatch) return true;
+	}
+	return false;
+}
+
+// The options a control reads when it is created
+
+struct ControlOpt_t
+{
+	std::string sStyle;
+	std::string sLabel;
+	std::string sGroup;
+	Core::Color_t rgbFg;
+	Core::Color_t rgbBg;
+	int iWidth;
+	int iMin;
+	int iMax;
+	bool bTransparent;
+	bool bDisabled;
+	bool bHidden;
+	bool bShowValue;
+
+	bool operator == (const ControlOpt_t & stOpt) const
+	{
+		return sStyle == stOpt.sStyle && sLabel == stOpt.sLabel && sGroup == stOpt.sGroup && rgbFg == stOpt.rgbFg && rgbBg == stOpt.rgbBg &&
+			   iWidth == stOpt.iWidth && iMin == stOpt.iMin && iMax == stOpt.iMax && bTransparent == stOpt.bTransparent &&
+			   bDisabled == stOpt.bDisabled && bHidden == stOpt.bHidden && bShowValue == stOpt.bShowValue;
+	}
+};
+
+static Core::Color_t toColor(const std::string & sValue)
+{
+	if (sValue.size() > 2 && sValue[0] == '\\') return (Core::Color_t) strtoul(sValue.c_str() + 2,nullptr,16);
+	return (Core::Color_t) strtoul(sValue.c_str(),nullptr,0);
+}
+
+static ControlOpt_t ReadScan(const char * sOpt)
+{
+	ControlOpt_t stOpt = { "Default", "", "", 0xFFFFFF, 0, 100, 0, 100, false, false, false, false };
+	std::string sValue;
+	if (ScanOpt(sOpt,"Style",sValue))		stOpt.sStyle	= sValue;
+	if (ScanOpt(sOpt,"Label",sValue))		stOpt.sLabel	= sValue;
+	if (ScanOpt(sOpt,"Group",sValue))		stOpt.sGroup	= sValue;
+	if (ScanOpt(sOpt,"fgColor",sValue))		stOpt.rgbFg		= toColor(sValue);
+	if (ScanOpt(sOpt,"bgColor",sValue))		stOpt.rgbBg		= toColor(sValue);
+	if (ScanOpt(sOpt,"Width",sValue))		stOpt.iWidth	= atoi(sValue.c_str());
+	if (ScanOpt(sOpt,"MinValue",sValue))	stOpt.iMin		= atoi(sValue.c_str());
+	if (ScanOpt(sOpt,"MaxValue",sValue))	stOpt.iMax		= atoi(sValue.c_str());
+	stOpt.bTransparent	= ScanOpt(sOpt,"Transparent",sValue);
+	stOpt.bDisabled		= ScanOpt(sOpt,"Disabled",sValue);
+	stOpt.bHidden		= ScanOpt(sOpt,"Hidden",sValue);
+	stOpt.bShowValue	= ScanOpt(sOpt,"ShowValue",sValue);
+	return stOpt;
+}
+
+static ControlOpt_t ReadParsed(const char * sOpt)
+{
+	using Core::OptKey;
+	Core::COptParse cOpt(sOpt);
+	ControlOpt_t stOpt = { cOpt.GetString(OptKey::Style,"Default"), cOpt.GetString(OptKey::Label,""), cOpt.GetString(OptKey::Group,""), 0xFFFFFF, 0,
+						   cOpt.GetInt(OptKey::Width,100), cOpt.GetInt(OptKey::MinValue,0), cOpt.GetInt(OptKey::MaxValue,100),
+						   cOpt.GetBool(OptKey::Transparent), cOpt.GetBool(OptKey::Disabled), cOpt.GetBool(OptKey::Hidden), cOpt.GetBool(OptKey::ShowValue) };
+	cOpt.GetColor(OptKey::fgColor,stOpt.rgbFg);
+	cOpt.GetColor(OptKey::bgColor,stOpt.rgbBg);
+	return stOpt;
+}
+
+static ControlOpt_t ReadConst(const Core::COptConst & cOpt)
+{
+	using Core::OptKey;
+	auto fString = [&](OptKey eKey,const char * sDefault)
+	{
+		const char * sValue = nullptr;
+		int iLength = cOpt.GetValue(eKey,sValue);
+		return iLength < 0 ? std::string(sDefault) : std::string(sValue ? sValue : "",iLength);
+	};
+	ControlOpt_t stOpt = { fString(OptKey::Style,"Default"), fString(OptKey::Label,""), fString(OptKey::Group,""), 0xFFFFFF, 0,
+						   cOpt.GetInt(OptKey::Width,100), cOpt.GetInt(OptKey::MinValue,0), cOpt.GetInt(OptKey::MaxValue,100),
+						   cOpt.isSet(OptKey::Transparent), cOpt.isSet(OptKey::Disabled), cOpt.isSet(OptKey::Hidden), cOpt.isSet(OptKey::ShowValue) };
+	cOpt.GetColor(OptKey::fgColor,stOpt.rgbFg);
+	cOpt.GetColor(OptKey::bgColor,stOpt.rgbBg);
+	return stOpt;
+}
+
+// MakeOpt() -- An options string for control i, as opt:: would build it
+
+static std::string MakeOpt(int i)
+{
+	static const char * sStyles[] = { "Panel", "Glass", "Default", "Dark" };
+	char sColor[32];
+	std::string sOpt = std::string("Style=\"") + sStyles[i % 4] + "\"";
+	if (i % 2) sOpt += ",Label=\"Control " + std::to_string(i) + "\"";
+	snprintf(sColor,sizeof(sColor),",fgColor=\\x%06X",(i*2654435761u) & 0xFFFFFF);
+	sOpt += sColor;
+	if (i % 3 == 0) sOpt += ",Transparent";
+	if (i % 5 == 0) sOpt += ",Group=\"Group" + std::to_string(i/5 % 8) + "\"";
+	if (i % 4 == 1) sOpt += ",MinValue=" + std::to_string(-i % 50) + ",MaxValue=" + std::to_string(100 + i % 900) + ",ShowValue";
+	if (i % 7 == 0) sOpt += ",Width=" + std::to_string(80 + i % 200);
+	if (i % 11 == 0) sOpt += ",Tooltip=\"Options for control " + std::to_string(i) + "\"";		// Not an OptKey
+	return sOpt;
+}
+
+int main(int argc,char * argv[])
+{
+	int iControls = argc > 1 ? atoi(argv[1]) : 2000;
+	if (iControls < 1)
+	{
+		printf("Usage: OptBench [Controls]\n");
+		return 1;
+	}
+
+	// Aliases are read as the option they stand for (TextColor and fg are fgColor, bg is bgColor)
+
+	{
+		using Core::OptKey;
+		Core::COptParse cAlias("bg=\\x102030,TextColor=\\x405060,fgColor=\\x708090");
+		Core::COptParse cShort("fg=\\x112233,bgColor=\\x445566");
+		Core::Color_t rgbBg = 0, rgbFg = 0, rgbShortFg = 0, rgbShortBg = 0;
+		if (!cAlias.GetColor(OptKey::bgColor,rgbBg) || rgbBg != 0x102030 || !cAlias.GetColor(OptKey::fgColor,rgbFg) || rgbFg != 0x405060 ||
+			!cShort.GetColor(OptKey::fgColor,rgbShortFg) || rgbShortFg != 0x112233 || !cShort.GetColor("bg",rgbShortBg) || rgbShortBg != 0x445566 ||
+			!Core::copt::TextColor(0x405060u).isSet(OptKey::fgColor))
+		{
+			printf("Option aliases weren't read as the options they stand for\n");
+			return 1;
+		}
+	}
+
+	std::vector<std::string> vOpts;
+	size_t iBytes = 0;
+	for (int i=0;i<iControls;i++) { vOpts.push_back(MakeOpt(i)); iBytes += vOpts.back().size(); }
+
+	for (auto & sOpt : vOpts)
+		if (!(ReadScan(sOpt.c_str()) == ReadParsed(sOpt.c_str()))) { printf("Mismatch: %s\n",sOpt.c_str()); return 1; }
+
+	volatile int iSum = 0;			// Keeps the reads from being optimized away
+	double fScan	= TimeBatch([&] { for (auto & sOpt : vOpts) iSum = iSum + ReadScan(sOpt.c_str()).iWidth; });
+	double fParsed	= TimeBatch([&] { for (auto & sOpt : vOpts) iSum = iSum + ReadParsed(sOpt.c_str()).iWidth; });
+
+	printf("%d controls, %.0f bytes of options each on average, 12 options read per control\n\n",iControls,(double) iBytes/iControls);
+	printf("%-10s %12s %16s\n","","Total","Per control");
+	printf("%-10s %9.3f ms %13.0f ns\n","Scan",fScan,fScan*1e6/iControls);
+	printf("%-10s %9.3f ms %13.0f ns\n","Parsed",fParsed,fParsed*1e6/iControls);
+	printf("\n%.1fx faster\n",fScan/fParsed);
+
+	// A constant chain, the same for every control
+
+	static constexpr auto kConst = Core::copt::Style("Panel") | Core::copt::Label("OK") | Core::copt::fgColor(0x2040FFu) | Core::copt::Transparent() |
+								   Core::copt::MinValue(0) | Core::copt::MaxValue(500) | Core::copt::ShowValue();
+	if (!(ReadScan(kConst.s()) == ReadConst(kConst)) || !(ReadParsed(kConst.s()) == ReadConst(kConst))) { printf("Mismatch: %s\n",kConst.s()); return 1; }
+
+	double fConstScan	= TimeBatch([&] { for (int i=0;i<iControls;i++) iSum = iSum + ReadScan(kConst.s()).iMax; });
+	double fConstParsed	= TimeBatch([&] { for (int i=0;i<iControls;i++) iSum = iSum + ReadParsed(kConst.s()).iMax; });
+	double fConst		= TimeBatch([&] { for (int i=0;i<iControls;i++) iSum = iSum + ReadConst(kConst).iMax; });
+
+	printf("\nConstant chain: %s\n\n",kConst.s());
+	printf("%-10s %12s %16s\n","","Total","Per control");
+	printf("%-10s %9.3f ms %13.0f ns\n","Scan",fConstScan,fConstScan*1e6/iControls);
+	printf("%-10s %9.3f ms %13.0f ns\n","Parsed",fConstParsed,fConstParsed*1e6/iControls);
+	printf("%-10s %9.3f ms %13.0f ns\n","Constant",fConst,fConst*1e6/iControls);
+	printf("\n%.1fx faster than Scan\n",fConstScan/fConst);
+	return 0;
+}
@@ -0,0 +1,160 @@
+
+// ----------------------------------------------
+// SageBox -- PGR Read Benchmark (Windows only)
+// ----------------------------------------------
+//
+// Compares opening a PGR and getting at the files inside it two ways:
+//
+//		ReadPGR() + ReadFile()				-- the PGR is read in through fopen()/fread(), and each file is allocated and copied
+//		ReadMappedPGR() + GetFileView()		-- the PGR is memory-mapped, and each file is a pointer into the mapping
+//
+// This links with the SageBox library, as the PGR reader lives there:
+//
+//		cl /O2 /std:c++17 /I..\..\include main.cpp ..\..\lib\SageBox64.lib Msimg32.lib Psapi.lib
+//
+// Usage: PgrBench File.pgr [File1 File2 ...]		-- File1, etc. are files inside the PGR to read each time
+//
+// Each way is timed over 20 runs of open + read every file + close, and the best time is reported.  Every byte of each file is
+// touched (summed) in both cases, so the mapped pages are really loaded.
+//
+// Memory is reported as the growth in private bytes and working set for one open PGR with all files read (and, for ReadFile(),
+// still allocated), as would be the case for a loaded style pack.  Mapped pages are shared with the file cache, so they show
+// in the working set but not in private bytes.
+//
+
+#include <Windows.h>
+#include <Psapi.h>
+#include <stdio.h>
+#include <chrono>
+#include <vector>
+#include "CPgr.h"
+
+using namespace Sage;
+
+static constexpr int kRuns = 20;
+
+struct Memory_t
+{
+	long long iPrivate;
+	long long iWorkingSet;
+};
+
+static Memory_t GetMemory()
+{
+	PROCESS_MEMORY_COUNTERS_EX stCounters = {};
+	GetProcessMemoryInfo(GetCurrentProcess(),(PROCESS_MEMORY_COUNTERS *) &stCounters,sizeof(stCounters));
+	return { (long long) stCounters.PrivateUsage, (long long) stCounters.WorkingSetSize };
+}
+
+// SumBytes() -- Touch every byte, so both ways really read the data
+
+static unsigned int SumBytes(const unsigned char * sData,int iSize)
+{
+	unsigned int uiSum = 0;
+	for (int i=0;i<iSize;i++) uiSum += sData[i];
+	return uiSum;
+}
+
+// ReadCopied() -- Open with ReadPGR() and read each file with ReadFile().  The files are kept in vFiles until the caller frees them.
+
+static bool ReadCopied(CSagePGR & cPGR,char * sPGR,std::vector<char *> & vNames,std::vector<unsigned char *> & vFiles,unsigned int & uiSum)
+{
+	if (cPGR.ReadPGR(sPGR) != ePGR_OK) return false;
+	for (auto sName : vNames)
+	{
+		int iSize = 0;
+		unsigned char * sFile = cPGR.ReadFile(sName,iSize);
+		if (!sFile) return false;
+		uiSum += SumBytes(sFile,iSize);
+		vFiles.push_back(sFile);
+	}
+	return true;
+}
+
+// ReadMapped() -- Open with ReadMappedPGR() and view each file with GetFileView()
+
+static bool ReadMapped(CSagePGR & cPGR,char * sPGR,std::vector<char *> & vNames,unsigned int & uiSum)
+{
+	if (cPGR.ReadMappedPGR(sPGR) != ePGR_OK) return false;
+	for (auto sName : vNames)
+	{
+		PGRView_t stView;
+		if (!cPGR.GetFileView(sName,stView)) return false;
+		uiSum += SumBytes(stView.sData,stView.iSize);
+	}
+	return true;
+}
+
+static void FreeFiles(std::vector<unsigned char *> & vFiles)
+{
+	for (auto & sFile : vFiles) CSagePGR::FreeFileMem(sFile);
+	vFiles.clear();
+}
+
+int main(int argc,char * argv[])
+{
+	if (argc < 2)
+	{
+		printf("Usage: PgrBench File.pgr [File1 File2 ...]\n");
+		return 1;
+	}
+	char * sPGR = argv[1];
+	std::vector<char *> vNames(argv + 2,argv + argc);
+
+	using Clock = std::chrono::high_resolution_clock;
+	double fBest[2] = { 1e30, 1e30 };
+	unsigned int uiSum[2] = {};
+
+	for (int iRun=0;iRun<kRuns;iRun++)
+	{
+		for (int iWay=0;iWay<2;iWay++)
+		{
+			std::vector<unsigned char *> vFiles;
+			unsigned int uiRunSum = 0;
+			auto tStart = Clock::now();
+			{
+				CSagePGR cPGR;
+				bool bResult = iWay ? ReadMapped(cPGR,sPGR,vNames,uiRunSum) : ReadCopied(cPGR,sPGR,vNames,vFiles,uiRunSum);
+				FreeFiles(vFiles);
+				if (!bResult)
+				{
+					printf("Could not read %s with %s\n",sPGR,iWay ? "ReadMappedPGR()" : "ReadPGR()");
+					return 1;
+				}
+			}
+			double fTime = std::chrono::duration<double,std::milli>(Clock::now() - tStart).count();
+			if (fTime < fBest[iWay]) fBest[iWay] = fTime;
+			uiSum[iWay] = uiRunSum;
+		}
+	}
+	if (uiSum[0] != uiSum[1])
+	{
+		printf("File contents differ between ReadFile() and GetFileView()\n");
+		return 1;
+	}
+
+	// Memory with the PGR open and every file read
+
+	Memory_t stMemory[2];
+	for (int iWay=0;iWay<2;iWay++)
+	{
+		std::vector<unsigned char *> vFiles;
+		unsigned int uiRunSum = 0;
+		Memory_t stBefore = GetMemory();
+		CSagePGR cPGR;
+		if (iWay) ReadMapped(cPGR,sPGR,vNames,uiRunSum);
+		else ReadCopied(cPGR,sPGR,vNames,vFiles,uiRunSum);
+		Memory_t stAfter = GetMemory();
+		stMemory[iWay] = { stAfter.iPrivate - stBefore.iPrivate, stAfter.iWorkingSet - stBefore.iWorkingSet };
+		FreeFiles(vFiles);
+	}
+
+	printf("%s, %d files read each run\n\n",sPGR,(int) vNames.size());
+	printf("%-34s %12s %16s %16s\n","","Best time","Private bytes","Working set");
+	const char * sWays[2] = { "ReadPGR() + ReadFile()", "ReadMappedPGR() + GetFileView()" };
+	for (int iWay=0;iWay<2;iWay++)
+		printf("%-34s %9.2f ms %13.1f MB %13.1f MB\n",sWays[iWay],fBest[iWay],stMemory[iWay].iPrivate/1e6,stMemory[iWay].iWorkingSet/1e6);
+
+	printf("\nSpeed-up: %.2fx\n",fBest[0]/fBest[1]);
+	return 0;
+}
@@ -0,0 +1,161 @@
+
+// -----------------------------------------------
+// SageBox -- PGR Key Lookup Benchmark (Portable)
+// -----------------------------------------------
+//
+// Compares finding keys in a PGR key table with a linear search (as CReadPGR::FindKey() and FindPartialKey() do) against
+// Core::CStringIndex, which CPGRKeyIndex (see include/CPgr.h) builds over the key table when a PGR is opened.
+//
+// Build:
+//
+//		g++ -O2 -std=c++17 -I../../include main.cpp -o PgrKeyBench
+//		cl /O2 /std:c++17 /I..\..\include main.cpp
+//
+// Usage: PgrKeyBench [Keys]		-- Keys is the number of keys in the table (default 10000)
+//
+// The key table and string table are laid out as in a loaded PGR (stPGRKeyTable_t entries pointing into one string table),
+// with style-like key names, i.e. "Button.Style12.Hover.TextColor".  Timed are:
+//
+//		Build		-- building the index, once per PGR load
+//		Exact		-- looking up every key once, as when a style is loaded
+//		Missing		-- looking up keys that aren't there (the worst case for the linear search)
+//		Partial		-- prefix lookups, as FindPartialKey()
+//
+// The index results are checked against the linear search for every lookup.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "Core/CStringIndex.h"
+#include "../BenchTimer.h"
+
+using namespace Sage;
+
+// The same layout as stPGRKeyTable_t in CPgr.h
+
+struct KeyTable_t
+{
+	unsigned int ulKeynamePointer;
+	unsigned int ulKeyValuePointer;
+};
+
+struct Table_t
+{
+	std::vector<KeyTable_t> vKeys;
+	std::vector<char> vStrings;
+
+	const char * GetName(int i) const { return vStrings.data() + vKeys[i].ulKeynamePointer; }
+};
+
+static unsigned int AddString(std::vector<char> & vStrings,const std::string & sString)
+{
+	unsigned int uiPointer = (unsigned int) vStrings.size();
+	vStrings.insert(vStrings.end(),sString.c_str(),sString.c_str() + sString.size() + 1);
+	return uiPointer;
+}
+
+// MakeTable() -- iKeys style-like keys, in the order a style file would list them
+
+static Table_t MakeTable(int iKeys)
+{
+	static const char * sControls[]	= { "Button", "Checkbox", "Radio", "Slider", "Window", "EditBox", "ListBox", "Combo" };
+	static const char * sStates[]	= { "Normal", "Hover", "Pressed", "Disabled", "Checked" };
+	static const char * sProps[]	= { "TextColor", "BgColor", "Font", "Bitmap", "Size", "Offset", "Border", "Radius" };
+
+	Table_t stTable;
+	for (int i=0;i<iKeys;i++)
+	{
+		int iProp	= i % 8;
+		int iState	= (i/8) % 5;
+		int iStyle	= i/40;
+		std::string sName = std::string(sControls[iStyle % 8]) + ".Style" + std::to_string(iStyle) + "." + sStates[iState] + "." + sProps[iProp];
+		unsigned int uiName	 = AddString(stTable.vStrings,sName);
+		unsigned int uiValue = AddString(stTable.vStrings,std::to_string(i*7 % 1000));
+		stTable.vKeys.push_back({ uiName, uiValue });
+	}
+	return stTable;
+}
+
+// FindLinear() / FindPartialLinear() -- The linear searches, as CReadPGR does them
+
+static int FindLinear(const Table_t & stTable,const char * sKey)
+{
+	for (int i=0;i<(int) stTable.vKeys.size();i++) if (!strcmp(stTable.GetName(i),sKey)) return i;
+	return -1;
+}
+
+static int FindPartialLinear(const Table_t & stTable,const char * sKey)
+{
+	size_t iLength = strlen(sKey);
+	for (int i=0;i<(int) stTable.vKeys.size();i++) if (!strncmp(stTable.GetName(i),sKey,iLength)) return i;
+	return -1;
+}
+
+int main(int argc,char * argv[])
+{
+	int iKeys = argc > 1 ? atoi(argv[1]) : 10000;
+	if (iKeys < 1)
+	{
+		printf("Usage: PgrKeyBench [Keys]\n");
+		return 1;
+	}
+
+	Table_t stTable = MakeTable(iKeys);
+	Core::CStringIndex cIndex;
+	auto fGetName = [&](int i) { return stTable.GetName(i); };
+
+	// Lookups: every key, keys that aren't there, and prefixes (style, style + state, and a few that match nothing)
+
+	std::vector<std::string> vExact, vMissing, vPartial;
+	for (int i=0;i<iKeys;i++)
+	{
+		vExact.push_back(stTable.GetName(i));
+		vMissing.push_back(vExact.back() + "X");
+	}
+	for (int i=0;i<iKeys;i+=40)
+	{
+		std::string sName = stTable.GetName(i);
+		size_t iState = sName.find('.',sName.find('.') + 1);
+		vPartial.push_back(sName.substr(0,iState + 1));
+		vPartial.push_back(sName.substr(0,sName.find('.',iState + 1) + 1));
+		vPartial.push_back(sName.substr(0,iState) + "Z");
+	}
+
+	// Check the index against the linear search
+
+	cIndex.Build(iKeys,fGetName);
+	for (auto & sKey : vExact)		if (cIndex.Find(sKey.c_str()) != FindLinear(stTable,sKey.c_str()))					{ printf("Mismatch: %s\n",sKey.c_str()); return 1; }
+	for (auto & sKey : vMissing)	if (cIndex.Find(sKey.c_str()) != -1)												{ printf("Mismatch: %s\n",sKey.c_str()); return 1; }
+	for (auto & sKey : vPartial)	if (cIndex.FindPrefix(sKey.c_str()) != FindPartialLinear(stTable,sKey.c_str()))	{ printf("Mismatch: %s*\n",sKey.c_str()); return 1; }
+
+	volatile int iSum = 0;			// Keeps the lookups from being optimized away
+	auto fLookups = [&](const std::vector<std::string> & vKeys,auto fFind)
+	{
+		return TimeBatch([&] { for (auto & sKey : vKeys) iSum = iSum + fFind(sKey.c_str()); }) * 1e6/vKeys.size();
+	};
+
+	double fBuild = TimeBatch([&] { cIndex.Build(iKeys,fGetName); });
+
+	struct Result_t { const char * sName; int iCount; double fLinear; double fIndex; };
+	Result_t stResults[] =
+	{
+		{ "Exact",	 (int) vExact.size(),	fLookups(vExact,  [&](const char * s) { return FindLinear(stTable,s); }),			fLookups(vExact,  [&](const char * s) { return cIndex.Find(s); }) },
+		{ "Missing", (int) vMissing.size(),	fLookups(vMissing,[&](const char * s) { return FindLinear(stTable,s); }),			fLookups(vMissing,[&](const char * s) { return cIndex.Find(s); }) },
+		{ "Partial", (int) vPartial.size(),	fLookups(vPartial,[&](const char * s) { return FindPartialLinear(stTable,s); }),	fLookups(vPartial,[&](const char * s) { return cIndex.FindPrefix(s); }) },
+	};
+
+	printf("%d keys, %.1f KB string table -- index built in %.2f ms\n\n",iKeys,stTable.vStrings.size()/1024.0,fBuild);
+	printf("%-10s %10s %16s %16s %10s\n","Lookup","Count","Linear","Index","Speed-up");
+	for (auto & stResult : stResults)
+		printf("%-10s %10d %13.1f ns %13.1f ns %9.0fx\n",stResult.sName,stResult.iCount,stResult.fLinear,stResult.fIndex,stResult.fLinear/stResult.fIndex);
+
+	// A whole style load: every key looked up once, including the build
+
+	double fLinearLoad	= stResults[0].fLinear*iKeys/1e6;
+	double fIndexLoad	= stResults[0].fIndex*iKeys/1e6 + fBuild;
+	printf("\nAll %d keys once: %.2f ms linear, %.2f ms with the index (including the build) -- %.0fx\n",iKeys,fLinearLoad,fIndexLoad,fLinearLoad/fIndexLoad);
+	return 0;
+}
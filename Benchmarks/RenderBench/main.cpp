@@ -0,0 +1,215 @@
+
+// -----------------------------------------------
+// SageBox -- Software Render Benchmark (Portable)
+// -----------------------------------------------
+//
+// Times the drawing functions of Core::CSoftRender (see include/Core/CSoftRender.h), the software CRenderBackend that draws into
+// a 32-bit bitmap without a window, on a 1280x720 canvas.  Shapes are placed pseudo-randomly (the same each run), partly off the
+// canvas so clipping is included.  It reports draws per second for each function.
+//
+// The results are checked before timing: rectangle and polygon coverage, circle and triangle areas, the gradient ends,
+// blending, and lines far longer than the canvas (off it, and across it with coordinates near the int limits).
+//
+// Build:
+//
+//		g++ -O2 -std=c++17 -I../../include main.cpp -o RenderBench
+//		cl /O2 /std:c++17 /EHsc /I..\..\include main.cpp
+//
+// Usage: RenderBench [Scene.ppm]		-- Optionally, also write a scene drawn with every function to a .ppm file
+//
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include "Core/CSoftRender.h"
+#include "../BenchTimer.h"
+
+using namespace Sage;
+
+static constexpr int kWidth		= 1280;
+static constexpr int kHeight	= 720;
+
+static unsigned int uiRandom = 12345;
+static int Random(int iRange) { uiRandom = uiRandom*1664525u + 1013904223u; return (int) ((uiRandom >> 8) % (unsigned) iRange); }
+static int RandomColor() { return (int) Core::MakeRGB(Random(256),Random(256),Random(256)); }
+
+// CountColor() -- Pixels of a color
+
+static int CountColor(Core::CSoftRender & cRender,Core::Color_t rgbColor)
+{
+	int iCount = 0;
+	for (int y=0;y<kHeight;y++) for (int x=0;x<kWidth;x++) if (cRender.GetPixel(x,y) == rgbColor) iCount++;
+	return iCount;
+}
+
+static bool Check(const char * sName,bool bOk)
+{
+	if (!bOk) printf("Check failed: %s\n",sName);
+	return bOk;
+}
+
+// CheckResults() -- Coverage and color checks
+
+static bool CheckResults(Core::CSoftRender & cRender)
+{
+	const Core::Color_t rgbWhite = Core::MakeRGB(255,255,255);
+	bool bOk = true;
+
+	cRender.Cls(0);
+	cRender.DrawRectangle(5,5,10,10,(int) rgbWhite);
+	bOk &= Check("Rectangle",CountColor(cRender,rgbWhite) == 100);
+
+	cRender.Cls(0);
+	Core::Point_t pSquare[4] = { { 5,5 }, { 15,5 }, { 15,15 }, { 5,15 } };
+	cRender.DrawPolygon(pSquare,4,(int) rgbWhite);
+	bOk &= Check("Polygon square",CountColor(cRender,rgbWhite) == 100 && cRender.GetPixel(5,5) == rgbWhite && cRender.GetPixel(15,15) == 0);
+
+	cRender.Cls(0);
+	cRender.DrawCircle(300,300,50,(int) rgbWhite);
+	bOk &= Check("Circle",fabs(CountColor(cRender,rgbWhite) - 3.14159265*50*50)/(3.14159265*50*50) < 0.02);
+
+	cRender.Cls(0);
+	cRender.DrawTriangle({ 0,0 },{ 100,0 },{ 0,100 },(int) rgbWhite);
+	bOk &= Check("Triangle",abs(CountColor(cRender,rgbWhite) - 5000) < 150);
+
+	cRender.Cls(0);
+	cRender.DrawCircle(-10,-10,50,(int) rgbWhite,(int) Core::MakeRGB(255,0,0));		// Clipped
+	cRender.DrawLine(-100,-50,2000,900,(int) rgbWhite);
+	bOk &= Check("Clipping",cRender.GetPixel(0,0) == rgbWhite);
+
+	// Long lines are clipped before they are drawn, so they take no longer than a line across the canvas
+
+	cRender.Cls(0);
+	auto tStart = std::chrono::high_resolution_clock::now();
+	cRender.DrawLine(-100000000,-5000,100000000,-4000,(int) rgbWhite);					// 2e8 pixels, all above the canvas
+	cRender.DrawLine(-2147483647,-2147483647,2147483647,2147483647,(int) rgbWhite);		// |dx| near 2^32, through (0,0)
+	double fLongMS = std::chrono::duration<double,std::milli>(std::chrono::high_resolution_clock::now() - tStart).count();
+	int iDiagonal = 0;
+	for (int i=0;i<kHeight;i++) if (cRender.GetPixel(i,i) == rgbWhite) iDiagonal++;
+	bOk &= Check("Long lines",CountColor(cRender,rgbWhite) == kHeight && iDiagonal == kHeight && fLongMS < 50);
+
+	cRender.Cls((int) Core::MakeRGB(0,0,0),(int) Core::MakeRGB(255,128,0));
+	bOk &= Check("Gradient",cRender.GetPixel(10,0) == Core::MakeRGB(0,0,0) && cRender.GetPixel(10,kHeight-1) == Core::MakeRGB(255,128,0));
+
+	cRender.Cls(0);
+	Core::Bitmap32_t stBlend = Core::CreateBitmap32(4,4);
+	for (int y=0;y<4;y++) for (int x=0;x<4;x++) stBlend.Row(y)[x] = 0x80FFFFFF;		// White at alpha 128
+	cRender.BlendBitmap(0,0,stBlend);
+	Core::DeleteBitmap32(stBlend);
+	bOk &= Check("Blend",cRender.GetPixel(1,1) == Core::MakeRGB(128,128,128));
+	return bOk;
+}
+
+// DrawScene() -- One of each, for the .ppm
+
+static void DrawScene(Core::CRenderBackend & cRender,const Core::Bitmap_t & stBitmap24,const Core::Bitmap32_t & stBitmap32)
+{
+	cRender.Cls((int) Core::MakeRGB(0,0,64),(int) Core::MakeRGB(0,0,0));
+	cRender.SetPenThickness(3);
+	cRender.DrawRectangle(40,40,200,120,(int) Core::MakeRGB(0,128,255),(int) Core::MakeRGB(255,255,255));
+	cRender.DrawCircle(400,100,60,(int) Core::MakeRGB(255,0,0),(int) Core::MakeRGB(255,255,0));
+	cRender.DrawTriangle({ 520,160 },{ 620,40 },{ 720,160 },(int) Core::MakeRGB(0,255,0),(int) Core::MakeRGB(255,255,255));
+	Core::Point_t pStar[10];
+	for (int i=0;i<10;i++)
+	{
+		double fAngle = i*3.14159265/5, fRadius = i & 1 ? 30 : 70;
+		pStar[i] = { 880 + (int) (fRadius*sin(fAngle)), 100 - (int) (fRadius*cos(fAngle)) };
+	}
+	cRender.DrawPolygon(pStar,10,(int) Core::MakeRGB(255,215,0),(int) Core::MakeRGB(255,128,0));
+	for (int i=0;i<20;i++) cRender.DrawLine(40 + i*20,240,240 + i*40,400,(int) Core::MakeRGB(i*12,255 - i*12,128));
+	cRender.SetPenThickness(1);
+	for (int i=0;i<2000;i++) cRender.SetPixel(1000 + i % 200,260 + (i*37) % 140,(int) Core::MakeRGB(255,255,255));
+	cRender.DisplayBitmap(40,460,stBitmap24);
+	cRender.DisplayBitmap(240,460,stBitmap32);
+	cRender.BlendBitmap(320,500,stBitmap32);
+}
+
+static bool WritePPM(const char * sFile,const Core::Bitmap32_t & stCanvas)
+{
+	FILE * fp = fopen(sFile,"wb");
+	if (!fp) return false;
+	fprintf(fp,"P6\n%d %d\n255\n",stCanvas.iWidth,stCanvas.iHeight);
+	for (int y=0;y<stCanvas.iHeight;y++)
+		for (int x=0;x<stCanvas.iWidth;x++)
+		{
+			unsigned int uiPixel = stCanvas.Row(y)[x];
+			unsigned char sRGB[3] = { (unsigned char) (uiPixel >> 16), (unsigned char) (uiPixel >> 8), (unsigned char) uiPixel };
+			fwrite(sRGB,1,3,fp);
+		}
+	fclose(fp);
+	return true;
+}
+
+int main(int argc,char * argv[])
+{
+	if (argc > 2 || (argc == 2 && argv[1][0] == '-'))
+	{
+		printf("Usage: RenderBench [Scene.ppm]\n");
+		return 1;
+	}
+
+	Core::Bitmap32_t stCanvas = Core::CreateBitmap32(kWidth,kHeight);
+	Core::CSoftRender cRender(stCanvas);
+	if (!CheckResults(cRender)) return 1;
+
+	// Bitmaps for DisplayBitmap() and BlendBitmap() -- 128x128, the 32-bit one with alpha rising left to right
+
+	Core::Bitmap_t stBitmap24	= Core::CreateBitmap(128,128);
+	Core::Bitmap32_t stBitmap32	= Core::CreateBitmap32(128,128);
+	for (int y=0;y<128;y++)
+		for (int x=0;x<128;x++)
+		{
+			unsigned char * sPixel = stBitmap24.Row(y) + x*3;
+			sPixel[0] = (unsigned char) (x*2); sPixel[1] = (unsigned char) (y*2); sPixel[2] = 128;
+			stBitmap32.Row(y)[x] = ((unsigned int) (x*2) << 24) | ((unsigned int) (y*2) << 16) | 0x4080;
+		}
+
+	if (argc == 2)
+	{
+		DrawScene(cRender,stBitmap24,stBitmap32);
+		if (!WritePPM(argv[1],stCanvas)) { printf("Couldn't write %s\n",argv[1]); return 1; }
+		printf("Wrote %s\n\n",argv[1]);
+	}
+
+	volatile unsigned int uiSum = 0;			// Keeps the drawing from being optimized away
+	printf("%dx%d canvas\n\n",kWidth,kHeight);
+	printf("%-28s %10s %14s %12s\n","","Draws","Draws/s","Per draw");
+
+	auto fTime = [&](const char * sName,int iDraws,auto fDraw)
+	{
+		uiRandom = 12345;
+		double fMS = TimeBatch([&] { for (int i=0;i<iDraws;i++) fDraw(); uiSum = uiSum + stCanvas.Row(kHeight/2)[kWidth/2]; });
+		printf("%-28s %10d %14.0f %9.1f ns\n",sName,iDraws,iDraws/(fMS/1000),fMS*1e6/iDraws);
+	};
+
+	cRender.SetPenThickness(1);
+	fTime("SetPixel",1000000,[&] { cRender.SetPixel(Random(kWidth + 40) - 20,Random(kHeight + 40) - 20,(Core::Color_t) RandomColor()); });
+	fTime("DrawLine (100px)",100000,[&] { int x = Random(kWidth), y = Random(kHeight); cRender.DrawLine(x,y,x + Random(141) - 70,y + Random(141) - 70,RandomColor()); });
+	cRender.SetPenThickness(4);
+	fTime("DrawLine (100px, pen 4)",100000,[&] { int x = Random(kWidth), y = Random(kHeight); cRender.DrawLine(x,y,x + Random(141) - 70,y + Random(141) - 70,RandomColor()); });
+	cRender.SetPenThickness(2);
+	fTime("DrawRectangle (64x64)",100000,[&] { cRender.DrawRectangle(Random(kWidth) - 32,Random(kHeight) - 32,64,64,RandomColor(),RandomColor()); });
+	fTime("DrawCircle (r 32)",100000,[&] { cRender.DrawCircle(Random(kWidth),Random(kHeight),32,RandomColor(),RandomColor()); });
+	fTime("DrawTriangle (80px)",100000,[&]
+	{
+		int x = Random(kWidth), y = Random(kHeight);
+		cRender.DrawTriangle({ x,y },{ x + 80,y + Random(40) },{ x + Random(80),y + 80 },RandomColor(),RandomColor());
+	});
+	fTime("DrawPolygon (8 vertices)",100000,[&]
+	{
+		int x = Random(kWidth), y = Random(kHeight);
+		Core::Point_t pPoints[8];
+		for (int i=0;i<8;i++) pPoints[i] = { x + (int) (40*cos(i*0.785398)) + Random(9),y + (int) (40*sin(i*0.785398)) + Random(9) };
+		cRender.DrawPolygon(pPoints,8,RandomColor());
+	});
+	fTime("Cls (gradient)",200,[&] { cRender.Cls(RandomColor(),RandomColor()); });
+	fTime("DisplayBitmap (24-bit 128)",20000,[&] { cRender.DisplayBitmap(Random(kWidth) - 64,Random(kHeight) - 64,stBitmap24); });
+	fTime("DisplayBitmap (32-bit 128)",20000,[&] { cRender.DisplayBitmap(Random(kWidth) - 64,Random(kHeight) - 64,stBitmap32); });
+	fTime("BlendBitmap (128)",20000,[&] { cRender.BlendBitmap(Random(kWidth) - 64,Random(kHeight) - 64,stBitmap32); });
+
+	Core::DeleteBitmap(stBitmap24);
+	Core::DeleteBitmap32(stBitmap32);
+	Core::DeleteBitmap32(stCanvas);
+	return 0;
+}
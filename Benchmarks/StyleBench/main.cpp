@@ -0,0 +1,102 @@
+
+// ---------------------------------------------------
+// SageBox -- Style Loading Benchmark (Windows only)
+// ---------------------------------------------------
+//
+// Times a cold start with a set of button styles: from the start of main() until the first window is up and every
+// style is registered, two ways:
+//
+//		-serial		-- CDavinci::LoadButtonStyle(File) for each style, after the window is created
+//		-preload	-- CStylePreload (see include/CStylePreload.h): the files are read (and JPEGs decoded) in the background
+//					   from the start of main(), overlapping SageBox's startup, and registered in order once the window is up
+//
+// Styles are PGR style packs, or .jpg files -- each JPEG is a graphic button style with one bitmap, decoded with
+// Core::ReadJpegFile() and registered with CDavinci::CreateGraphicButtonStyle().
+//
+// This links with the SageBox library:
+//
+//		cl /O2 /std:c++17 /I..\..\include main.cpp ..\..\lib\SageBox64.lib Msimg32.lib
+//
+// Usage: StyleBench -serial|-preload Style1.pgr|Style1.jpg [Style2.pgr ...]
+//
+// Each way should be run in its own process, and for a true cold start, with the files out of the file cache (i.e. after a
+// reboot, or on files copied fresh to another drive) -- otherwise only the warm-start time is measured.
+//
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include "CSageBox.h"
+#include "CStylePreload.h"
+
+using namespace Sage;
+
+// isJpeg() -- true for a .jpg or .jpeg file (a graphic button style)
+
+static bool isJpeg(const char * sFile)
+{
+	const char * sExt = strrchr(sFile,'.');
+	return sExt && (!_stricmp(sExt,".jpg") || !_stricmp(sExt,".jpeg"));
+}
+
+// StyleName() -- The name for a graphic button style: its file name, without the path or extension
+
+static std::string StyleName(const char * sFile)
+{
+	std::string sName = sFile;
+	size_t iStart = sName.find_last_of("\\/");
+	if (iStart != std::string::npos) sName.erase(0,iStart + 1);
+	return sName.substr(0,sName.rfind('.'));
+}
+
+int main(int argc,char * argv[])
+{
+	using Clock = std::chrono::high_resolution_clock;
+	auto tStart = Clock::now();
+
+	bool bPreload = argc > 1 && !strcmp(argv[1],"-preload");
+	if (argc < 3 || (!bPreload && strcmp(argv[1],"-serial")))
+	{
+		printf("Usage: StyleBench -serial|-preload Style1.pgr|Style1.jpg [Style2.pgr ...]\n");
+		return 1;
+	}
+
+	CStylePreload cPreload;
+	if (bPreload)
+	{
+		for (int i=2;i<argc;i++)
+			if (isJpeg(argv[i])) cPreload.AddGraphicButtonStyle(StyleName(argv[i]).c_str(),argv[i]);
+			else cPreload.AddButtonStyle(argv[i]);
+		cPreload.Start();
+	}
+
+	CSageBox cSageBox("StyleBench");
+	CWindow & cWin = cSageBox.NewWindow(100,100,800,600,"StyleBench");
+	CDavinci & cDavinci = *cWin.GetDavinci();
+
+	int iLoaded = 0;
+	if (bPreload)
+	{
+		cPreload.Register(cDavinci);
+		for (int i=0;i<cPreload.GetStyleCount();i++) if (cPreload.GetStyleName(i)) iLoaded++;
+	}
+	else
+		for (int i=2;i<argc;i++)
+		{
+			if (!isJpeg(argv[i])) { if (cDavinci.LoadButtonStyle(argv[i])) iLoaded++; continue; }
+
+			bool bSuccess = false;
+			CSageBitmap cBitmap = Core::ReadJpegFile(argv[i],&bSuccess);
+			GraphicButtonStyle stButton = {};
+			stButton.stNormal = *cBitmap;
+			if (bSuccess && cDavinci.CreateGraphicButtonStyle(StyleName(argv[i]).c_str(),stButton)) iLoaded++;
+		}
+
+	double fTime = std::chrono::duration<double,std::milli>(Clock::now() - tStart).count();
+
+	cWin.printf("%s: %d of %d styles loaded\nTime to first window with styles: %.1f ms\n",bPreload ? "Preload" : "Serial",iLoaded,argc - 2,fTime);
+	printf("%s: %d of %d styles loaded -- time to first window with styles: %.1f ms\n",bPreload ? "Preload" : "Serial",iLoaded,argc - 2,fTime);
+	cWin.WaitforClose();
+	return 0;
+}
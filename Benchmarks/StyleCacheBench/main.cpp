@@ -0,0 +1,136 @@
+
+// --------------------------------------------------
+// SageBox -- Style Bitmap Cache Benchmark (Portable)
+// --------------------------------------------------
+//
+// Creates a grid of buttons two ways and compares the time and memory for their state bitmaps:
+//
+//		Per button	-- each button builds its own state bitmaps, as buttons are created now
+//		Shared		-- each button gets its bitmaps from Core::CStyleBitmapCache (see include/Core/CStyleBitmapCache.h),
+//					   so buttons with the same style, color style and size share one set
+//
+// Build:
+//
+//		g++ -O2 -std=c++17 -pthread -I../../include main.cpp -o StyleCacheBench
+//		cl /O2 /std:c++17 /I..\..\include main.cpp
+//
+// Usage: StyleCacheBench [Buttons]		-- Number of buttons in the grid (default 1000)
+//
+// The grid uses 2 styles x 3 color styles x 2 sizes, and each button has 6 state bitmaps built by a stand-in for the
+// style compositing (a shaded face with an outline).
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <vector>
+#include "Core/CStyleBitmapCache.h"
+
+using namespace Sage;
+
+static constexpr int kStates = 6;
+
+struct ButtonDef_t
+{
+	const char * sStyle;
+	const char * sColorStyle;
+	int iWidth;
+	int iHeight;
+};
+
+// BuildState() -- Stand-in for compositing a state bitmap from a style
+
+static bool BuildState(Core::Bitmap_t & stBitmap,const ButtonDef_t & stDef,int iState)
+{
+	stBitmap = Core::CreateBitmap(stDef.iWidth,stDef.iHeight,true);
+	if (!stBitmap.isValid()) return false;
+
+	int iTint = (stDef.sColorStyle[0]*7 + stDef.sStyle[0]*3 + iState*25) & 127;
+	for (int y=0;y<stDef.iHeight;y++)
+	{
+		unsigned char * sRow = stBitmap.Row(y);
+		unsigned char * sMask = stBitmap.MaskRow(y);
+		bool bEdgeY = y == 0 || y == stDef.iHeight - 1;
+		for (int x=0;x<stDef.iWidth;x++)
+		{
+			bool bEdge = bEdgeY || x == 0 || x == stDef.iWidth - 1;
+			int iShade = bEdge ? 40 : 100 + iTint + y*2;
+			sRow[x*3] = (unsigned char) iShade; sRow[x*3+1] = (unsigned char) (iShade + 20); sRow[x*3+2] = (unsigned char) (iShade + 40);
+			sMask[x] = bEdge ? 128 : 255;
+		}
+	}
+	return true;
+}
+
+struct Button_t
+{
+	Core::Bitmap_t stOwned[kStates];			// Per button
+	Core::SharedBitmap_t spShared[kStates];		// Shared
+};
+
+int main(int argc,char * argv[])
+{
+	int iButtons = argc > 1 ? atoi(argv[1]) : 1000;
+	if (iButtons < 1)
+	{
+		printf("Usage: StyleCacheBench [Buttons]\n");
+		return 1;
+	}
+
+	static const char * sStyles[]		= { "Panel", "Glass" };
+	static const char * sColorStyles[]	= { "Blue", "Green", "Dark" };
+	static const int iSizes[][2]		= { { 120, 32 }, { 200, 40 } };
+
+	std::vector<ButtonDef_t> vDefs(iButtons);
+	for (int i=0;i<iButtons;i++) vDefs[i] = { sStyles[i % 2], sColorStyles[(i/2) % 3], iSizes[(i/6) % 2][0], iSizes[(i/6) % 2][1] };
+
+	using Clock = std::chrono::high_resolution_clock;
+	std::vector<Button_t> vButtons(iButtons);
+
+	// Per button
+
+	size_t iOwnedBytes = 0;
+	auto tStart = Clock::now();
+	for (int i=0;i<iButtons;i++)
+		for (int j=0;j<kStates;j++)
+		{
+			Core::Bitmap_t & stBitmap = vButtons[i].stOwned[j];
+			if (!BuildState(stBitmap,vDefs[i],j)) { printf("Out of memory\n"); return 1; }
+			iOwnedBytes += (size_t) stBitmap.iWidthBytes*stBitmap.iHeight + (size_t) stBitmap.iWidth*stBitmap.iHeight;
+		}
+	double fOwned = std::chrono::duration<double,std::milli>(Clock::now() - tStart).count();
+	for (auto & stButton : vButtons) for (auto & stBitmap : stButton.stOwned) Core::DeleteBitmap(stBitmap);
+
+	// Shared
+
+	Core::CStyleBitmapCache cCache;
+	tStart = Clock::now();
+	for (int i=0;i<iButtons;i++)
+	{
+		const ButtonDef_t & stDef = vDefs[i];
+		for (int j=0;j<kStates;j++)
+		{
+			Core::StyleBitmapKey_t stKey = { stDef.sStyle, stDef.sColorStyle, stDef.iWidth, stDef.iHeight, (Core::StyleBitmapState) j };
+			vButtons[i].spShared[j] = cCache.Get(stKey,[&](Core::Bitmap_t & stBitmap) { return BuildState(stBitmap,stDef,j); });
+			if (!vButtons[i].spShared[j]) { printf("Out of memory\n"); return 1; }
+		}
+	}
+	double fShared = std::chrono::duration<double,std::milli>(Clock::now() - tStart).count();
+
+	Core::StyleBitmapStats_t stStats = cCache.GetStats();
+	size_t iSharedBytes = iOwnedBytes - (size_t) stStats.iBytesShared;
+
+	printf("%d buttons, %d state bitmaps each\n\n",iButtons,kStates);
+	printf("%-12s %12s %12s %10s\n","","Time","Memory","Bitmaps");
+	printf("%-12s %9.2f ms %9.2f MB %10d\n","Per button",fOwned,iOwnedBytes/1e6,iButtons*kStates);
+	printf("%-12s %9.2f ms %9.2f MB %10d\n","Shared",fShared,iSharedBytes/1e6,stStats.iBitmaps);
+	printf("\nCache: %lld hits, %lld misses (%.1f%% hit rate) -- %.1fx faster, %.0fx less memory\n",stStats.iHits,stStats.iMisses,
+			100.0*stStats.iHits/(stStats.iHits + stStats.iMisses),fOwned/fShared,(double) iOwnedBytes/iSharedBytes);
+
+	// Deleting the buttons releases the bitmaps; Trim() then empties the cache
+
+	vButtons.clear();
+	int iFreed = cCache.Trim();
+	printf("Buttons deleted: Trim() freed %d bitmaps, %d left\n",iFreed,cCache.GetStats().iBitmaps);
+	return 0;
+}
@@ -0,0 +1,128 @@
+//#pragma once
+#if !defined(_CControlIndex_H_)
+#define _CControlIndex_H_
+
+// -----------------------------------------------------------------
+// CControlIndex.H -- Find a window's controls by name or ID in O(1)
+// -----------------------------------------------------------------
+//
+// CWindow::button("MyButton"), editbox(), slider(), listbox() and window() search through the window's controls on every call,
+// which adds up in event handlers called for every event across hundreds of controls.  CControlIndex has the same functions,
+// backed by hash maps from name and from ID to control (see Core/CControlMap.h):
+//
+//		CControlIndex cIndex(cWin);
+//
+//		cIndex.Add(cWin.NewButton(10,10,"OK",Name("OK") | ID(1)));		// Add() returns the control it is given
+//
+//		if (cIndex.button("OK").Pressed()) ...								// One hash lookup
+//		if (cIndex.button(1).Pressed()) ...
+//
+// Controls don't have to be added: a control that isn't in the index is found with CWindow's search, the first time, and added
+// then.  Controls that aren't found at all return the same empty control CWindow returns, so button("Misspelled").Pressed()
+// still passively fails.
+//
+// Deleted controls are dropped: control objects stay in memory until their window is closed, and a control that is no longer
+// valid (isValid() is false) is taken out of the index and looked up again with CWindow's search.  The index is cleared when
+// the window is destroyed.
+//
+// CControlIndex isn't thread-safe; use it from the thread handling the window's events (as with CWindow).
+//
+#include "CWindow.h"
+#include "Core/CControlMap.h"
+
+namespace Sage
+{
+class CControlIndex
+{
+private:
+	CWindow & m_cWin;
+	bool m_bAttached = false;			// Attached to the window as a deleter, to be cleared when it is destroyed
+
+	Core::CControlMap<CButton>	m_cButtons;
+	Core::CControlMap<CEditBox>	m_cEditBoxes;
+	Core::CControlMap<CSlider>	m_cSliders;
+	Core::CControlMap<CListBox>	m_cListBoxes;
+	Core::CControlMap<CWindow>	m_cWindows;
+
+	// WindowDestroyed() -- Called by the window as it is destroyed (see CWindow::AttachDeleter())
+
+	static void WindowDestroyed(void * pIndex)
+	{
+		CControlIndex * cIndex = (CControlIndex *) pIndex;
+		cIndex->m_bAttached = false;
+		cIndex->Clear();
+	}
+
+	// Find() -- The control from the index if it is there and still valid, otherwise from CWindow's search (and added)
+
+	template <class _t,class _key>
+	_t & Find(Core::CControlMap<_t> & cMap,_key Key,_t & (CWindow::*fSearch)(_key))
+	{
+		_t * cControl = cMap.Find(Key);
+		if (cControl && cControl->isValid()) return *cControl;
+		if (cControl) cMap.Remove(cControl);
+
+		_t & cFound = (m_cWin.*fSearch)(Key);
+		if (cFound.isValid()) Add(cMap,cFound);
+		return cFound;
+	}
+
+	template <class _t>
+	_t & Add(Core::CControlMap<_t> & cMap,_t & cControl)
+	{
+		if (cControl.isValid()) cMap.Add(&cControl,cControl.GetName(),cControl.GetID());
+		return cControl;
+	}
+
+public:
+	CControlIndex(CWindow & cWin) : m_cWin(cWin)
+	{
+		m_cWin.AttachDeleter(this,WindowDestroyed);
+		m_bAttached = true;
+	}
+	~CControlIndex() { if (m_bAttached) m_cWin.RemoveDeleter(this); }
+
+	CControlIndex(const CControlIndex &) = delete;
+	CControlIndex & operator = (const CControlIndex &) = delete;
+
+	// Add() -- Add a control as it is created.  Returns the control, so it can wrap the New...() call.
+	//
+	CButton &	Add(CButton & cButton)		{ return Add(m_cButtons,cButton);		}
+	CEditBox &	Add(CEditBox & cEditBox)	{ return Add(m_cEditBoxes,cEditBox);	}
+	CSlider &	Add(CSlider & cSlider)		{ return Add(m_cSliders,cSlider);		}
+	CListBox &	Add(CListBox & cListBox)	{ return Add(m_cListBoxes,cListBox);	}
+	CWindow &	Add(CWindow & cWindow)		{ return Add(m_cWindows,cWindow);		}
+
+	// button(), editbox(), slider(), listbox(), window() -- As the CWindow functions, with a hash lookup
+	//
+	CButton &	button(const char * sName)		{ return Find(m_cButtons,sName,&CWindow::button);		}
+	CButton &	button(int iID)					{ return Find(m_cButtons,iID,&CWindow::button);			}
+	CEditBox &	editbox(const char * sName)		{ return Find(m_cEditBoxes,sName,&CWindow::editbox);	}
+	CEditBox &	editbox(int iID)				{ return Find(m_cEditBoxes,iID,&CWindow::editbox);		}
+	CSlider &	slider(const char * sName)		{ return Find(m_cSliders,sName,&CWindow::slider);		}
+	CSlider &	slider(int iID)					{ return Find(m_cSliders,iID,&CWindow::slider);			}
+	CListBox &	listbox(const char * sName)		{ return Find(m_cListBoxes,sName,&CWindow::listbox);	}
+	CListBox &	listbox(int iID)				{ return Find(m_cListBoxes,iID,&CWindow::listbox);		}
+	CWindow &	window(const char * sName)		{ return Find(m_cWindows,sName,&CWindow::window);		}
+	CWindow &	window(int iID)					{ return Find(m_cWindows,iID,&CWindow::window);			}
+
+	// Remove() -- Take a control out of the index (i.e. before deleting it).  Not needed for correctness -- deleted controls are
+	// dropped when they are next looked up -- but keeps the index from holding them until then.
+	//
+	void Remove(CButton & cButton)		{ m_cButtons.Remove(&cButton);		}
+	void Remove(CEditBox & cEditBox)	{ m_cEditBoxes.Remove(&cEditBox);	}
+	void Remove(CSlider & cSlider)		{ m_cSliders.Remove(&cSlider);		}
+	void Remove(CListBox & cListBox)	{ m_cListBoxes.Remove(&cListBox);	}
+	void Remove(CWindow & cWindow)		{ m_cWindows.Remove(&cWindow);		}
+
+	void Clear()
+	{
+		m_cButtons.Clear();
+		m_cEditBoxes.Clear();
+		m_cSliders.Clear();
+		m_cListBoxes.Clear();
+		m_cWindows.Clear();
+	}
+};
+}; // namespace Sage
+#endif // _CControlIndex_H_
@@ -0,0 +1,167 @@
+//#pragma once
+#if !defined(_CDirtyUpdate_H_)
+#define _CDirtyUpdate_H_
+
+// --------------------------------------------------------------
+// CDirtyUpdate.H -- Update only the parts of a window drawn into
+// --------------------------------------------------------------
+//
+// Update() presents the whole canvas if anything was drawn.  CDirtyUpdate has the common drawing functions of CWindow, which
+// draw as usual and record the rectangle drawn into (see Core/CDirtyRegion.h).  Its Update() then presents only those
+// rectangles with UpdateRegion(), or the whole window with Update() past the coverage threshold:
+//
+//		CDirtyUpdate cDraw(cWin);
+//
+//		cDraw.Write("Status: Ok\n");				// Text at the write position
+//		cDraw.SetPixel(100,100,RGB(255,0,0));
+//		cDraw.Mark(200,200,64,64);					// Anything drawn with cWin directly
+//		cDraw.Update();								// Presents two or three small rectangles, not the window
+//
+// Text written at the write position is recorded from the position before and after the write -- the rest of the line when
+// it wraps or has a newline.  When the write position moves up (i.e. the window scrolled), the whole window is presented.
+// Lines and outlines are padded by the pen thickness (set it with SetPenThickness() here so it is known).
+//
+// Text is measured with the window's current font.  Options (e.g. a font or centering) can change both the size and the
+// place of the text, so text written with options marks the full width of the canvas from the line it starts on down, or
+// the whole window when the options place the text (Center..., Just...).
+//
+// Turn off automatic updates (i.e. with cWin.SetAutoUpdate(false)) so the window isn't also updated in full.
+//
+// GetStats() returns the frames, rectangles and pixels presented, to see how much of the window each Update() presents.
+//
+#include <cctype>
+#include "CSageBox.h"
+#include "Core/CDirtyRegion.h"
+
+namespace Sage
+{
+class CDirtyUpdate
+{
+private:
+	CWindow & m_cWin;
+	Core::CDirtyRegion m_cRegion;
+	int m_iPenThickness = 1;
+
+	// CheckSize() -- Follow the canvas size (a change clears the region and presents the whole window)
+
+	void CheckSize()
+	{
+		SIZE szCanvas{};
+		if (!m_cWin.GetCanvasSize(szCanvas)) return;
+		Core::Size_t szRegion = m_cRegion.GetSize();
+		if (szCanvas.cx == szRegion.cx && szCanvas.cy == szRegion.cy) return;
+		m_cRegion.SetSize(szCanvas.cx,szCanvas.cy);
+		m_cRegion.AddAll();
+	}
+
+	// MarkText() -- The rectangle written to from pStart to pEnd (the write position before and after writing)
+
+	void MarkText(POINT pStart,POINT pEnd,int iLineHeight)
+	{
+		CheckSize();
+		if (pEnd.y < pStart.y) { m_cRegion.AddAll(); return; }
+		if (pEnd.y == pStart.y) { m_cRegion.Add(pStart.x,pStart.y,pEnd.x - pStart.x,iLineHeight); return; }
+		m_cRegion.Add(pStart.x,pStart.y,m_cRegion.GetSize().cx - pStart.x,iLineHeight);
+		m_cRegion.Add(0,pStart.y + iLineHeight,m_cRegion.GetSize().cx,pEnd.y - pStart.y);
+	}
+
+	// MarkOptions() -- Text written with options, which can't be measured here: the full width of the canvas from iY down,
+	// or the whole window when the options place the text somewhere else
+
+	void MarkOptions(int iY,const char * sOptions)
+	{
+		CheckSize();
+		auto StartsWith = [](const char * s,const char * sWord) { for (; *sWord; s++,sWord++) if (tolower((unsigned char) *s) != *sWord) return false; return true; };
+		for (const char * s = sOptions; *s; s++)
+		{
+			if (StartsWith(s,"center") || StartsWith(s,"just")) { m_cRegion.AddAll(); return; }
+		}
+		Core::Size_t szRegion = m_cRegion.GetSize();
+		m_cRegion.Add(0,iY,szRegion.cx,szRegion.cy - iY);
+	}
+
+	void MarkPadded(int iLeft,int iTop,int iRight,int iBottom)
+	{
+		int iPad = m_iPenThickness/2 + 1;
+		Mark(Core::Rect_t{ iLeft - iPad, iTop - iPad, iRight + iPad + 1, iBottom + iPad + 1 });
+	}
+
+public:
+	CDirtyUpdate(CWindow & cWin) : m_cWin(cWin) { CheckSize(); }
+
+	CDirtyUpdate(const CDirtyUpdate &) = delete;
+	CDirtyUpdate & operator = (const CDirtyUpdate &) = delete;
+
+	// Mark() -- Record a rectangle drawn into some other way.  MarkAll() presents the whole window on the next Update().
+	//
+	void Mark(int iX,int iY,int iWidth,int iHeight) { CheckSize(); m_cRegion.Add(iX,iY,iWidth,iHeight); }
+	void Mark(const Core::Rect_t & rRect)			{ CheckSize(); m_cRegion.Add(rRect); }
+	void Mark(const RECT & rRect)					{ Mark(Core::Rect_t{ (int) rRect.left, (int) rRect.top, (int) rRect.right, (int) rRect.bottom }); }
+	void MarkAll()									{ CheckSize(); m_cRegion.AddAll(); }
+
+	// Drawing -- As the CWindow functions, recording what was drawn into
+	//
+	void Write(const char * sText,const char * sOptions = nullptr)
+	{
+		POINT pStart = m_cWin.GetWritePos();
+		m_cWin.Write(sText,sOptions);
+		if (sOptions && *sOptions) { MarkOptions(m_cWin.GetWritePos().y < pStart.y ? 0 : pStart.y,sOptions); return; }
+		MarkText(pStart,m_cWin.GetWritePos(),m_cWin.GetTextSize("W").cy);
+	}
+	void Write(int iX,int iY,const char * sText,char * sOptions = nullptr)
+	{
+		m_cWin.Write(iX,iY,sText,sOptions);
+		if (sOptions && *sOptions) { MarkOptions(iY,sOptions); return; }
+		SIZE szText = m_cWin.GetTextSize(sText);
+		Mark(iX,iY,szText.cx,szText.cy);
+	}
+	bool SetPixel(int iX,int iY,DWORD dwColor)
+	{
+		Mark(iX,iY,1,1);
+		return m_cWin.SetPixel(iX,iY,dwColor);
+	}
+	bool DrawLine(int ix1,int iy1,int ix2,int iy2,int iColor)
+	{
+		MarkPadded(ix1 < ix2 ? ix1 : ix2,iy1 < iy2 ? iy1 : iy2,ix1 > ix2 ? ix1 : ix2,iy1 > iy2 ? iy1 : iy2);
+		return m_cWin.DrawLine(ix1,iy1,ix2,iy2,iColor);
+	}
+	bool DrawRectangle(int iX,int iY,int iWidth,int iHeight,int iColor,int iColor2 = -1)
+	{
+		MarkPadded(iX,iY,iX + iWidth,iY + iHeight);
+		return m_cWin.DrawRectangle(iX,iY,iWidth,iHeight,iColor,iColor2);
+	}
+	bool DrawCircle(int iX,int iY,int iRadius,int iColor1,int iColor2 = -1)
+	{
+		MarkPadded(iX - iRadius,iY - iRadius,iX + iRadius,iY + iRadius);
+		return m_cWin.DrawCircle(iX,iY,iRadius,iColor1,iColor2);
+	}
+	void Cls(DWORD iColor1 = -1,DWORD iColor2 = -1)
+	{
+		m_cWin.Cls(iColor1,iColor2);
+		MarkAll();
+	}
+	bool SetPenThickness(int iThickness)
+	{
+		m_iPenThickness = iThickness > 0 ? iThickness : 1;
+		return m_cWin.SetPenThickness(iThickness);
+	}
+
+	// Update() -- Present the recorded rectangles (or the whole window), and clear them.  Returns false if nothing was drawn.
+	//
+	bool Update()
+	{
+		return m_cRegion.Present([&](const Core::Rect_t & rRect) { m_cWin.UpdateRegion(rRect.left,rRect.top,rRect.right - rRect.left,rRect.bottom - rRect.top); },
+								 [&] { m_cWin.Update(); });
+	}
+
+	// SetThreshold() -- The part of the window (0-1) past which Update() presents the whole window.  0.5 by default.
+	//
+	void SetThreshold(double fThreshold) { m_cRegion.SetThreshold(fThreshold); }
+
+	const Core::DirtyStats_t & GetStats() const { return m_cRegion.GetStats(); }
+	void ResetStats() { m_cRegion.ResetStats(); }
+
+	Core::CDirtyRegion & GetRegion() { return m_cRegion; }
+};
+}; // namespace Sage
+#endif // _CDirtyUpdate_H_
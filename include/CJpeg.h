@@ -1,11 +1,14 @@
 ////#pragma once
 
 #include "Sage.h"
+#include "Core/CJpegInfo.h"
 
 #if !defined(_CJPEG_H_)
 #define _CJPEG_H_
 namespace Sage
 {
+// Note: CJpeg decodes one JPEG at a time for the whole process (see SetBusy()).  To decode on several threads at once,
+// use Core::ReadJpegFile() or Core::ReadJpegFiles() in SageKernels.h, which use the re-entrant Core::CJpegDecoder.
 
 class CJpeg
 {
@@ -28,6 +31,15 @@ public:
 	[[nodiscard]] RawBitmap_t  ReadJpegFile(const char * sPath,bool * bSuccess = nullptr);
 	[[nodiscard]] RawBitmap_t  ReadJpeg(const unsigned char * sData,int iDataLength,bool * bSuccess = nullptr);
 	Status GetStatus() { return m_eStatus; }		// Status of last opersation/request
+
+	// GetJpegInfo() -- Get the width, height, number of components and progressive flag of a JPEG file or memory buffer
+	// from its header, without decoding the image.  Returns false if the file can't be read or isn't a JPEG.
+	//
+	static bool GetJpegInfo(const char * sPath,Core::JpegInfo_t & stInfo) { return Core::ProbeJpegFile(sPath,stInfo) == Core::JpegStatus::Ok; }
+	static bool GetJpegInfo(const unsigned char * sData,int iDataLength,Core::JpegInfo_t & stInfo)
+	{
+		return Core::ProbeJpeg(sData,iDataLength > 0 ? (size_t) iDataLength : 0,stInfo) == Core::JpegStatus::Ok;
+	}
 };
 }; // namespace Sage
 #endif // _CJPEG_H_
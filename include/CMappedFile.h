@@ -0,0 +1,100 @@
+//#pragma once
+#if !defined(_CMappedFile_H_)
+#define _CMappedFile_H_
+
+// ------------------------------------------------------
+// CMappedFile.H -- Read a file through a memory mapping
+// ------------------------------------------------------
+//
+// CMappedFile maps a whole file into memory, so its contents can be used in place instead of being read into a buffer.
+// Pages are only loaded by the OS when first touched, and are shared with the file cache, so mapping a large file costs
+// almost nothing until it is used -- and parts that are never looked at are never read.
+//
+// The mapping is copy-on-write: the memory may be written to (i.e. decrypted in place), but the changes only go to
+// private copies of the changed pages and are never written back to the file.
+//
+// The pointer from GetData() is valid until Close() or the CMappedFile is destroyed.
+//
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <stddef.h>
+
+namespace Sage
+{
+class CMappedFile
+{
+private:
+	unsigned char * m_sData	= nullptr;
+	size_t m_iSize			= 0;
+
+public:
+	CMappedFile() {}
+	CMappedFile(const char * sPath) { Open(sPath); }
+	~CMappedFile() { Close(); }
+
+	CMappedFile(const CMappedFile &) = delete;
+	CMappedFile & operator = (const CMappedFile &) = delete;
+
+	// Open() -- Map a file.  Returns false if the file can't be opened or is empty.
+
+	bool Open(const char * sPath)
+	{
+		Close();
+		if (!sPath || !*sPath) return false;
+
+#if defined(_WIN32)
+		HANDLE hFile = CreateFileA(sPath,GENERIC_READ,FILE_SHARE_READ,nullptr,OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,nullptr);
+		if (hFile == INVALID_HANDLE_VALUE) return false;
+
+		LARGE_INTEGER liSize;
+		HANDLE hMapping = nullptr;
+		if (GetFileSizeEx(hFile,&liSize) && liSize.QuadPart > 0) hMapping = CreateFileMappingA(hFile,nullptr,PAGE_WRITECOPY,0,0,nullptr);
+		CloseHandle(hFile);							// The mapping keeps the file open
+		if (!hMapping) return false;
+
+		m_sData = (unsigned char *) MapViewOfFile(hMapping,FILE_MAP_COPY,0,0,0);
+		CloseHandle(hMapping);						// The view keeps the mapping open
+		if (!m_sData) return false;
+		m_iSize = (size_t) liSize.QuadPart;
+#else
+		int iFile = open(sPath,O_RDONLY);
+		if (iFile < 0) return false;
+
+		struct stat stStat;
+		void * pData = MAP_FAILED;
+		if (!fstat(iFile,&stStat) && stStat.st_size > 0) pData = mmap(nullptr,(size_t) stStat.st_size,PROT_READ | PROT_WRITE,MAP_PRIVATE,iFile,0);
+		close(iFile);								// The mapping keeps the file open
+		if (pData == MAP_FAILED) return false;
+
+		m_sData = (unsigned char *) pData;
+		m_iSize = (size_t) stStat.st_size;
+#endif
+		return true;
+	}
+
+	// Close() -- Unmap the file.  Any pointers into the mapping are no longer valid.
+
+	void Close()
+	{
+		if (!m_sData) return;
+#if defined(_WIN32)
+		UnmapViewOfFile(m_sData);
+#else
+		munmap(m_sData,m_iSize);
+#endif
+		m_sData = nullptr;
+		m_iSize = 0;
+	}
+
+	unsigned char * GetData() const	{ return m_sData; }
+	size_t GetSize() const				{ return m_iSize; }
+	bool isOpen() const					{ return m_sData != nullptr; }
+};
+}; // namespace Sage
+#endif // _CMappedFile_H_
@@ -8,6 +8,8 @@
 #include <Windows.h>
 #include "Sage.h"
 #include "CString.h"
+#include "CMappedFile.h"
+#include "Core/CStringIndex.h"
 namespace Sage
 {
 
@@ -189,6 +191,39 @@ public:
 
 
 };
+
+// PGRView_t -- A file inside a PGR, in place in the PGR's memory (see CSagePGR::GetFileView())
+
+struct PGRView_t
+{
+    const unsigned char * sData;
+    int iSize;
+
+    bool isValid() const { return sData != nullptr; }
+};
+
+// stMappedPGRFile_t -- Holds the mapping for CMapPGR, so it is opened before CMemPGR is constructed over it
+
+struct stMappedPGRFile_t
+{
+    CMappedFile cMap;
+    stMappedPGRFile_t(const char * sFile) : cMap(sFile) {}
+};
+
+// CMapPGR -- A PGR read through a memory mapping of the file (see CMappedFile.h)
+//
+// This is a CMemPGR over the mapped file, so nothing is read up front -- the OS loads pages as they are used, and they
+// are shared with the file cache.  Files inside the PGR can be used in place with CSagePGR::GetFileView().
+//
+class CMapPGR : private stMappedPGRFile_t, public CMemPGR
+{
+public:
+    CMapPGR(const char * sFile) : stMappedPGRFile_t(sFile),
+        CMemPGR(cMap.GetData(),cMap.GetSize() <= 0x7FFFFFFF ? (int) cMap.GetSize() : 0) {}
+
+    bool isMapped() const { return cMap.isOpen() && cMap.GetSize() <= 0x7FFFFFFF; }
+};
+
 class CSagePGR
 {
 private:
@@ -224,8 +259,126 @@ public:
 	ePGR_t ReadFloat(double * fValue,char * sKey,char * sSubKey = nullptr); 
 	double ReadFloat(double fDefault,char * sKey,char * sSubKey = nullptr);
 	static void FreeFileMem(unsigned char * & sFile);
+
+	// ReadMappedPGR() -- Open a PGR file through a memory mapping instead of reading it in (see CMapPGR).
+	// This replaces ReadPGR() where files in the PGR are used through GetFileView().
+	//
+	ePGR_t ReadMappedPGR(const char * sFile)
+	{
+		DeletePGR();
+		CMapPGR * cMapPGR = new CMapPGR(sFile);
+		if (!cMapPGR->isMapped()) { delete cMapPGR; return ePGR_FileNotFound; }
+
+		m_cPGR = cMapPGR;
+		ePGR_t eResult = m_cPGR->ReadFile();
+		if (eResult != ePGR_OK) DeletePGR();
+		return eResult;
+	}
+
+	// GetFileView() -- Get a file in the PGR as a pointer into the PGR's memory, without allocating or copying it.
+	// This works for PGRs opened with ReadMappedPGR() or ReadMemPGR().  The view is valid until the PGR is closed or deleted.
+	//
+	// i.e. Core::ReadJpeg(stView.sData,stView.iSize) decodes a JPEG straight out of the mapped PGR file.
+	//
+	bool GetFileView(char * sFile,PGRView_t & stView)
+	{
+		stView = {};
+		CMemPGR * cMemPGR = dynamic_cast<CMemPGR *>(m_cPGR);
+		if (!cMemPGR || !cMemPGR->m_sPGRLocation) return false;
+
+		int iSize = 0;
+		int iLocation = cMemPGR->GetFileLocation(sFile,&iSize);
+		if (iLocation <= 0 || iSize < 0 || (unsigned int) iLocation + (unsigned int) iSize > cMemPGR->m_iFileSize) return false;
+
+		stView = { cMemPGR->m_sPGRLocation + iLocation, iSize };
+		return true;
+	}
+	PGRView_t GetFileView(char * sFile,bool * bSuccess = nullptr)
+	{
+		PGRView_t stView;
+		bool bResult = GetFileView(sFile,stView);
+		if (bSuccess) *bSuccess = bResult;
+		return stView;
+	}
+
+	// GetReader() -- The CReadPGR for the open PGR, or nullptr if none is open (i.e. to build a CPGRKeyIndex over it)
+
+	CReadPGR * GetReader() const { return m_cPGR; }
+
 	~CSagePGR();
 };
 
+// CPGRKeyIndex -- Hashed lookup of keys in an open PGR
+//
+// CReadPGR::FindKey() and FindPartialKey() compare against each key in the key table in turn.  CPGRKeyIndex is built once
+// after the PGR is opened and finds keys by name in O(1), and by prefix in O(log n), through a Core::CStringIndex over the
+// key table.  The results are the same as the linear search -- the first key in the table that matches.
+//
+// Only single key names are indexed.  Lookups with a sub-key still go through CSagePGR::FindKey(sKey,sSubKey).
+//
+// Build() checks the key table is in the PGR's string table as plain, terminated strings, and returns false (leaving the
+// index empty) otherwise, so callers can fall back to CSagePGR::FindKey().  The index points into the PGR's string table and
+// must be rebuilt (or cleared) when the PGR is re-opened or deleted.
+//
+class CPGRKeyIndex
+{
+private:
+	Core::CStringIndex	  m_cIndex;
+	CReadPGR			* m_cPGR = nullptr;
+
+public:
+	CPGRKeyIndex() {}
+	CPGRKeyIndex(CSagePGR & cPGR) { Build(cPGR); }
+
+	bool Build(CSagePGR & cPGR) { return Build(cPGR.GetReader()); }
+	bool Build(CReadPGR * cPGR)
+	{
+		Clear();
+		if (!cPGR || !cPGR->m_stPGRKeyTable || !cPGR->m_sStringTable) return false;
+
+		const stPGRHeader_t & stHeader = cPGR->m_stPGRHeader;
+		int iKeys = (int) stHeader.ulNumKeys;
+		if (iKeys <= 0 || !stHeader.ulStringTableLength) return false;
+
+		// Every key name and value must start inside the string table, and the table must end with a terminator
+
+		const char * sTable = cPGR->m_sStringTable;
+		unsigned int uiLength = stHeader.ulStringTableLength;
+		if (sTable[uiLength-1]) return false;
+		for (int i=0;i<iKeys;i++)
+		{
+			const stPGRKeyTable_t & stKey = cPGR->m_stPGRKeyTable[i];
+			if (stKey.ulKeynamePointer >= uiLength || stKey.ulKeyValuePointer >= uiLength) return false;
+		}
+
+		m_cIndex.Build(iKeys,[&](int i) { return sTable + cPGR->m_stPGRKeyTable[i].ulKeynamePointer; });
+		m_cPGR = cPGR;
+		return true;
+	}
+
+	void Clear() { m_cIndex.Clear(); m_cPGR = nullptr; }
+	bool isBuilt() const { return m_cPGR != nullptr; }
+
+	// FindKeyIndex() -- Index of sKey in the key table, or -1 if it isn't there
+
+	int FindKeyIndex(const char * sKey) const { return m_cIndex.Find(sKey); }
+
+	// FindPartialKey() -- Index of the first key in the key table starting with sKey, or -1 if there are none
+
+	int FindPartialKey(const char * sKey) const { return m_cIndex.FindPrefix(sKey); }
+
+	// FindKey() -- Value of sKey (in the PGR's string table), or nullptr if it isn't there
+
+	char * FindKey(const char * sKey) const { return GetValue(FindKeyIndex(sKey)); }
+
+	// GetValue() -- Value of the key at iIndex in the key table, or nullptr for -1
+
+	char * GetValue(int iIndex) const
+	{
+		if (!m_cPGR || iIndex < 0 || iIndex >= m_cIndex.GetCount()) return nullptr;
+		return m_cPGR->m_sStringTable + m_cPGR->m_stPGRKeyTable[iIndex].ulKeyValuePointer;
+	}
+};
+
 }; // namespace Sage
 #endif
\ No newline at end of file
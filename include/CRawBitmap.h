@@ -2,6 +2,9 @@
 
 #if !defined(_CRawBitmap_H_)
 #define _CRawBitmap_H_
+#include <atomic>
+#include <memory>
+#include <utility>
 #include "Sage.h"
 
 
@@ -19,6 +22,18 @@ public:
 	{ 
 		fBitmap = {}; 
 	}
+
+	// Moving a CFloatBitmap hands over the float planes without copying them.
+	// Copying is disabled -- a copy would share (and then delete twice) the same planes.
+
+	CFloatBitmap(CFloatBitmap && cBitmap) noexcept { fBitmap = cBitmap.fBitmap; cBitmap.fBitmap = {}; }
+	CFloatBitmap & operator = (CFloatBitmap && cBitmap) noexcept
+	{
+		if (this != &cBitmap) { fBitmap.Delete(); fBitmap = cBitmap.fBitmap; cBitmap.fBitmap = {}; }
+		return *this;
+	}
+	CFloatBitmap(const CFloatBitmap &) = delete;
+	CFloatBitmap & operator = (const CFloatBitmap &) = delete;
 	[[nodiscard]] Sage::RawBitmap_t ConverttoBitmap() { return fBitmap.ConverttoBitmap(); }
 	[[nodiscard]] Sage::RawBitmap_t ConverttoBitmap(Sage::RawBitmap_t & stBitmap) { return fBitmap.ConverttoBitmap(stBitmap); }
 	CFloatBitmap & operator = (CSageBitmap stBitmap);
@@ -57,9 +72,24 @@ public:
 	CSageBitmap(CFloatBitmap & cBitmap);
 	//CSageBitmap & operator = (RawBitmap_t & stBitmap) { this->stBitmap.Delete(); this->stBitmap = stBitmap; return *this; }
 	CSageBitmap & operator = (Sage::RawBitmap_t stBitmap) { this->stBitmap.Delete(); this->stBitmap = stBitmap; return *this; }
-	CSageBitmap & operator = (CSageBitmap csBitmap) 
-	{ this->stBitmap.Delete();
-		CopyFrom(csBitmap);  return *this; }
+	CSageBitmap & operator = (const CSageBitmap & csBitmap) 
+	{
+		if (this == &csBitmap) return *this;
+		this->stBitmap.Delete();
+		CopyFrom(csBitmap); CountCopy(); return *this; 
+	}
+
+	// Moving a CSageBitmap (i.e. returning one from ReadJpegFile()) hands over the memory without copying the pixels.
+
+	CSageBitmap & operator = (CSageBitmap && csBitmap) noexcept
+	{
+		if (this == &csBitmap) return *this;
+		stBitmap.Delete();
+		stBitmap = csBitmap.stBitmap;
+		csBitmap.stBitmap = {};
+		GetCounters().iMoves.fetch_add(1,std::memory_order_relaxed);
+		return *this;
+	}
 	CSageBitmap & operator = (Sage::FloatBitmap_t fBitmap) 
 	{ 
 		stBitmap.Delete(); this->stBitmap = fBitmap.ConverttoBitmap(); return *this; 
@@ -74,9 +104,9 @@ public:
 		stBitmap.Delete(); 
 	};
 	SIZE GetSize() { return stBitmap.GetSize(); }
-	int GetWidth() { return stBitmap.iWidth; }
-	int GetHeight() { return stBitmap.iHeight; }
-	int GetWidthBytes() { return stBitmap.iWidthBytes; }
+	int GetWidth() const { return stBitmap.iWidth; }
+	int GetHeight() const { return stBitmap.iHeight; }
+	int GetWidthBytes() const { return stBitmap.iWidthBytes; }
 	bool ApplyMaskGraphic(Sage::RawBitmap_t & stBackground,Sage::RawBitmap_t & stDest) { return stBitmap.ApplyMaskGraphic(stBackground,stDest); }
 	bool ApplyMaskGraphic(CSageBitmap & cBackground,CSageBitmap & cDest) { return stBitmap.ApplyMaskGraphic(*cBackground,*cDest); }
 		
@@ -126,7 +156,34 @@ public:
 	{
 		stBitmap = {};
 		CopyFrom(p2);
+		CountCopy();
+	}
+	CSageBitmap(CSageBitmap && p2) noexcept
+	{
+		stBitmap = p2.stBitmap;
+		p2.stBitmap = {};
+		GetCounters().iMoves.fetch_add(1,std::memory_order_relaxed);
+	}
+
+	// CopyStats_t -- Deep copies and moves made by CSageBitmap copy/move constructors and assignments (all threads),
+	// used to find where whole bitmaps are being copied in an image pipeline.
+
+	struct CopyStats_t
+	{
+		long long iCopies;			// Deep copies (each one a new allocation)
+		long long iBytesCopied;		// Pixel bytes copied by those copies
+		long long iMoves;			// Moves (no allocation or copy)
+	};
 
+	static CopyStats_t GetCopyStats()
+	{
+		auto & stCounters = GetCounters();
+		return { stCounters.iCopies.load(), stCounters.iBytesCopied.load(), stCounters.iMoves.load() };
+	}
+	static void ResetCopyStats()
+	{
+		auto & stCounters = GetCounters();
+		stCounters.iCopies = stCounters.iBytesCopied = stCounters.iMoves = 0;
 	}
 	bool isValid()
 	{
@@ -135,5 +192,73 @@ public:
 	operator unsigned char * () const { return stBitmap.stMem; };
 	operator Sage::RawBitmap_t & () const { return (Sage::RawBitmap_t &) stBitmap; };
 
+private:
+	struct Counters_t
+	{
+		std::atomic<long long> iCopies		{ 0 };
+		std::atomic<long long> iBytesCopied	{ 0 };
+		std::atomic<long long> iMoves		{ 0 };
+	};
+	static Counters_t & GetCounters() { static Counters_t stCounters; return stCounters; }
+	void CountCopy()
+	{
+		auto & stCounters = GetCounters();
+		stCounters.iCopies.fetch_add(1,std::memory_order_relaxed);
+		stCounters.iBytesCopied.fetch_add((long long) stBitmap.iWidthBytes*(stBitmap.iHeight < 0 ? -stBitmap.iHeight : stBitmap.iHeight),std::memory_order_relaxed);
+	}
+};
+
+// -------------------------------------------------------------
+// CSharedBitmap -- Copy-on-write, reference-counted CSageBitmap
+// -------------------------------------------------------------
+//
+// Copies of a CSharedBitmap share one CSageBitmap, so a bitmap can be handed to several stages of a pipeline without copying the pixels.
+// Read() gives access to the shared bitmap.  Write() first makes a private copy if the bitmap is shared, so writes never show up in other copies.
+//
+// CSageBitmap itself keeps its layout (it is used inside the SageBox library), so sharing is opt-in through this class:
+//
+//		CSharedBitmap cShared = cWin.ReadJpegFile("photo.jpg");		// Moved in -- no copy
+//		CSharedBitmap cCopy = cShared;								// Shared -- no copy
+//		cCopy.Write().FillColor(RGB(0,0,0));						// Copied here, once
+//
+class CSharedBitmap
+{
+	std::shared_ptr<CSageBitmap> m_spBitmap;
+public:
+	CSharedBitmap() { }
+	CSharedBitmap(CSageBitmap && cBitmap) : m_spBitmap(std::make_shared<CSageBitmap>(std::move(cBitmap))) { }
+	CSharedBitmap & operator = (CSageBitmap && cBitmap) { m_spBitmap = std::make_shared<CSageBitmap>(std::move(cBitmap)); return *this; }
+
+	// Read() -- The (possibly shared) bitmap.  Don't write to it; use Write() for that.
+
+	const CSageBitmap & Read() const
+	{
+		static const CSageBitmap cEmpty;
+		return m_spBitmap ? *m_spBitmap : cEmpty;
+	}
+
+	// Write() -- The bitmap, copied first if any other CSharedBitmap refers to it
+
+	CSageBitmap & Write()
+	{
+		if (!m_spBitmap) m_spBitmap = std::make_shared<CSageBitmap>();
+		else if (m_spBitmap.use_count() > 1) m_spBitmap = std::make_shared<CSageBitmap>(*m_spBitmap);
+		return *m_spBitmap;
+	}
+
+	// Detach() -- Move the bitmap out of the CSharedBitmap (copying it only if it is shared).  The CSharedBitmap is left empty.
+
+	CSageBitmap Detach()
+	{
+		CSageBitmap cBitmap;
+		if (m_spBitmap.use_count() > 1) cBitmap = *m_spBitmap;
+		else if (m_spBitmap) cBitmap = std::move(*m_spBitmap);
+		m_spBitmap.reset();
+		return cBitmap;
+	}
+
+	bool isShared() const { return m_spBitmap.use_count() > 1; }
+	bool isValid() const { return m_spBitmap && m_spBitmap->stBitmap.stMem != nullptr; }
+	void Delete() { m_spBitmap.reset(); }
 };
 #endif //_CRawBitmap_H_
\ No newline at end of file
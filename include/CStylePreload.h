@@ -0,0 +1,269 @@
+//#pragma once
+#if !defined(_CStylePreload_H_)
+#define _CStylePreload_H_
+
+// -------------------------------------------------------------
+// CStylePreload.H -- Read and decode control styles in parallel
+// -------------------------------------------------------------
+//
+// Loading a set of styles at startup with CDavinci::LoadButtonStyle() or CreateGraphicButtonStyle() reads each file from the
+// disk, then decodes its bitmaps and builds the style, one style after another.  CStylePreload splits this in two:
+//
+//		Start()		-- reads every style on a reader thread, and decodes what it can on the Core thread pool, in the background
+//		Register()	-- registers each style with CDavinci, in the order the styles were added, as soon as that style
+//					   is ready
+//
+// The reader thread only hands the pool one short job per graphic button style (one tile per state bitmap), so other users
+// of the pool aren't held up by the disk reads or by the whole preload.
+//
+// The styles are always registered in the same order (which decides which style wins when two have the same name) however
+// the background work finishes.  What runs in the background depends on the kind of style:
+//
+//		Graphic button styles (AddGraphicButtonStyle())	-- the state bitmaps (JPEG files) are read on the reader thread, then
+//														   decoded on the pool with Core::CJpegDecoder (see ReadJpeg() in
+//														   SageKernels.h), so only CreateGraphicButtonStyle() is left for Register()
+//		Style packs (AddButtonStyle(), AddBitmapStyle())	-- the PGR files are only read ahead.  Their bitmaps are decoded
+//														   inside LoadButtonStyle()/LoadBitmapStyle() on the thread calling
+//														   Register(), since the PGR readers and style builders are shared,
+//														   library-side code (i.e. the PGR decryption tables) and are not
+//														   safe to run on more than one thread at once.
+//
+// Example:
+//
+//		CStylePreload cPreload;
+//		cPreload.AddButtonStyle("styles\\Glass.pgr");
+//		cPreload.AddButtonStyle("styles\\Metal.pgr","MetalButton");
+//		cPreload.AddGraphicButtonStyle("RoundButton","styles\\Round.jpg","styles\\RoundHigh.jpg","styles\\RoundPressed.jpg");
+//		cPreload.Start();								// Reads and decodes start here...
+//
+//		... other startup work ...
+//
+//		cPreload.Register(*cWin.GetDavinci());			// ... and each style is built as soon as it is ready
+//
+#include <stdio.h>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "CDavinci.h"
+#include "SageKernels.h"
+#include "Core/CParallel.h"
+
+namespace Sage
+{
+class CStylePreload
+{
+public:
+	enum class StyleType
+	{
+		Button,				// CDavinci::LoadButtonStyle()
+		Bitmap,				// CDavinci::LoadBitmapStyle()
+		GraphicButton,		// CDavinci::CreateGraphicButtonStyle(), from decoded JPEG files
+	};
+
+	// Graphic button states, in the order of Sage::GraphicButtonStyle
+
+	enum ButtonState { Normal, High, Pressed, Disabled, StateCount };
+
+	struct Style_t
+	{
+		std::string sFile;
+		std::string sAltName;
+		StyleType eType;
+		std::vector<unsigned char> vData;		// The PGR file, once read
+		std::string sBitmaps[StateCount];		// GraphicButton: the JPEG file for each state (only Normal is required)
+		std::vector<unsigned char> vJpeg[StateCount];	// GraphicButton: the JPEG files, once read (until decoded)
+		CSageBitmap cBitmaps[StateCount];		// GraphicButton: the decoded bitmaps
+		bool bRead				= false;		// The style was read and decoded (false with bReady if it couldn't be)
+		bool bReady				= false;		// The background work is finished
+		char * sName			= nullptr;		// Registered style name, from LoadButtonStyle()/LoadBitmapStyle()
+	};
+
+private:
+	std::vector<Style_t> m_vStyles;
+	std::thread m_thRead;
+	bool m_bStarted		= false;
+	bool m_bRegistered	= false;
+	bool m_bResult		= false;			// Register()'s result, once registered
+	std::mutex m_mutexReady;
+	std::condition_variable m_cvReady;
+
+	// ReadFile() -- Read a whole file into memory
+
+	static bool ReadFile(const std::string & sFile,std::vector<unsigned char> & vData)
+	{
+		FILE * fp = fopen(sFile.c_str(),"rb");
+		if (!fp) return false;
+		fseek(fp,0,SEEK_END);
+		long iSize = ftell(fp);
+		fseek(fp,0,SEEK_SET);
+		vData.resize(iSize > 0 ? (size_t) iSize : 0);
+		bool bRead = iSize > 0 && fread(vData.data(),1,vData.size(),fp) == vData.size();
+		fclose(fp);
+		if (!bRead) vData.clear();
+		return bRead;
+	}
+
+	// ReadStyle() -- Read a PGR file, or the state bitmaps (JPEG files) of a graphic button style, into memory
+
+	static bool ReadStyle(Style_t & stStyle)
+	{
+		if (stStyle.eType != StyleType::GraphicButton) return ReadFile(stStyle.sFile,stStyle.vData);
+
+		for (int i=0;i<StateCount;i++)
+		{
+			if (!stStyle.sBitmaps[i].empty() && !ReadFile(stStyle.sBitmaps[i],stStyle.vJpeg[i])) return false;
+		}
+		return true;
+	}
+
+	// DecodeStyle() -- Decode the state bitmaps of a graphic button style on the pool, one tile per state.  Decodes that
+	// CJpegDecoder can't do (i.e. progressive JPEGs) fall back to Sage::CJpeg, which decodes one at a time.
+
+	static bool DecodeStyle(Style_t & stStyle,int iThreads)
+	{
+		bool bDecoded[StateCount] = {};
+		auto fTile = [&](int iState)
+		{
+			auto & vJpeg = stStyle.vJpeg[iState];
+			bDecoded[iState] = vJpeg.empty();
+			if (!vJpeg.empty()) stStyle.cBitmaps[iState] = Core::ReadJpeg(vJpeg.data(),(int) vJpeg.size(),&bDecoded[iState]);
+			std::vector<unsigned char>().swap(vJpeg);
+		};
+		Core::GetThreadPool().Run(StateCount,iThreads,fTile);
+
+		for (bool bState : bDecoded) if (!bState) return false;
+		return true;
+	}
+
+	// WaitReady() -- Wait for style iStyle's background work to finish
+
+	Style_t & WaitReady(int iStyle)
+	{
+		Style_t & stStyle = m_vStyles[iStyle];
+		std::unique_lock<std::mutex> lock(m_mutexReady);
+		m_cvReady.wait(lock,[&] { return stStyle.bReady; });
+		return stStyle;
+	}
+
+public:
+	CStylePreload() {}
+	~CStylePreload() { Wait(); }
+
+	CStylePreload(const CStylePreload &) = delete;
+	CStylePreload & operator = (const CStylePreload &) = delete;
+
+	// AddButtonStyle(), AddBitmapStyle() -- Add a style pack to load.  Styles must be added before Start().
+
+	void AddButtonStyle(const char * sFile,const char * sAltName = nullptr) { AddStyle(StyleType::Button,sFile,sAltName); }
+	void AddBitmapStyle(const char * sFile,const char * sAltName = nullptr) { AddStyle(StyleType::Bitmap,sFile,sAltName); }
+	void AddStyle(StyleType eType,const char * sFile,const char * sAltName = nullptr)
+	{
+		if (m_bStarted || !sFile || !*sFile) return;
+		Style_t stStyle;
+		stStyle.sFile		= sFile;
+		stStyle.sAltName	= sAltName ? sAltName : "";
+		stStyle.eType		= eType;
+		m_vStyles.push_back(std::move(stStyle));
+	}
+
+	// AddGraphicButtonStyle() -- Add a graphic button style named sStyleName, from a JPEG file for each state.
+	// Only sNormal is required.  The files are decoded in the background, and registered with CreateGraphicButtonStyle().
+	//
+	void AddGraphicButtonStyle(const char * sStyleName,const char * sNormal,const char * sHigh = nullptr,const char * sPressed = nullptr,
+							   const char * sDisabled = nullptr)
+	{
+		if (m_bStarted || !sStyleName || !*sStyleName || !sNormal || !*sNormal) return;
+		Style_t stStyle;
+		stStyle.sFile		= sNormal;
+		stStyle.sAltName	= sStyleName;
+		stStyle.eType		= StyleType::GraphicButton;
+
+		const char * sFiles[StateCount] = { sNormal, sHigh, sPressed, sDisabled };
+		for (int i=0;i<StateCount;i++) if (sFiles[i]) stStyle.sBitmaps[i] = sFiles[i];
+		m_vStyles.push_back(std::move(stStyle));
+	}
+
+	// Start() -- Start reading the styles on a reader thread, decoding the graphic button styles on up to iThreads threads of the
+	// pool (0 = all threads in the pool).  The styles are only read once: calling Start() again does nothing.
+
+	void Start(int iThreads = 0)
+	{
+		if (m_bStarted || m_vStyles.empty()) return;
+		m_bStarted = true;
+		iThreads = Core::GetThreadCount(iThreads);
+
+		m_thRead = std::thread([this,iThreads]
+		{
+			for (auto & stStyle : m_vStyles)
+			{
+				bool bRead = ReadStyle(stStyle);
+				if (bRead && stStyle.eType == StyleType::GraphicButton) bRead = DecodeStyle(stStyle,iThreads);
+				{
+					std::lock_guard<std::mutex> lock(m_mutexReady);
+					stStyle.bRead	= bRead;
+					stStyle.bReady	= true;
+				}
+				m_cvReady.notify_all();
+			}
+		});
+	}
+
+	// Register() -- Register each style in the order added, with fRegister(Style_t &) returning the style name (or nullptr
+	// on failure).  Start() is called first if it hasn't been.  Returns false if any style couldn't be read, decoded or registered.
+	// The styles are only registered once: calling Register() again returns the first result.
+	//
+	template <class _t>
+	bool Register(_t fRegister)
+	{
+		if (m_bRegistered) return m_bResult;
+		Start();
+		bool bResult = true;
+		for (int i=0;i<(int) m_vStyles.size();i++)
+		{
+			Style_t & stStyle = WaitReady(i);
+			stStyle.sName = stStyle.bRead ? fRegister(stStyle) : nullptr;
+			if (!stStyle.sName) bResult = false;
+
+			std::vector<unsigned char>().swap(stStyle.vData);		// The PGR and bitmaps aren't needed once the style is built
+			for (auto & cBitmap : stStyle.cBitmaps) cBitmap.Delete();
+		}
+		Wait();
+		m_bRegistered	= true;
+		m_bResult		= bResult;
+		return bResult;
+	}
+
+	// Register() -- Register each style with CDavinci::LoadButtonStyle(), LoadBitmapStyle() or CreateGraphicButtonStyle(), in the
+	// order added
+
+	bool Register(CDavinci & cDavinci)
+	{
+		return Register([&](Style_t & stStyle) -> char *
+		{
+			char * sAltName = stStyle.sAltName.empty() ? nullptr : (char *) stStyle.sAltName.c_str();
+			if (stStyle.eType == StyleType::GraphicButton)
+			{
+				GraphicButtonStyle stButton = {};
+				RawBitmap_t * stStates[StateCount] = { &stButton.stNormal, &stButton.stHigh, &stButton.stPressed, &stButton.stDisabled };
+				for (int i=0;i<StateCount;i++) if (stStyle.cBitmaps[i].isValid()) *stStates[i] = *stStyle.cBitmaps[i];
+				return cDavinci.CreateGraphicButtonStyle(sAltName,stButton) ? sAltName : nullptr;
+			}
+			return stStyle.eType == StyleType::Button ? cDavinci.LoadButtonStyle(stStyle.vData.data(),(int) stStyle.vData.size(),sAltName) :
+														cDavinci.LoadBitmapStyle(stStyle.vData.data(),(int) stStyle.vData.size(),sAltName);
+		});
+	}
+
+	// Wait() -- Wait for the background work to finish (i.e. before destroying the object without calling Register())
+
+	void Wait() { if (m_thRead.joinable()) m_thRead.join(); }
+
+	int GetStyleCount() const { return (int) m_vStyles.size(); }
+
+	// GetStyleName() -- The registered name of style iStyle (in the order added), or nullptr if it wasn't registered
+
+	char * GetStyleName(int iStyle) const { return iStyle >= 0 && iStyle < (int) m_vStyles.size() ? m_vStyles[iStyle].sName : nullptr; }
+};
+}; // namespace Sage
+#endif // _CStylePreload_H_
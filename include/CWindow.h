@@ -491,6 +491,10 @@ public:
     CWindow();                        // Constructor.  Should only be used by CDavinci or CWindow.
 
     int GetControlID();                 // Return internal control ID - $$ move to private
+
+    // GetDavinci() -- The CDavinci object the window was created from (i.e. to register styles with CStylePreload)
+    //
+    CDavinci * GetDavinci() { return m_cDavinciMain; }
     
     // WinMessageBox() -- Bring up a standard Windows Message Box. 
     //
@@ -0,0 +1,236 @@
+//#pragma once
+#if !defined(_CWindowEvents_H_)
+#define _CWindowEvents_H_
+
+// -------------------------------------------------------------------
+// CWindowEvents.H -- A window's events as a queue, with blocking wait
+// -------------------------------------------------------------------
+//
+// WaitforEvent() and EventLoop() wake up on an event and leave flags behind for MouseClicked(), button().Pressed(),
+// MenuItemSelected(), etc. to poll -- two clicks (or two buttons) between polls are one flag, and the position and time of the
+// event is what it is when it is polled.  CWindowEvents puts each event in a Core::CEventQueue (see Core/CEventQueue.h) as it
+// happens, with its type, control or menu ID, mouse position, key, and time:
+//
+//		CWindowEvents cEvents;
+//		cEvents.Attach(cWin);							// Mouse, keys, menus, and the window closing
+//		cEvents.Attach(cWin.NewButton(10,10,"OK",ID(1)));	// Button presses, with the button's ID
+//		cEvents.Attach(cWin.NewSlider(10,50,ID(2)));		// Slider moves
+//
+//		Core::Event_t stEvent;
+//		while (cEvents.Wait(stEvent))					// Sleeps until there is an event; false once the window closes
+//		{
+//			if (stEvent.eType == Core::EventType::ButtonPressed && stEvent.iID == 1) ...
+//			if (stEvent.eType == Core::EventType::LButtonDown) DrawCircle(stEvent.iX,stEvent.iY,...);
+//		}
+//
+// Wait() uses no CPU while there are no events, and returns as soon as one is posted.  Events are posted from the window's
+// message handlers (SetMessageHandler()), which return MsgStatus::Ok, so the usual flags are still set and polling still
+// works alongside the queue.  Attach() replaces any message handler already set for the window or control.
+//
+// High-rate events (mouse moves, the wheel, slider moves) can be taken in batches, merged -- see Core/CEventQueue.h:
+//
+//		cEvents.SetCoalesce(true);
+//		std::vector<Core::Event_t> vEvents;
+//		while (cEvents.WaitBatch(vEvents))				// Every pending event, with runs of mouse moves, etc. merged
+//		{
+//			for (auto & stEvent : vEvents) ...
+//			vEvents.clear();
+//		}
+//
+// Other threads can Post() events (i.e. EventType::User) to wake the event thread.  Only one thread should call Wait() and Get().
+//
+// Lifetime: the window and controls keep pointers to the message handlers, and SageBox has no way to remove a handler.  So the
+// handlers don't belong to the CWindowEvents -- they hold the queue themselves, and when the CWindowEvents is destroyed first,
+// they stop posting and are handed to the attached window, which deletes them when it is destroyed.  Controls should be on the
+// attached window (as above).  If no window was attached, the handlers are left allocated, since the controls may still use them.
+// For the same reason, a CWindowEvents takes events from one window: Attach() ignores a second window (use a CWindowEvents for
+// each window).
+//
+#include "CSageBox.h"
+#include "Core/CEventQueue.h"
+#include <memory>
+#include <vector>
+
+namespace Sage
+{
+class CWindowEvents
+{
+private:
+	// The message handlers -- each posts its events to the queue and lets processing continue as usual
+
+	typedef std::shared_ptr<Core::CEventQueue> spQueue_t;
+
+	// PostOpen() -- Post an event unless the queue is closed (the window is gone, or the CWindowEvents was destroyed)
+
+	static void PostOpen(Core::CEventQueue & cQueue,const Core::Event_t & stEvent) { if (!cQueue.isClosed()) cQueue.Post(stEvent); }
+
+	class CWinEvents : public CWindowHandler
+	{
+	private:
+		spQueue_t m_spQueue;
+		MsgStatus Post(Core::EventType eType,int iX = 0,int iY = 0,int iKey = 0,int iID = 0,int iDelta = 0)
+		{
+			Core::Event_t stEvent {};
+			stEvent.eType = eType; stEvent.iX = iX; stEvent.iY = iY; stEvent.iKey = iKey; stEvent.iID = iID; stEvent.iDelta = iDelta;
+			PostOpen(*m_spQueue,stEvent);
+			return MsgStatus::Ok;
+		}
+	public:
+		CWinEvents(const spQueue_t & spQueue) : m_spQueue(spQueue) { }
+		MsgStatus OnLButtonDown(int iMouseX,int iMouseY) override		{ return Post(Core::EventType::LButtonDown,iMouseX,iMouseY);	}
+		MsgStatus OnLButtonUp(int iMouseX,int iMouseY) override			{ return Post(Core::EventType::LButtonUp,iMouseX,iMouseY);		}
+		MsgStatus OnRButtonDown(int iMouseX,int iMouseY) override		{ return Post(Core::EventType::RButtonDown,iMouseX,iMouseY);	}
+		MsgStatus OnRButtonUp(int iMouseX,int iMouseY) override			{ return Post(Core::EventType::RButtonUp,iMouseX,iMouseY);		}
+		MsgStatus OnMouseMove(int iMouseX,int iMouseY) override			{ return Post(Core::EventType::MouseMove,iMouseX,iMouseY);		}
+		MsgStatus OnMouseWheel(int iDelta,int iX,int iY) override		{ return Post(Core::EventType::MouseWheel,iX,iY,0,0,iDelta);	}
+		MsgStatus OnControlKey(Sage::ControlKey key,int iCount) override	{ return Post(Core::EventType::ControlKey,0,0,(int) key);		}
+		MsgStatus OnChar(char cChar,int iCount) override				{ return Post(Core::EventType::Char,0,0,(unsigned char) cChar);	}
+		MsgStatus OnMenu(int iMenuID) override							{ return Post(Core::EventType::Menu,0,0,0,iMenuID);				}
+		MsgStatus OnClose() override									{ return Post(Core::EventType::WindowClosing);					}
+	};
+
+	class CButtonEvents : public CButtonHandler
+	{
+	private:
+		spQueue_t m_spQueue;
+		int m_iID;
+		MsgStatus Post(Core::EventType eType)
+		{
+			Core::Event_t stEvent {};
+			stEvent.eType = eType; stEvent.iID = m_iID;
+			PostOpen(*m_spQueue,stEvent);
+			return MsgStatus::Ok;
+		}
+	public:
+		CButtonEvents(const spQueue_t & spQueue,int iID) : m_spQueue(spQueue), m_iID(iID) { }
+		MsgStatus OnPressed() override			{ return Post(Core::EventType::ButtonPressed);		}
+		MsgStatus OnUnPressed() override		{ return Post(Core::EventType::ButtonUnpressed);	}
+	};
+
+	class CSliderEvents : public CSliderHandler
+	{
+	private:
+		spQueue_t m_spQueue;
+		int m_iID;
+	public:
+		CSliderEvents(const spQueue_t & spQueue,int iID) : m_spQueue(spQueue), m_iID(iID) { }
+		MsgStatus OnPosChange(int iPos,int iOldPos) override
+		{
+			Core::Event_t stEvent {};
+			stEvent.eType = Core::EventType::SliderMoved; stEvent.iID = m_iID; stEvent.iValue = iPos; stEvent.iDelta = iPos - iOldPos;
+			PostOpen(*m_spQueue,stEvent);
+			return MsgStatus::Ok;
+		}
+	};
+
+	// The handlers set on the window and controls -- handed to the window if the CWindowEvents is destroyed first
+
+	struct Handlers_t
+	{
+		std::unique_ptr<CWinEvents> cWinEvents;
+		std::vector<std::unique_ptr<CButtonEvents>> vButtonEvents;
+		std::vector<std::unique_ptr<CSliderEvents>> vSliderEvents;
+
+		bool isEmpty() const { return !cWinEvents && vButtonEvents.empty() && vSliderEvents.empty(); }
+	};
+
+	spQueue_t m_spQueue = std::make_shared<Core::CEventQueue>();
+	bool m_bCoalesce = false;
+	CWindow * m_cWin = nullptr;					// The window, while attached as a deleter (to close the queue when it is destroyed)
+	bool m_bWinDestroyed = false;				// The attached window was destroyed (with its controls)
+	std::unique_ptr<Handlers_t> m_stHandlers = std::make_unique<Handlers_t>();
+
+	// WindowDestroyed() -- Called by the window as it is destroyed (see CWindow::AttachDeleter())
+
+	static void WindowDestroyed(void * pEvents)
+	{
+		CWindowEvents * cEvents = (CWindowEvents *) pEvents;
+		cEvents->m_cWin = nullptr;
+		cEvents->m_bWinDestroyed = true;
+		cEvents->m_spQueue->Close();
+	}
+
+	// DeleteHandlers() -- Called by the window as it is destroyed, for handlers handed to it by ~CWindowEvents()
+
+	static void DeleteHandlers(void * pHandlers) { delete (Handlers_t *) pHandlers; }
+
+public:
+	CWindowEvents() = default;
+
+	// ~CWindowEvents() -- Closes the queue, so the handlers stop posting, and hands the handlers to the window (see Lifetime, above)
+
+	~CWindowEvents()
+	{
+		m_spQueue->Close();
+		if (m_cWin)
+		{
+			m_cWin->RemoveDeleter(this);
+			m_cWin->AttachDeleter(m_stHandlers.release(),DeleteHandlers);
+		}
+		else if (!m_bWinDestroyed && !m_stHandlers->isEmpty()) m_stHandlers.release();		// No window to hand them to
+	}
+
+	CWindowEvents(const CWindowEvents &) = delete;
+	CWindowEvents & operator = (const CWindowEvents &) = delete;
+
+	// Attach() -- Post events from a window or control.  A window closes the queue when it is destroyed (Wait() then returns
+	// false once the remaining events are taken).  Returns the window or control, so it can wrap the New...() call.
+	//
+	// Only one window can be attached -- it is the one the handlers are handed to -- so a second window (or any window once the
+	// attached one was destroyed) is returned without being attached.  See isAttached().
+	//
+	CWindow & Attach(CWindow & cWin)
+	{
+		if (m_cWin || m_bWinDestroyed) return cWin;		// Already attached, or a second window
+
+		m_stHandlers->cWinEvents = std::make_unique<CWinEvents>(m_spQueue);
+		cWin.SetMessageHandler(m_stHandlers->cWinEvents.get());
+		m_cWin = &cWin;
+		m_cWin->AttachDeleter(this,WindowDestroyed);
+		return cWin;
+	}
+	CButton & Attach(CButton & cButton)
+	{
+		m_stHandlers->vButtonEvents.push_back(std::make_unique<CButtonEvents>(m_spQueue,cButton.GetID()));
+		cButton.SetMessageHandler(m_stHandlers->vButtonEvents.back().get());
+		return cButton;
+	}
+	CSlider & Attach(CSlider & cSlider)
+	{
+		m_stHandlers->vSliderEvents.push_back(std::make_unique<CSliderEvents>(m_spQueue,cSlider.GetID()));
+		cSlider.SetMessageHandler(m_stHandlers->vSliderEvents.back().get());
+		return cSlider;
+	}
+
+	// Wait() -- The next event, waiting up to iTimeoutMS (-1 to wait until there is one).  Returns false on a time-out, or
+	// once the window is destroyed and the queue is empty.
+	//
+	bool Wait(Core::Event_t & stEvent,int iTimeoutMS = -1) { return m_spQueue->Wait(stEvent,iTimeoutMS); }
+
+	// Get() -- The next event if there is one, without waiting
+	//
+	bool Get(Core::Event_t & stEvent) { return m_spQueue->Get(stEvent); }
+
+	// GetBatch(), WaitBatch() -- Every pending event, added to vEvents, coalesced if SetCoalesce(true) was called.  WaitBatch()
+	// waits for the first event as Wait() does.  Both return the number of events added.
+	//
+	int GetBatch(std::vector<Core::Event_t> & vEvents)						{ return m_spQueue->GetBatch(vEvents,m_bCoalesce);				}
+	int WaitBatch(std::vector<Core::Event_t> & vEvents,int iTimeoutMS = -1)	{ return m_spQueue->WaitBatch(vEvents,m_bCoalesce,iTimeoutMS);	}
+
+	// SetCoalesce() -- Merge runs of mouse moves, wheel and slider events in GetBatch() and WaitBatch() (off by default)
+	//
+	void SetCoalesce(bool bCoalesce = true) { m_bCoalesce = bCoalesce; }
+	bool isCoalesce() const { return m_bCoalesce; }
+
+	// Post() -- Post an event from any thread (i.e. EventType::User from a worker thread)
+	//
+	void Post(const Core::Event_t & stEvent) { m_spQueue->Post(stEvent); }
+
+	// isAttached() -- true if cWin is the attached window
+
+	bool isAttached(const CWindow & cWin) const { return m_cWin == &cWin; }
+
+	Core::CEventQueue & GetQueue() { return *m_spQueue; }
+};
+}; // namespace Sage
+#endif // _CWindowEvents_H_
@@ -0,0 +1,88 @@
+//#pragma once
+#if !defined(_CWindowRender_H_)
+#define _CWindowRender_H_
+
+// ----------------------------------------------------------
+// CWindowRender.H -- CRenderBackend for drawing to a CWindow
+// ----------------------------------------------------------
+//
+// CWindowRender is the CRenderBackend (see Core/CRenderBackend.h) that draws to a window with its usual drawing functions.
+// Drawing code written against Core::CRenderBackend can then draw to a window, or to memory with Core::CSoftRender
+// (Core/CSoftRender.h) -- i.e. to run headless, in tests, or on a server:
+//
+//		void DrawScene(Core::CRenderBackend & cRender);
+//
+//		CWindowRender cWinRender(cWin);
+//		DrawScene(cWinRender);								// To the window
+//
+//		Core::CSoftRender cSoftRender(Core::toCore(stBitmap32));
+//		DrawScene(cSoftRender);								// To a RawBitmap32_t
+//
+// Core bitmaps have their top row first in memory (see Core/CRenderBackend.h), so they are displayed right side up (i.e.
+// DisplayBitmapR() for 24-bit bitmaps).  24-bit bitmaps must have rows padded to 4 bytes, as with DisplayBitmap().
+// BlendBitmap() takes a RawBitmap32_t, which is bottom-up, so the rows are flipped into a buffer first.
+//
+#include "CSageBox.h"
+#include "Core/CRenderBackend.h"
+#include <string.h>
+#include <vector>
+
+namespace Sage
+{
+class CWindowRender : public Core::CRenderBackend
+{
+private:
+	CWindow & m_cWin;
+
+	std::vector<POINT> m_vPoints;		// Polygon vertices as POINT
+	std::vector<unsigned char> m_vFlip;	// BlendBitmap() rows, bottom-up (kept to avoid allocating per call)
+
+	static POINT toPoint(Core::Point_t pPoint) { return { pPoint.x, pPoint.y }; }
+
+public:
+	CWindowRender(CWindow & cWin) : m_cWin(cWin) { }
+
+	Core::Size_t GetSize() override { SIZE szSize = m_cWin.GetWindowSize(); return { (int) szSize.cx, (int) szSize.cy }; }
+
+	bool SetPenThickness(int iThickness) override									{ return m_cWin.SetPenThickness(iThickness);					}
+	bool SetPixel(int iX,int iY,Core::Color_t rgbColor) override					{ return m_cWin.SetPixel(iX,iY,(DWORD) rgbColor);				}
+	bool DrawLine(int ix1,int iy1,int ix2,int iy2,int iColor) override				{ return m_cWin.DrawLine(ix1,iy1,ix2,iy2,iColor);				}
+	bool DrawRectangle(int iX,int iY,int iWidth,int iHeight,int iColor,int iColor2 = -1) override	{ return m_cWin.DrawRectangle(iX,iY,iWidth,iHeight,iColor,iColor2);	}
+	bool DrawCircle(int iX,int iY,int iRadius,int iColor,int iColor2 = -1) override	{ return m_cWin.DrawCircle(iX,iY,iRadius,iColor,iColor2);		}
+	bool DrawPolygon(const Core::Point_t * pPoints,int iVertices,int iColor,int iColor2 = -1) override
+	{
+		if (!pPoints || iVertices < 1) return false;
+		m_vPoints.resize(iVertices);
+		for (int i=0;i<iVertices;i++) m_vPoints[i] = toPoint(pPoints[i]);
+		return m_cWin.DrawPolygon(m_vPoints.data(),iVertices,iColor,iColor2);
+	}
+	bool DrawTriangle(Core::Point_t v1,Core::Point_t v2,Core::Point_t v3,int iColor,int iColor2 = -1) override
+	{
+		return m_cWin.DrawTriangle(toPoint(v1),toPoint(v2),toPoint(v3),iColor,iColor2);
+	}
+	void Cls(int iColor1 = -1,int iColor2 = -1) override { m_cWin.Cls((DWORD) iColor1,(DWORD) iColor2); }
+
+	bool DisplayBitmap(int iX,int iY,const Core::Bitmap_t & stBitmap) override
+	{
+		if (!stBitmap.isValid() || stBitmap.iWidthBytes != Core::WidthBytes24(stBitmap.iWidth)) return false;
+		return m_cWin.DisplayBitmapR(iX,iY,stBitmap.iWidth,stBitmap.iHeight,stBitmap.stMem);
+	}
+	bool DisplayBitmap(int iX,int iY,const Core::Bitmap32_t & stBitmap) override
+	{
+		if (!stBitmap.isValid() || stBitmap.iWidthBytes != stBitmap.iWidth*4) return false;
+		return m_cWin.DisplayBitmap32(iX,iY,stBitmap.iWidth,-stBitmap.iHeight,stBitmap.stMem);		// Negative height: top row first
+	}
+	bool BlendBitmap(int iX,int iY,const Core::Bitmap32_t & stBitmap) override
+	{
+		if (!stBitmap.isValid() || stBitmap.iWidthBytes != stBitmap.iWidth*4) return false;
+		int iTotalSize = stBitmap.iWidthBytes*stBitmap.iHeight;
+		m_vFlip.resize(iTotalSize);
+		for (int y=0;y<stBitmap.iHeight;y++)
+			memcpy(m_vFlip.data() + (size_t) (stBitmap.iHeight - 1 - y)*stBitmap.iWidthBytes,stBitmap.Row(y),stBitmap.iWidthBytes);
+
+		RawBitmap32_t stRaw = { stBitmap.iWidth, stBitmap.iHeight, stBitmap.iWidthBytes, iTotalSize, m_vFlip.data(), (RGBColor32 *) m_vFlip.data() };
+		return m_cWin.BlendBitmap(iX,iY,stRaw);
+	}
+};
+}; // namespace Sage
+#endif // _CWindowRender_H_
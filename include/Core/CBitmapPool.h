@@ -0,0 +1,259 @@
+//#pragma once
+#if !defined(_CBitmapPool_H_)
+#define _CBitmapPool_H_
+
+// ------------------------------------------------------
+// CBitmapPool.H -- Pooled, 64-byte aligned bitmap memory
+// ------------------------------------------------------
+//
+// Animation and compositing loops often create and delete scratch bitmaps of the same size every frame.
+// CBitmapPool keeps released bitmap memory in a per-thread cache, grouped by size class, so the next request of a similar size
+// is handed back without going to malloc().  There are no locks: each thread has its own cache.
+//
+// Memory can be released from any thread -- it goes into the releasing thread's cache.  Each thread's cache is freed when the thread exits,
+// or on demand with CBitmapPool::Trim().
+//
+// The cache is capped per thread (64MB by default, SetMaxBytes()) and across all threads together (256MB by default,
+// SetMaxTotalBytes()), so a pool of worker threads releasing bitmaps can't hold more than the total between them.  Blocks
+// released over either cap are freed.
+//
+// All blocks are 64-byte aligned.  Bitmaps created with CreatePooledBitmap() also have rows padded to 64 bytes, so every row
+// starts on a cache-line (and AVX) boundary.
+//
+// Important: pooled memory must go back through CBitmapPool::Release() (or ReleasePooledBitmap()), never free().
+//
+// Hit/miss counters are kept for all threads and can be read with CBitmapPool::GetStats().
+//
+#include <atomic>
+#include "SageCore.h"
+
+namespace Sage
+{
+namespace Core
+{
+	struct BitmapPoolStats_t
+	{
+		long long iHits;				// Requests served from the cache
+		long long iMisses;				// Requests that went to malloc()
+		long long iReleased;			// Blocks returned to the cache
+		long long iFreed;				// Blocks freed on release because the cache was full
+		long long iCachedBytes;			// Memory held in the caches of all threads
+	};
+
+	class CBitmapPool
+	{
+	public:
+		static constexpr int kAlign					= 64;
+		static constexpr int kMaxPerClass			= 8;					// Most blocks kept for any one size class, per thread
+		static constexpr size_t kDefaultMaxBytes		= 64*1024*1024;		// Most memory kept in the cache, per thread
+		static constexpr size_t kDefaultMaxTotalBytes	= 256*1024*1024;	// Most memory kept in the caches of all threads together
+
+	private:
+		static constexpr int kClasses = 4*48;		// 4 classes per power of two (at most 25% over the requested size), up to 2^48 bytes
+
+		// Header_t -- stored in the 64 bytes in front of each block
+
+		struct Header_t
+		{
+			void * pAllocation;		// Pointer returned by malloc()
+			Header_t * stNext;		// Next block in the free list
+			size_t iSize;			// Usable size of the block (the size class)
+			int iClass;
+		};
+		static_assert(sizeof(Header_t) <= kAlign,"CBitmapPool header must fit in the alignment padding");
+
+		struct Stats_t
+		{
+			std::atomic<long long> iHits			{ 0 };
+			std::atomic<long long> iMisses			{ 0 };
+			std::atomic<long long> iReleased		{ 0 };
+			std::atomic<long long> iFreed			{ 0 };
+			std::atomic<size_t> iMaxBytes			{ kDefaultMaxBytes };
+			std::atomic<size_t> iMaxTotalBytes		{ kDefaultMaxTotalBytes };
+			std::atomic<size_t> iTotalCachedBytes	{ 0 };
+		};
+
+		static Stats_t & GetGlobals() { static Stats_t stStats; return stStats; }
+
+		struct ThreadCache_t
+		{
+			Header_t * stFree[kClasses]	= {};
+			int iCount[kClasses]		= {};
+			size_t iCachedBytes			= 0;
+
+			~ThreadCache_t() { Trim(); }
+			void Trim()
+			{
+				for (int i=0;i<kClasses;i++)
+				{
+					while (stFree[i])
+					{
+						Header_t * stNext = stFree[i]->stNext;
+						free(stFree[i]->pAllocation);
+						stFree[i] = stNext;
+					}
+					iCount[i] = 0;
+				}
+				GetGlobals().iTotalCachedBytes.fetch_sub(iCachedBytes,std::memory_order_relaxed);
+				iCachedBytes = 0;
+			}
+		};
+
+		static ThreadCache_t & GetCache() { thread_local ThreadCache_t stCache; return stCache; }
+
+		// GetClass() -- Size class for iSize, and the (rounded-up) size of that class
+
+		static int GetClass(size_t iSize,size_t & iClassSize)
+		{
+			if (iSize < kAlign) iSize = kAlign;
+
+			int iPower = 0;
+			while (((size_t) 1 << (iPower+1)) <= iSize) iPower++;
+
+			// Split each power of two into 4 steps
+
+			size_t iStep	= iPower >= 2 ? ((size_t) 1 << (iPower-2)) : 1;
+			size_t iBase	= (size_t) 1 << iPower;
+			int iSub		= (int) ((iSize - iBase + iStep - 1)/iStep);		// 0-4; 4 rolls into the next power
+
+			iClassSize = iBase + iStep*iSub;
+			return iPower*4 + iSub;
+		}
+
+	public:
+
+		// Alloc() -- Get a 64-byte aligned block of at least iSize bytes, from the cache if possible.  Returns nullptr on failure.
+
+		static void * Alloc(size_t iSize)
+		{
+			size_t iClassSize;
+			int iClass = GetClass(iSize,iClassSize);
+			if (iClass >= kClasses) return nullptr;
+
+			auto & stCache = GetCache();
+			if (Header_t * stBlock = stCache.stFree[iClass])
+			{
+				stCache.stFree[iClass] = stBlock->stNext;
+				stCache.iCount[iClass]--;
+				stCache.iCachedBytes -= stBlock->iSize;
+				GetGlobals().iTotalCachedBytes.fetch_sub(stBlock->iSize,std::memory_order_relaxed);
+				GetGlobals().iHits.fetch_add(1,std::memory_order_relaxed);
+				return (unsigned char *) stBlock + kAlign;
+			}
+
+			GetGlobals().iMisses.fetch_add(1,std::memory_order_relaxed);
+
+			// Allocate room for the header plus alignment, then place the header just in front of the aligned block
+
+			void * pAllocation = malloc(iClassSize + 2*kAlign);
+			if (!pAllocation) return nullptr;
+
+			size_t iAligned = ((size_t) pAllocation + kAlign - 1) & ~((size_t) kAlign - 1);
+			Header_t * stBlock = (Header_t *) iAligned;
+			stBlock->pAllocation	= pAllocation;
+			stBlock->stNext			= nullptr;
+			stBlock->iSize			= iClassSize;
+			stBlock->iClass			= iClass;
+			return (unsigned char *) stBlock + kAlign;
+		}
+
+		// Release() -- Return a block from Alloc() to this thread's cache (or free it if this thread's cache or the total is full).
+		// nullptr is ignored.
+
+		static void Release(void * pMem)
+		{
+			if (!pMem) return;
+
+			Header_t * stBlock = (Header_t *) ((unsigned char *) pMem - kAlign);
+			auto & stCache = GetCache();
+			auto & stGlobals = GetGlobals();
+
+			bool bFull = stCache.iCount[stBlock->iClass] >= kMaxPerClass || stCache.iCachedBytes + stBlock->iSize > stGlobals.iMaxBytes.load(std::memory_order_relaxed);
+
+			// Reserve room in the total first, so threads releasing at the same time can't go over it together
+
+			if (!bFull && stGlobals.iTotalCachedBytes.fetch_add(stBlock->iSize,std::memory_order_relaxed) + stBlock->iSize > stGlobals.iMaxTotalBytes.load(std::memory_order_relaxed))
+			{
+				stGlobals.iTotalCachedBytes.fetch_sub(stBlock->iSize,std::memory_order_relaxed);
+				bFull = true;
+			}
+			if (bFull)
+			{
+				stGlobals.iFreed.fetch_add(1,std::memory_order_relaxed);
+				free(stBlock->pAllocation);
+				return;
+			}
+			stBlock->stNext = stCache.stFree[stBlock->iClass];
+			stCache.stFree[stBlock->iClass] = stBlock;
+			stCache.iCount[stBlock->iClass]++;
+			stCache.iCachedBytes += stBlock->iSize;
+			stGlobals.iReleased.fetch_add(1,std::memory_order_relaxed);
+		}
+
+		// Trim() -- Free everything in the calling thread's cache
+
+		static void Trim() { GetCache().Trim(); }
+
+		// SetMaxBytes() -- Set the most memory each thread's cache may hold (default 64MB).  Use 0 to turn caching off.
+
+		static void SetMaxBytes(size_t iMaxBytes) { GetGlobals().iMaxBytes.store(iMaxBytes,std::memory_order_relaxed); }
+
+		// SetMaxTotalBytes() -- Set the most memory the caches of all threads may hold together (default 256MB).
+		// Lowering it doesn't free what is already cached -- it takes effect as blocks are released.
+
+		static void SetMaxTotalBytes(size_t iMaxBytes) { GetGlobals().iMaxTotalBytes.store(iMaxBytes,std::memory_order_relaxed); }
+
+		// GetStats() -- Hit/miss counters for all threads since the start (or the last ResetStats())
+
+		static BitmapPoolStats_t GetStats()
+		{
+			auto & stGlobals = GetGlobals();
+			return { stGlobals.iHits.load(), stGlobals.iMisses.load(), stGlobals.iReleased.load(), stGlobals.iFreed.load(),
+					 (long long) stGlobals.iTotalCachedBytes.load() };
+		}
+
+		static void ResetStats()
+		{
+			auto & stGlobals = GetGlobals();
+			stGlobals.iHits = stGlobals.iMisses = stGlobals.iReleased = stGlobals.iFreed = 0;
+		}
+
+		// GetCachedBytes() -- Memory held by the calling thread's cache
+
+		static size_t GetCachedBytes() { return GetCache().iCachedBytes; }
+	};
+
+	// CreatePooledBitmap() -- Create a 24-bit bitmap from the pool, with rows padded to 64 bytes.
+	// Release it with ReleasePooledBitmap() -- not DeleteBitmap().
+	//
+	inline Bitmap_t CreatePooledBitmap(int iWidth,int iHeight,bool bWithMask = false)
+	{
+		Bitmap_t stBitmap = {};
+		if (iWidth <= 0 || iHeight <= 0) return stBitmap;
+
+		int iWidthBytes = (iWidth*3 + CBitmapPool::kAlign - 1) & ~(CBitmapPool::kAlign - 1);
+		stBitmap.stMem = (unsigned char *) CBitmapPool::Alloc((size_t) iWidthBytes*iHeight);
+		if (!stBitmap.stMem) return stBitmap;
+		if (bWithMask)
+		{
+			stBitmap.sMask = (unsigned char *) CBitmapPool::Alloc((size_t) iWidth*iHeight);
+			if (!stBitmap.sMask) { CBitmapPool::Release(stBitmap.stMem); stBitmap.stMem = nullptr; return stBitmap; }
+		}
+		stBitmap.iWidth			= iWidth;
+		stBitmap.iHeight		= iHeight;
+		stBitmap.iWidthBytes	= iWidthBytes;
+		return stBitmap;
+	}
+
+	// ReleasePooledBitmap() -- Return a bitmap from CreatePooledBitmap() to the pool and clear the structure
+
+	inline void ReleasePooledBitmap(Bitmap_t & stBitmap)
+	{
+		CBitmapPool::Release(stBitmap.stMem);
+		CBitmapPool::Release(stBitmap.sMask);
+		stBitmap = {};
+	}
+
+}; // namespace Core
+}; // namespace Sage
+#endif // _CBitmapPool_H_
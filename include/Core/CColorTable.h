@@ -0,0 +1,267 @@
+//#pragma once
+#if !defined(_CColorTable_H_)
+#define _CColorTable_H_
+
+// ------------------------------------------------------------
+// CColorTable.H -- Named colors: stock and user-defined colors
+// ------------------------------------------------------------
+//
+// Color names ("Red", "LightGray", or a name made with MakeColor(), i.e. "MyRed") are looked up for every fgColor("..."),
+// bgColor("..."), Cls("..."), and {color} in output strings.  CColorTable resolves them without a search:
+//
+//		Stock colors	-- a perfect hash built at compile time: one hash, one slot, one compare
+//		User colors		-- an open-addressing hash map, added to with MakeColor()
+//		Other names		-- passed to the resolver set with SetResolver(), if any
+//
+// The stock colors are only the few whose values are confirmed against the SageBox library (Red, Green, Blue).  Every other
+// name SageBox knows (i.e. "Yellow", "LightGray") is left to the resolver, which the Windows side sets to CWindow::GetColor()
+// (see SageColorTable.h), so the values always match the library's.
+//
+// Names are not case-sensitive ("red", "Red" and "RED" are the same color).  Stock names can't be redefined -- MakeColor()
+// returns false for them.  Names for user colors can be redefined with a new color.
+//
+// GetGeneration() changes whenever a user color is added or changed (or the resolver is set), so a resolved color can be
+// cached and checked later (COptParse::GetColor() caches named colors this way).  Colors from the resolver can change without
+// the generation changing, so they aren't cached.
+//
+// GetColorTable() is the shared table:
+//
+//		GetColorTable().MakeColor("MyRed",MakeRGB(255,64,64));
+//
+//		Color_t rgbColor;
+//		if (GetColorTable().GetColor("myred",rgbColor)) ...
+//
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "SageCore.h"
+
+namespace Sage
+{
+namespace Core
+{
+	struct NamedColor_t
+	{
+		const char * sName;
+		Color_t rgbColor;
+	};
+
+	// The stock colors -- only those whose values are confirmed against the library (see CWindow::GetColor() and Cls())
+
+	static constexpr NamedColor_t kStockColors[] =
+	{
+		{ "Red",			MakeRGB(255,0,0)		},	{ "Green",			MakeRGB(0,255,0)		},
+		{ "Blue",			MakeRGB(0,0,255)		},
+	};
+
+	// The perfect hash for the stock colors -- the first seed that puts every name in its own slot, found by the compiler
+
+	static constexpr int kStockColorCount	= (int) (sizeof(kStockColors)/sizeof(kStockColors[0]));
+	static constexpr int kStockColorSlots	= 32;			// Power of two, 8x the names or more, so a seed is found quickly
+	static_assert(kStockColorSlots >= kStockColorCount*8 && kStockColorCount < 255,"Too many stock colors for the perfect hash");
+
+	// ColorNameHash() -- FNV-1a of the lowercase name, starting from uiSeed
+
+	static constexpr unsigned int ColorNameHash(const char * sName,unsigned int uiSeed)
+	{
+		unsigned int uiHash = 2166136261u ^ uiSeed;
+		for (;*sName;sName++)
+		{
+			unsigned char c = (unsigned char) *sName;
+			if (c >= 'A' && c <= 'Z') c += 'a' - 'A';
+			uiHash = (uiHash ^ c)*16777619u;
+		}
+		return uiHash ^ (uiHash >> 15);
+	}
+
+	// SameColorName() -- Case-insensitive compare
+
+	static constexpr bool SameColorName(const char * sName1,const char * sName2)
+	{
+		for (;;sName1++,sName2++)
+		{
+			unsigned char c1 = (unsigned char) *sName1, c2 = (unsigned char) *sName2;
+			if (c1 >= 'A' && c1 <= 'Z') c1 += 'a' - 'A';
+			if (c2 >= 'A' && c2 <= 'Z') c2 += 'a' - 'A';
+			if (c1 != c2) return false;
+			if (!c1) return true;
+		}
+	}
+
+	struct StockColorTable_t
+	{
+		unsigned int uiSeed;
+		unsigned char iSlot[kStockColorSlots];		// Stock color index + 1, or 0 for an empty slot
+	};
+
+	static constexpr StockColorTable_t BuildStockColorTable()
+	{
+		StockColorTable_t stTable = {};
+		for (unsigned int uiSeed=1;uiSeed < 100000;uiSeed++)
+		{
+			for (auto & iSlot : stTable.iSlot) iSlot = 0;
+			bool bPerfect = true;
+			for (int i=0;i<kStockColorCount && bPerfect;i++)
+			{
+				unsigned int uiSlot = ColorNameHash(kStockColors[i].sName,uiSeed) & (kStockColorSlots - 1);
+				if (stTable.iSlot[uiSlot]) bPerfect = false;
+				else stTable.iSlot[uiSlot] = (unsigned char) (i + 1);
+			}
+			if (bPerfect) { stTable.uiSeed = uiSeed; return stTable; }
+		}
+		return stTable;
+	}
+
+	static constexpr StockColorTable_t kStockColorTable = BuildStockColorTable();
+	static_assert(kStockColorTable.uiSeed != 0,"No perfect hash seed found for the stock colors");
+
+	// ColorResolver_t -- Resolves a name CColorTable doesn't know (i.e. with the library's colors).  Returns false if it isn't
+	// a color.  pData is the pointer passed to SetResolver().
+
+	typedef bool (*ColorResolver_t)(const char * sName,Color_t & rgbColor,void * pData);
+
+	class CColorTable
+	{
+	private:
+		// User colors -- open addressing with linear probing, at most half full
+
+		struct UserColor_t
+		{
+			std::string sName;
+			unsigned int uiHash;
+			Color_t rgbColor;
+		};
+
+		std::vector<UserColor_t> m_vUser;
+		int m_iUserCount = 0;
+		mutable std::mutex m_mutex;
+		std::atomic<unsigned int> m_uiGeneration { 1 };
+		ColorResolver_t m_fResolver	= nullptr;
+		void * m_pResolverData		= nullptr;
+
+		int FindUser(const char * sName,unsigned int uiHash) const
+		{
+			if (m_vUser.empty()) return -1;
+			unsigned int uiMask = (unsigned int) m_vUser.size() - 1;
+			for (unsigned int uiSlot = uiHash & uiMask;;uiSlot = (uiSlot + 1) & uiMask)
+			{
+				const UserColor_t & stColor = m_vUser[uiSlot];
+				if (stColor.sName.empty()) return -1;
+				if (stColor.uiHash == uiHash && SameColorName(stColor.sName.c_str(),sName)) return (int) uiSlot;
+			}
+		}
+
+		void GrowUser()
+		{
+			std::vector<UserColor_t> vOld;
+			vOld.swap(m_vUser);
+			m_vUser.resize(vOld.empty() ? 64 : vOld.size()*2);
+			unsigned int uiMask = (unsigned int) m_vUser.size() - 1;
+			for (auto & stColor : vOld)
+			{
+				if (stColor.sName.empty()) continue;
+				unsigned int uiSlot = stColor.uiHash & uiMask;
+				while (!m_vUser[uiSlot].sName.empty()) uiSlot = (uiSlot + 1) & uiMask;
+				m_vUser[uiSlot] = std::move(stColor);
+			}
+		}
+
+	public:
+
+		// FindStock() -- The stock color index for a name, or -1.  This is constexpr, so it can be used at compile time.
+		//
+		static constexpr int FindStock(const char * sName)
+		{
+			if (!sName || !*sName) return -1;
+			int iIndex = kStockColorTable.iSlot[ColorNameHash(sName,kStockColorTable.uiSeed) & (kStockColorSlots - 1)] - 1;
+			return iIndex >= 0 && SameColorName(kStockColors[iIndex].sName,sName) ? iIndex : -1;
+		}
+
+		// GetStockColor() -- A stock color by name.  Returns false if it isn't a stock color.
+		//
+		static constexpr bool GetStockColor(const char * sName,Color_t & rgbColor)
+		{
+			int iIndex = FindStock(sName);
+			if (iIndex < 0) return false;
+			rgbColor = kStockColors[iIndex].rgbColor;
+			return true;
+		}
+
+		// GetColor() -- A stock or user color by name, or failing that, the resolver's color.  Returns false if the name isn't
+		// found.  bResolved (if given) is set to true when the color came from the resolver (and so shouldn't be cached).
+		//
+		bool GetColor(const char * sName,Color_t & rgbColor,bool * bResolved = nullptr) const
+		{
+			if (bResolved) *bResolved = false;
+			if (GetStockColor(sName,rgbColor)) return true;
+			if (!sName || !*sName) return false;
+
+			ColorResolver_t fResolver;
+			void * pResolverData;
+			{
+				unsigned int uiHash = ColorNameHash(sName,0);
+				std::lock_guard<std::mutex> lock(m_mutex);
+				int iSlot = FindUser(sName,uiHash);
+				if (iSlot >= 0) { rgbColor = m_vUser[iSlot].rgbColor; return true; }
+				fResolver		= m_fResolver;
+				pResolverData	= m_pResolverData;
+			}
+
+			// The resolver is called without the lock, so it can call back into the table
+
+			if (!fResolver || !fResolver(sName,rgbColor,pResolverData)) return false;
+			if (bResolved) *bResolved = true;
+			return true;
+		}
+
+		// SetResolver() -- Set the function that resolves names that aren't stock or user colors (nullptr for none)
+		//
+		void SetResolver(ColorResolver_t fResolver,void * pData = nullptr)
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_fResolver		= fResolver;
+				m_pResolverData	= pData;
+			}
+			m_uiGeneration.fetch_add(1,std::memory_order_release);
+		}
+
+		// MakeColor() -- Add a user color, or change one.  Returns false for an empty name or a stock color name.
+		//
+		bool MakeColor(const char * sName,Color_t rgbColor)
+		{
+			if (!sName || !*sName || FindStock(sName) >= 0) return false;
+
+			unsigned int uiHash = ColorNameHash(sName,0);
+			std::lock_guard<std::mutex> lock(m_mutex);
+			int iSlot = FindUser(sName,uiHash);
+			if (iSlot >= 0) m_vUser[iSlot].rgbColor = rgbColor;
+			else
+			{
+				if ((m_iUserCount + 1)*2 > (int) m_vUser.size()) GrowUser();
+				unsigned int uiMask = (unsigned int) m_vUser.size() - 1;
+				unsigned int uiSlot = uiHash & uiMask;
+				while (!m_vUser[uiSlot].sName.empty()) uiSlot = (uiSlot + 1) & uiMask;
+				m_vUser[uiSlot] = { sName, uiHash, rgbColor };
+				m_iUserCount++;
+			}
+			m_uiGeneration.fetch_add(1,std::memory_order_release);
+			return true;
+		}
+
+		// GetGeneration() -- Changes whenever a user color is added or changed, or the resolver is set
+		//
+		unsigned int GetGeneration() const { return m_uiGeneration.load(std::memory_order_acquire); }
+
+		int GetUserCount() const { std::lock_guard<std::mutex> lock(m_mutex); return m_iUserCount; }
+		static constexpr int GetStockCount() { return kStockColorCount; }
+	};
+
+	// GetColorTable() -- The shared color table
+
+	inline CColorTable & GetColorTable() { static CColorTable cTable; return cTable; }
+
+}; // namespace Core
+}; // namespace Sage
+#endif // _CColorTable_H_
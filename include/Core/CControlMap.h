@@ -0,0 +1,73 @@
+//#pragma once
+#if !defined(_CControlMap_H_)
+#define _CControlMap_H_
+
+// ---------------------------------------------------
+// CControlMap.H -- Controls indexed by name and by ID
+// ---------------------------------------------------
+//
+// CControlMap keeps two hash maps for one type of control -- name to control and ID to control -- so finding a control by
+// name or ID is one hash lookup rather than a search through every control in the window.  See Sage::CControlIndex
+// (CControlIndex.h), which keeps one of these for each control type of a window.
+//
+// If two controls have the same name (or ID), the first one added is the one found, as with a search from the first
+// control created.  Remove() takes a control out of both maps (i.e. when it is deleted).
+//
+// CControlMap doesn't own the controls, and isn't thread-safe -- it is used from the thread that owns the window.
+//
+#include <string>
+#include <unordered_map>
+
+namespace Sage
+{
+namespace Core
+{
+	template <class _t>
+	class CControlMap
+	{
+	private:
+		std::unordered_map<std::string,_t *> m_mapName;
+		std::unordered_map<int,_t *> m_mapID;
+
+	public:
+
+		// Add() -- Add a control by its name (if sName isn't null or empty) and its ID
+		//
+		void Add(_t * cControl,const char * sName,int iID)
+		{
+			if (!cControl) return;
+			if (sName && *sName) m_mapName.emplace(sName,cControl);
+			m_mapID.emplace(iID,cControl);
+		}
+
+		// Find() -- The control with a name or ID, or nullptr
+		//
+		_t * Find(const char * sName) const
+		{
+			if (!sName || !*sName) return nullptr;
+			auto itControl = m_mapName.find(sName);
+			return itControl != m_mapName.end() ? itControl->second : nullptr;
+		}
+		_t * Find(int iID) const
+		{
+			auto itControl = m_mapID.find(iID);
+			return itControl != m_mapID.end() ? itControl->second : nullptr;
+		}
+
+		// Remove() -- Remove a control from both maps
+		//
+		void Remove(const _t * cControl)
+		{
+			for (auto itControl = m_mapName.begin();itControl != m_mapName.end();) if (itControl->second == cControl) itControl = m_mapName.erase(itControl); else ++itControl;
+			for (auto itControl = m_mapID.begin();itControl != m_mapID.end();) if (itControl->second == cControl) itControl = m_mapID.erase(itControl); else ++itControl;
+		}
+
+		void Clear() { m_mapName.clear(); m_mapID.clear(); }
+
+		int GetNameCount() const	{ return (int) m_mapName.size(); }
+		int GetIDCount() const		{ return (int) m_mapID.size(); }
+	};
+
+}; // namespace Core
+}; // namespace Sage
+#endif // _CControlMap_H_
@@ -0,0 +1,95 @@
+//#pragma once
+#if !defined(_CCpuInfo_H_)
+#define _CCpuInfo_H_
+
+// -------------------------------------------------
+// CCpuInfo.H -- CPU feature detection for Core code
+// -------------------------------------------------
+//
+// Used to pick SSE2 or AVX2 versions of the Core kernels at runtime.  The checks are made once, on first use.
+//
+// AVX2 is only reported when the OS also saves the YMM registers (OSXSAVE + XCR0), so it is safe to use when true.
+// On non-x86 systems, everything reports false and the scalar kernels are used.
+//
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define kSageCoreX86 1
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+	#else
+		#include <cpuid.h>
+	#endif
+#else
+	#define kSageCoreX86 0
+#endif
+
+namespace Sage
+{
+namespace Core
+{
+	struct CpuInfo_t
+	{
+		bool bSSE2;
+		bool bSSSE3;
+		bool bAVX2;
+	};
+
+#if kSageCoreX86
+	static inline void CpuId(int iLeaf,int iSubLeaf,unsigned int uiRegs[4])
+	{
+	#if defined(_MSC_VER)
+		__cpuidex((int *) uiRegs,iLeaf,iSubLeaf);
+	#else
+		__cpuid_count(iLeaf,iSubLeaf,uiRegs[0],uiRegs[1],uiRegs[2],uiRegs[3]);
+	#endif
+	}
+	static inline unsigned long long GetXCR0()
+	{
+	#if defined(_MSC_VER)
+		return _xgetbv(0);
+	#else
+		unsigned int uiLow, uiHigh;
+		__asm__ volatile ("xgetbv" : "=a" (uiLow), "=d" (uiHigh) : "c" (0));
+		return ((unsigned long long) uiHigh << 32) | uiLow;
+	#endif
+	}
+#endif
+
+	// DetectCpu() -- Read the CPU features.  Use GetCpuInfo() instead, which only does this once.
+
+	inline CpuInfo_t DetectCpu()
+	{
+		CpuInfo_t stInfo = {};
+#if kSageCoreX86
+		unsigned int uiRegs[4] = {};
+		CpuId(0,0,uiRegs);
+		unsigned int uiMaxLeaf = uiRegs[0];
+
+		CpuId(1,0,uiRegs);
+		stInfo.bSSE2	= (uiRegs[3] & (1u << 26)) != 0;
+		stInfo.bSSSE3	= (uiRegs[2] & (1u << 9)) != 0;
+
+		bool bOSXSave	= (uiRegs[2] & (1u << 27)) != 0;
+		bool bAVX		= (uiRegs[2] & (1u << 28)) != 0;
+
+		// AVX2 also needs the OS to save the XMM and YMM state (XCR0 bits 1 and 2)
+
+		if (uiMaxLeaf >= 7 && bOSXSave && bAVX && (GetXCR0() & 6) == 6)
+		{
+			CpuId(7,0,uiRegs);
+			stInfo.bAVX2 = (uiRegs[1] & (1u << 5)) != 0;
+		}
+#endif
+		return stInfo;
+	}
+
+	// GetCpuInfo() -- CPU features, detected on the first call
+
+	inline const CpuInfo_t & GetCpuInfo()
+	{
+		static const CpuInfo_t stInfo = DetectCpu();
+		return stInfo;
+	}
+
+}; // namespace Core
+}; // namespace Sage
+#endif // _CCpuInfo_H_
@@ -0,0 +1,216 @@
+//#pragma once
+#if !defined(_CDirtyRegion_H_)
+#define _CDirtyRegion_H_
+
+// -------------------------------------------------------------
+// CDirtyRegion.H -- Damaged rectangles, merged for presentation
+// -------------------------------------------------------------
+//
+// A window's canvas is either dirty or not -- one Write() or SetPixel() and the next Update() presents the whole canvas.
+// CDirtyRegion keeps the rectangles that were drawn into, so only those are presented:
+//
+//		Add()		-- record a drawn rectangle.  It is clipped to the canvas and merged with the rectangles it overlaps or is
+//					   next to when that wastes few pixels (i.e. consecutive characters or lines of text become one rectangle).
+//		AddAll()	-- the whole canvas is dirty (i.e. Cls(), scrolling)
+//		Present()	-- call fRegion(Rect_t) for each rectangle, or fFull() once when the rectangles cover more of the canvas than the
+//					   coverage threshold (SetThreshold(), default 0.5), or when AddAll() was called.  The region is then empty.
+//
+// There are never more than GetMaxRects() rectangles (SetMaxRects(), default 16): past that, the two rectangles whose merge
+// wastes the fewest pixels are merged.
+//
+// The pixels and rectangles presented are counted per frame (each Present() with something to present) -- see GetStats().
+//
+// CDirtyRegion isn't thread-safe; use it from the thread drawing to the window.  See Sage::CDirtyUpdate (CDirtyUpdate.h) for
+// the CWindow side.
+//
+#include <vector>
+#include "SageCore.h"
+
+namespace Sage
+{
+namespace Core
+{
+	struct DirtyStats_t
+	{
+		long long iFrames;			// Present() calls that presented something
+		long long iFullFrames;		// ... of those, frames presented in full
+		long long iRects;			// Rectangles presented (a full frame counts as 1)
+		long long iPixels;			// Pixels presented
+		long long iLastPixels;		// Pixels presented in the last frame
+		int iLastRects;				// Rectangles presented in the last frame
+	};
+
+	class CDirtyRegion
+	{
+	private:
+		std::vector<Rect_t> m_vRects;
+		int m_iWidth		= 0;
+		int m_iHeight		= 0;
+		int m_iMaxRects		= 16;
+		double m_fThreshold	= 0.5;
+		bool m_bAll			= false;
+		DirtyStats_t m_stStats {};
+
+		static long long Area(const Rect_t & r) { return (long long) (r.right - r.left)*(r.bottom - r.top); }
+		static Rect_t Union(const Rect_t & r1,const Rect_t & r2)
+		{
+			return { r1.left < r2.left ? r1.left : r2.left, r1.top < r2.top ? r1.top : r2.top,
+					 r1.right > r2.right ? r1.right : r2.right, r1.bottom > r2.bottom ? r1.bottom : r2.bottom };
+		}
+		static long long Overlap(const Rect_t & r1,const Rect_t & r2)
+		{
+			int iWidth	= (r1.right < r2.right ? r1.right : r2.right) - (r1.left > r2.left ? r1.left : r2.left);
+			int iHeight	= (r1.bottom < r2.bottom ? r1.bottom : r2.bottom) - (r1.top > r2.top ? r1.top : r2.top);
+			return iWidth > 0 && iHeight > 0 ? (long long) iWidth*iHeight : 0;
+		}
+
+		// Waste() -- Pixels presented by the union of two rectangles that aren't in either one
+
+		static long long Waste(const Rect_t & r1,const Rect_t & r2) { return Area(Union(r1,r2)) - Area(r1) - Area(r2) + Overlap(r1,r2); }
+
+		// CanMerge() -- Merge when the union wastes no more than a quarter of the pixels drawn (plus a row or two of slack)
+
+		static bool CanMerge(const Rect_t & r1,const Rect_t & r2)
+		{
+			return Waste(r1,r2) <= (Area(r1) + Area(r2) - Overlap(r1,r2))/4 + 64;
+		}
+
+		// MergeInto() -- Merge rectangle iIndex with any it can merge with, repeating as the rectangle grows
+
+		void MergeInto(size_t iIndex)
+		{
+			for (bool bMerged = true;bMerged;)
+			{
+				bMerged = false;
+				for (size_t i=0;i<m_vRects.size();i++)
+				{
+					if (i == iIndex || !CanMerge(m_vRects[i],m_vRects[iIndex])) continue;
+					m_vRects[iIndex] = Union(m_vRects[i],m_vRects[iIndex]);
+					m_vRects[i] = m_vRects.back();
+					m_vRects.pop_back();
+					if (iIndex == m_vRects.size()) iIndex = i;
+					bMerged = true;
+					break;
+				}
+			}
+		}
+
+		// MergeCheapest() -- Merge the two rectangles whose union wastes the fewest pixels
+
+		void MergeCheapest()
+		{
+			size_t iBest1 = 0, iBest2 = 1;
+			long long iBestWaste = -1;
+			for (size_t i=0;i<m_vRects.size();i++)
+				for (size_t j=i+1;j<m_vRects.size();j++)
+				{
+					long long iWaste = Waste(m_vRects[i],m_vRects[j]);
+					if (iBestWaste < 0 || iWaste < iBestWaste) { iBestWaste = iWaste; iBest1 = i; iBest2 = j; }
+				}
+			m_vRects[iBest1] = Union(m_vRects[iBest1],m_vRects[iBest2]);
+			m_vRects[iBest2] = m_vRects.back();
+			m_vRects.pop_back();
+			MergeInto(iBest1);
+		}
+
+	public:
+		CDirtyRegion(int iWidth = 0,int iHeight = 0) { SetSize(iWidth,iHeight); }
+
+		// SetSize() -- Set the canvas size.  Rectangles are clipped to it.  This clears the region.
+		//
+		void SetSize(int iWidth,int iHeight)
+		{
+			m_iWidth	= iWidth > 0 ? iWidth : 0;
+			m_iHeight	= iHeight > 0 ? iHeight : 0;
+			Clear();
+		}
+		Size_t GetSize() const { return { m_iWidth, m_iHeight }; }
+
+		// SetThreshold() -- The part of the canvas (0-1) past which Present() presents the whole canvas.  0.5 by default.
+		//
+		void SetThreshold(double fThreshold) { m_fThreshold = fThreshold < 0 ? 0 : fThreshold > 1 ? 1 : fThreshold; }
+		double GetThreshold() const { return m_fThreshold; }
+
+		// SetMaxRects() -- The most rectangles kept (at least 1).  16 by default.
+		//
+		void SetMaxRects(int iMaxRects) { m_iMaxRects = iMaxRects < 1 ? 1 : iMaxRects; while ((int) m_vRects.size() > m_iMaxRects) MergeCheapest(); }
+		int GetMaxRects() const { return m_iMaxRects; }
+
+		// Add() -- Add a drawn rectangle
+		//
+		void Add(int iX,int iY,int iWidth,int iHeight) { Add(Rect_t{ iX, iY, iX + iWidth, iY + iHeight }); }
+		void Add(Rect_t rRect)
+		{
+			if (m_bAll) return;
+			if (rRect.left < 0) rRect.left = 0;
+			if (rRect.top < 0) rRect.top = 0;
+			if (rRect.right > m_iWidth) rRect.right = m_iWidth;
+			if (rRect.bottom > m_iHeight) rRect.bottom = m_iHeight;
+			if (rRect.right <= rRect.left || rRect.bottom <= rRect.top) return;
+
+			m_vRects.push_back(rRect);
+			MergeInto(m_vRects.size() - 1);
+			while ((int) m_vRects.size() > m_iMaxRects) MergeCheapest();
+		}
+
+		// AddAll() -- The whole canvas is dirty
+		//
+		void AddAll() { m_bAll = true; m_vRects.clear(); }
+
+		void Clear() { m_bAll = false; m_vRects.clear(); }
+
+		bool isEmpty() const	{ return !m_bAll && m_vRects.empty(); }
+		bool isAll() const		{ return m_bAll; }
+
+		// GetDirtyPixels() -- The pixels in the rectangles (the whole canvas after AddAll())
+		//
+		long long GetDirtyPixels() const
+		{
+			if (m_bAll) return (long long) m_iWidth*m_iHeight;
+			long long iPixels = 0;
+			for (auto & rRect : m_vRects) iPixels += Area(rRect);
+			return iPixels;
+		}
+
+		// isFull() -- True when Present() would present the whole canvas
+		//
+		bool isFull() const { return m_bAll || (!m_vRects.empty() && GetDirtyPixels() > m_fThreshold*m_iWidth*m_iHeight); }
+
+		const std::vector<Rect_t> & GetRects() const { return m_vRects; }
+
+		// Present() -- Call fRegion(const Rect_t &) for each rectangle, or fFull() for the whole canvas (see the notes above), then
+		// clear the region.  Returns false if there was nothing to present.
+		//
+		template <class _region,class _full>
+		bool Present(_region fRegion,_full fFull)
+		{
+			if (isEmpty()) return false;
+			if (isFull())
+			{
+				fFull();
+				m_stStats.iFullFrames++;
+				m_stStats.iLastRects	= 1;
+				m_stStats.iLastPixels	= (long long) m_iWidth*m_iHeight;
+			}
+			else
+			{
+				for (auto & rRect : m_vRects) fRegion(rRect);
+				m_stStats.iLastRects	= (int) m_vRects.size();
+				m_stStats.iLastPixels	= GetDirtyPixels();
+			}
+			m_stStats.iFrames++;
+			m_stStats.iRects	+= m_stStats.iLastRects;
+			m_stStats.iPixels	+= m_stStats.iLastPixels;
+			Clear();
+			return true;
+		}
+
+		// GetStats() -- Frames, rectangles and pixels presented
+		//
+		const DirtyStats_t & GetStats() const { return m_stStats; }
+		void ResetStats() { m_stStats = {}; }
+	};
+
+}; // namespace Core
+}; // namespace Sage
+#endif // _CDirtyRegion_H_
@@ -0,0 +1,267 @@
+//#pragma once
+#if !defined(_CEventQueue_H_)
+#define _CEventQueue_H_
+
+// ------------------------------------------------------------------
+// CEventQueue.H -- Lock-free MPSC queue of typed events, with a wait
+// ------------------------------------------------------------------
+//
+// Window events (mouse, keys, menus, button presses, slider moves) reach a program through flags that WaitforEvent() and
+// EventLoop() poll -- a second event of the same kind before the next poll overwrites the first, and the wait is a sleep loop.
+// CEventQueue keeps every event, in order, as an Event_t:
+//
+//		Post()		-- any thread (i.e. the window's message thread, or worker threads) adds an event.  Lock-free.
+//		Wait()		-- the thread handling events takes the next one, sleeping until there is one (or a time-out).  A
+//					   thread waiting in Wait() uses no CPU; Post() wakes it.
+//		Get()		-- takes the next event if there is one, without waiting
+//
+// There can be any number of posting threads, but only one thread taking events (Wait() and Get()).
+//
+// Close() wakes the waiting thread and makes Wait() return false from then on, once the queue is empty (i.e. when the window
+// closes).
+//
+// Batches and coalescing:
+//
+// GetBatch() and WaitBatch() take every pending event in one call.  With bCoalesce, runs of high-rate events are merged into one
+// event each, so a handler redrawing on each mouse move or slider change does the work once per batch rather than once per
+// input event:
+//
+//		MouseMove			-- merged into one event with the latest position
+//		MouseWheel			-- merged into one event with the latest position and the total iDelta
+//		SliderMoved			-- merged per slider (iID) into one event with the latest iValue (position) and the total iDelta
+//
+// A merged event keeps the latest event's time, and iCount is the number of events merged into it.  Events are only merged up
+// to the next event of another kind (a click, key, button, menu, etc.), so the order of events relative to those is kept --
+// i.e. a mouse move before a click and one after it are not merged.
+//
+// Example:
+//
+//		Core::Event_t stEvent;
+//		while (cQueue.Wait(stEvent))
+//			if (stEvent.eType == Core::EventType::ButtonPressed && stEvent.iID == 1) ...
+//
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+namespace Sage
+{
+namespace Core
+{
+	enum class EventType : unsigned char
+	{
+		None,
+		MouseMove,
+		LButtonDown,
+		LButtonUp,
+		RButtonDown,
+		RButtonUp,
+		MouseWheel,			// iDelta is the wheel movement
+		ControlKey,			// iKey is the Sage::ControlKey
+		Char,				// iKey is the character
+		Menu,				// iID is the menu item ID
+		ButtonPressed,		// iID is the button's ID
+		ButtonUnpressed,
+		SliderMoved,		// iID is the slider's ID, iValue the new position and iDelta the change
+		WindowClosing,
+		User,				// Posted by the program -- iID, iValue, etc. are up to the program
+	};
+
+	struct Event_t
+	{
+		EventType eType;
+		int iID;				// Control or menu ID
+		int iX;					// Mouse position (in the window)
+		int iY;
+		int iKey;				// Key or character
+		int iValue;				// i.e. slider position
+		int iDelta;				// i.e. wheel or slider movement
+		int iCount;				// Number of events this event stands for (1, or more for coalesced events)
+		long long iTimeUs;		// When the event was posted (Core::CEventQueue::GetTimeUs())
+	};
+
+	// isCoalescable() -- True for the high-rate events merged by CoalesceEvents()
+
+	inline bool isCoalescable(EventType eType) { return eType == EventType::MouseMove || eType == EventType::MouseWheel || eType == EventType::SliderMoved; }
+
+	// CoalesceEvents() -- Merge coalescable events in vEvents from iStart on, in place (see the notes above).  Returns the number
+	// of events removed.
+
+	inline int CoalesceEvents(std::vector<Event_t> & vEvents,size_t iStart = 0)
+	{
+		size_t iOut		= iStart;
+		size_t iBarrier	= iStart;				// Events before this are before a non-coalescable event, and aren't merged into
+		for (size_t i=iStart;i<vEvents.size();i++)
+		{
+			Event_t & stEvent = vEvents[i];
+			if (!isCoalescable(stEvent.eType)) { vEvents[iOut++] = stEvent; iBarrier = iOut; continue; }
+
+			size_t iMatch = iOut;
+			for (size_t j=iOut;j-- > iBarrier;)
+				if (vEvents[j].eType == stEvent.eType && (stEvent.eType != EventType::SliderMoved || vEvents[j].iID == stEvent.iID)) { iMatch = j; break; }
+
+			if (iMatch == iOut) { vEvents[iOut++] = stEvent; continue; }
+
+			Event_t & stInto = vEvents[iMatch];
+			int iDelta = stInto.iDelta + stEvent.iDelta;
+			int iCount = stInto.iCount + stEvent.iCount;
+			stInto			= stEvent;
+			stInto.iDelta	= iDelta;
+			stInto.iCount	= iCount;
+		}
+		int iRemoved = (int) (vEvents.size() - iOut);
+		vEvents.resize(iOut);
+		return iRemoved;
+	}
+
+	class CEventQueue
+	{
+	private:
+		struct Node_t
+		{
+			std::atomic<Node_t *> stNext { nullptr };
+			Event_t stEvent;
+		};
+
+		// Producers swap themselves in at m_stHead; the consumer takes from m_stTail (a list with a stub node, so
+		// posting never waits on the consumer or on other producers).
+
+		std::atomic<Node_t *> m_stHead;
+		Node_t * m_stTail;
+
+		std::atomic<bool> m_bWaiting { false };
+		std::atomic<bool> m_bClosed	 { false };
+		std::atomic<long long> m_iPosted { 0 };
+		std::mutex m_mutex;
+		std::condition_variable m_cvEvent;
+
+		bool Pending(std::memory_order eOrder = std::memory_order_acquire) const { return m_stTail->stNext.load(eOrder) != nullptr; }
+
+	public:
+		CEventQueue()
+		{
+			m_stTail = new Node_t;
+			m_stHead.store(m_stTail,std::memory_order_relaxed);
+		}
+		~CEventQueue()
+		{
+			while (m_stTail)
+			{
+				Node_t * stNext = m_stTail->stNext.load(std::memory_order_relaxed);
+				delete m_stTail;
+				m_stTail = stNext;
+			}
+		}
+		CEventQueue(const CEventQueue &) = delete;
+		CEventQueue & operator = (const CEventQueue &) = delete;
+
+		// GetTimeUs() -- The time in microseconds, on the clock used for Event_t::iTimeUs
+		//
+		static long long GetTimeUs()
+		{
+			return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+		// Post() -- Add an event (from any thread).  iTimeUs is set to now if it is 0, and iCount to 1 if it is 0.
+		//
+		void Post(const Event_t & stEvent)
+		{
+			Node_t * stNode = new Node_t;
+			stNode->stEvent = stEvent;
+			if (!stNode->stEvent.iTimeUs) stNode->stEvent.iTimeUs = GetTimeUs();
+			if (!stNode->stEvent.iCount) stNode->stEvent.iCount = 1;
+
+			Node_t * stPrev = m_stHead.exchange(stNode,std::memory_order_acq_rel);
+			m_iPosted.fetch_add(1,std::memory_order_relaxed);
+
+			// Wake the consumer only if it is (about to be) asleep -- otherwise posting takes no lock.  The link and the check are
+			// seq_cst, as are the flag and the check in Wait(), so either Wait() sees the event or Post() sees it waiting.
+
+			stPrev->stNext.store(stNode,std::memory_order_seq_cst);
+			if (m_bWaiting.load(std::memory_order_seq_cst))
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_cvEvent.notify_one();
+			}
+		}
+
+		// Get() -- Take the next event if there is one (consumer thread only)
+		//
+		bool Get(Event_t & stEvent)
+		{
+			Node_t * stNext = m_stTail->stNext.load(std::memory_order_acquire);
+			if (!stNext) return false;
+			stEvent = stNext->stEvent;
+			delete m_stTail;
+			m_stTail = stNext;
+			return true;
+		}
+
+		// Wait() -- Take the next event, waiting up to iTimeoutMS (-1 to wait until there is one).  Returns false on a
+		// time-out, or when the queue is closed and empty (consumer thread only).
+		//
+		bool Wait(Event_t & stEvent,int iTimeoutMS = -1)
+		{
+			if (Get(stEvent)) return true;
+
+			auto tEnd = std::chrono::steady_clock::now() + std::chrono::milliseconds(iTimeoutMS < 0 ? 0 : iTimeoutMS);
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_bWaiting.store(true,std::memory_order_seq_cst);
+			while (!Pending(std::memory_order_seq_cst) && !m_bClosed.load(std::memory_order_acquire))
+			{
+				if (iTimeoutMS < 0) m_cvEvent.wait(lock);
+				else if (m_cvEvent.wait_until(lock,tEnd) == std::cv_status::timeout) break;
+			}
+			m_bWaiting.store(false,std::memory_order_relaxed);
+			lock.unlock();
+			return Get(stEvent);
+		}
+
+		// GetBatch() -- Take every pending event, adding them to vEvents, merged if bCoalesce is true (consumer thread only).
+		// Returns the number of events added.
+		//
+		int GetBatch(std::vector<Event_t> & vEvents,bool bCoalesce = false)
+		{
+			size_t iStart = vEvents.size();
+			Event_t stEvent;
+			while (Get(stEvent)) vEvents.push_back(stEvent);
+			if (bCoalesce) CoalesceEvents(vEvents,iStart);
+			return (int) (vEvents.size() - iStart);
+		}
+
+		// WaitBatch() -- As GetBatch(), waiting as Wait() does for the first event.  Returns the number of events added (0 on a
+		// time-out, or when the queue is closed and empty).
+		//
+		int WaitBatch(std::vector<Event_t> & vEvents,bool bCoalesce = false,int iTimeoutMS = -1)
+		{
+			size_t iStart = vEvents.size();
+			Event_t stEvent;
+			if (!Wait(stEvent,iTimeoutMS)) return 0;
+			vEvents.push_back(stEvent);
+			while (Get(stEvent)) vEvents.push_back(stEvent);
+			if (bCoalesce) CoalesceEvents(vEvents,iStart);
+			return (int) (vEvents.size() - iStart);
+		}
+
+		// Close() -- Wake the waiting thread; Wait() returns false once the queue is empty.  Events can still be posted and taken.
+		//
+		void Close()
+		{
+			m_bClosed.store(true,std::memory_order_release);
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_cvEvent.notify_all();
+		}
+
+		bool isClosed() const { return m_bClosed.load(std::memory_order_acquire); }
+		bool isEmpty() const { return !Pending(); }
+
+		// GetPostedCount() -- Events posted since the queue was created
+		//
+		long long GetPostedCount() const { return m_iPosted.load(std::memory_order_relaxed); }
+	};
+
+}; // namespace Core
+}; // namespace Sage
+#endif // _CEventQueue_H_
@@ -0,0 +1,363 @@
+//#pragma once
+#if !defined(_CFloatKernels_H_)
+#define _CFloatKernels_H_
+
+// ---------------------------------------------------------------------
+// CFloatKernels.H -- Planar float <-> interleaved 24-bit bitmap conversion
+// ---------------------------------------------------------------------
+//
+// These are the conversions behind FloatBitmap_t::ConverttoBitmap() and RawBitmap_t::ConverttoFloat().
+//
+// FloatBitmap_t keeps separate (planar) Red, Green and Blue float arrays of iWidth*iHeight values each, with values in the range 0-255.
+// Converting to a 24-bit bitmap clamps each value to 0-255 and rounds to nearest (NaN becomes 0).
+//
+// Each conversion has Scalar, SSE2 and AVX2 row versions, picked with the same SIMD level as the other Core kernels
+// (see SetSimdLevel() in CRowKernels.h).  The results are the same at every level.
+//
+// The bitmap-level functions can write into an existing destination (so nothing is allocated each frame), and can split the rows
+// across threads for large images.  iThreads = 1 stays on the calling thread; 0 uses every thread in the Core thread pool (see CParallel.h).
+//
+#include "SageCore.h"
+#include "CRowKernels.h"
+#include "CParallel.h"
+
+namespace Sage
+{
+namespace Core
+{
+	// ----------------------------------------
+	// FloatBitmap_t -- Planar float RGB bitmap
+	// ----------------------------------------
+	//
+	// This mirrors Sage::FloatBitmap_t.  Each plane has iWidth*iHeight floats, with no row padding.
+	//
+	struct FloatBitmap_t
+	{
+		int iWidth;
+		int iHeight;
+		float * fRed;
+		float * fGreen;
+		float * fBlue;
+
+		bool isValid() const { return fRed && fGreen && fBlue && iWidth > 0 && iHeight > 0; }
+	};
+
+	// CreateFloatBitmap() -- Allocate a planar float bitmap.  The memory is not cleared.  Returns an empty FloatBitmap_t on failure.
+
+	inline FloatBitmap_t CreateFloatBitmap(int iWidth,int iHeight)
+	{
+		FloatBitmap_t fBitmap = {};
+		if (iWidth <= 0 || iHeight <= 0) return fBitmap;
+
+		size_t iSize = (size_t) iWidth*iHeight*sizeof(float);
+		fBitmap.fRed	= (float *) malloc(iSize);
+		fBitmap.fGreen	= (float *) malloc(iSize);
+		fBitmap.fBlue	= (float *) malloc(iSize);
+		if (!fBitmap.fRed || !fBitmap.fGreen || !fBitmap.fBlue)
+		{
+			free(fBitmap.fRed); free(fBitmap.fGreen); free(fBitmap.fBlue);
+			return {};
+		}
+		fBitmap.iWidth	= iWidth;
+		fBitmap.iHeight	= iHeight;
+		return fBitmap;
+	}
+
+	inline void DeleteFloatBitmap(FloatBitmap_t & fBitmap)
+	{
+		free(fBitmap.fRed);
+		free(fBitmap.fGreen);
+		free(fBitmap.fBlue);
+		fBitmap = {};
+	}
+
+	// FloattoByte() -- Clamp to 0-255 and round to nearest.  The SIMD versions do the same steps in the same order.
+
+	static inline unsigned char FloattoByte(float fValue)
+	{
+		if (!(fValue > 0.0f)) return 0;				// Also catches NaN
+		if (fValue > 255.0f) fValue = 255.0f;
+		return (unsigned char) (int) (fValue + 0.5f);
+	}
+
+	// -----------------------------------
+	// Scalar (reference) row conversions
+	// -----------------------------------
+
+	// InterleaveRowScalar() -- Planar floats to iPixels 24-bit (Blue,Green,Red) pixels
+
+	inline void InterleaveRowScalar(const float * fRed,const float * fGreen,const float * fBlue,unsigned char * sDest,int iPixels)
+	{
+		for (int i=0;i<iPixels;i++)
+		{
+			sDest[i*3+0] = FloattoByte(fBlue[i]);
+			sDest[i*3+1] = FloattoByte(fGreen[i]);
+			sDest[i*3+2] = FloattoByte(fRed[i]);
+		}
+	}
+
+	// DeinterleaveRowScalar() -- iPixels 24-bit (Blue,Green,Red) pixels to planar floats
+
+	inline void DeinterleaveRowScalar(const unsigned char * sSource,float * fRed,float * fGreen,float * fBlue,int iPixels)
+	{
+		for (int i=0;i<iPixels;i++)
+		{
+			fBlue[i]	= (float) sSource[i*3+0];
+			fGreen[i]	= (float) sSource[i*3+1];
+			fRed[i]		= (float) sSource[i*3+2];
+		}
+	}
+
+#if kSageCoreX86
+
+	// -----------------------------------
+	// SSE2 row conversions
+	// -----------------------------------
+	//
+	// SSE2 has no byte shuffle, so the float->integer work is vectorized and the 3-byte interleave is done through a small buffer.
+	// Bytes->floats uses the scalar version with SSE2, which measured faster than splitting the channels through a buffer.
+
+	// Pack16SSE2() -- Clamp, round and pack 16 floats to 16 bytes
+
+	kSageTargetSSE2 static inline __m128i Pack16SSE2(const float * fSource)
+	{
+		const __m128 vZero	= _mm_setzero_ps();
+		const __m128 v255	= _mm_set1_ps(255.0f);
+		const __m128 vHalf	= _mm_set1_ps(0.5f);
+
+		__m128i vInt[4];
+		for (int i=0;i<4;i++)
+		{
+			// max(v,0) returns 0 for NaN, matching FloattoByte()
+
+			__m128 vValue = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(fSource+i*4),vZero),v255);
+			vInt[i] = _mm_cvttps_epi32(_mm_add_ps(vValue,vHalf));
+		}
+		return _mm_packus_epi16(_mm_packs_epi32(vInt[0],vInt[1]),_mm_packs_epi32(vInt[2],vInt[3]));
+	}
+
+	kSageTargetSSE2 inline void InterleaveRowSSE2(const float * fRed,const float * fGreen,const float * fBlue,unsigned char * sDest,int iPixels)
+	{
+		alignas(16) unsigned char sPlanes[3][16];
+		int i = 0;
+		for (;i+16<=iPixels;i+=16)
+		{
+			_mm_store_si128((__m128i *) sPlanes[0],Pack16SSE2(fBlue+i));
+			_mm_store_si128((__m128i *) sPlanes[1],Pack16SSE2(fGreen+i));
+			_mm_store_si128((__m128i *) sPlanes[2],Pack16SSE2(fRed+i));
+
+			unsigned char * sOut = sDest + i*3;
+			for (int j=0;j<16;j++)
+			{
+				sOut[j*3+0] = sPlanes[0][j];
+				sOut[j*3+1] = sPlanes[1][j];
+				sOut[j*3+2] = sPlanes[2][j];
+			}
+		}
+		InterleaveRowScalar(fRed+i,fGreen+i,fBlue+i,sDest+i*3,iPixels-i);
+	}
+
+	// -----------------------------------
+	// AVX2 row conversions
+	// -----------------------------------
+	//
+	// 16 pixels (48 bytes) at a time.  The 3-byte interleave uses byte shuffles: each 16-byte output is the OR of one shuffle per channel.
+
+	// InterleaveMasks_t -- Shuffle masks for 16 pixels of 3 channels <-> 3 x 16 bytes.  0x80 zeroes a byte.
+
+	struct InterleaveMasks_t
+	{
+		alignas(16) unsigned char sInterleave[3][3][16];		// [output vector][channel]
+		alignas(16) unsigned char sDeinterleave[3][3][16];		// [channel][input vector]
+
+		InterleaveMasks_t()
+		{
+			for (int iVector=0;iVector<3;iVector++)
+				for (int iChannel=0;iChannel<3;iChannel++)
+					for (int j=0;j<16;j++)
+					{
+						int iPlace = iVector*16 + j;
+						sInterleave[iVector][iChannel][j] = iPlace % 3 == iChannel ? (unsigned char) (iPlace/3) : 0x80;
+
+						int iSource = j*3 + iChannel;
+						sDeinterleave[iChannel][iVector][j] = iSource/16 == iVector ? (unsigned char) (iSource % 16) : 0x80;
+					}
+		}
+	};
+
+	static inline const InterleaveMasks_t & GetInterleaveMasks()
+	{
+		static const InterleaveMasks_t stMasks;
+		return stMasks;
+	}
+
+	// Pack16AVX2() -- Clamp, round and pack 16 floats to 16 bytes
+
+	kSageTargetAVX2 static inline __m128i Pack16AVX2(const float * fSource)
+	{
+		const __m256 vZero	= _mm256_setzero_ps();
+		const __m256 v255	= _mm256_set1_ps(255.0f);
+		const __m256 vHalf	= _mm256_set1_ps(0.5f);
+
+		__m256i vInt0 = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(fSource),vZero),v255),vHalf));
+		__m256i vInt1 = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(fSource+8),vZero),v255),vHalf));
+
+		// Packing works within 128-bit lanes; the permutes put the values back in order
+
+		__m256i vWords = _mm256_permute4x64_epi64(_mm256_packs_epi32(vInt0,vInt1),0xD8);
+		__m256i vBytes = _mm256_permute4x64_epi64(_mm256_packus_epi16(vWords,vWords),0xD8);
+		return _mm256_castsi256_si128(vBytes);
+	}
+
+	kSageTargetAVX2 inline void InterleaveRowAVX2(const float * fRed,const float * fGreen,const float * fBlue,unsigned char * sDest,int iPixels)
+	{
+		auto & stMasks = GetInterleaveMasks();
+		__m128i vMask[3][3];
+		for (int i=0;i<3;i++)
+			for (int j=0;j<3;j++) vMask[i][j] = _mm_load_si128((const __m128i *) stMasks.sInterleave[i][j]);
+
+		int i = 0;
+		for (;i+16<=iPixels;i+=16)
+		{
+			__m128i vPlane[3] = { Pack16AVX2(fBlue+i), Pack16AVX2(fGreen+i), Pack16AVX2(fRed+i) };
+			__m128i * vOut = (__m128i *) (sDest + i*3);
+
+			for (int j=0;j<3;j++)
+			{
+				__m128i vResult = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(vPlane[0],vMask[j][0]),_mm_shuffle_epi8(vPlane[1],vMask[j][1])),
+											   _mm_shuffle_epi8(vPlane[2],vMask[j][2]));
+				_mm_storeu_si128(vOut+j,vResult);
+			}
+		}
+		InterleaveRowScalar(fRed+i,fGreen+i,fBlue+i,sDest+i*3,iPixels-i);
+	}
+
+	kSageTargetAVX2 inline void DeinterleaveRowAVX2(const unsigned char * sSource,float * fRed,float * fGreen,float * fBlue,int iPixels)
+	{
+		auto & stMasks = GetInterleaveMasks();
+		__m128i vMask[3][3];
+		for (int i=0;i<3;i++)
+			for (int j=0;j<3;j++) vMask[i][j] = _mm_load_si128((const __m128i *) stMasks.sDeinterleave[i][j]);
+
+		float * fPlanes[3] = { fBlue, fGreen, fRed };
+
+		int i = 0;
+		for (;i+16<=iPixels;i+=16)
+		{
+			const __m128i * vIn = (const __m128i *) (sSource + i*3);
+			__m128i vSource[3] = { _mm_loadu_si128(vIn), _mm_loadu_si128(vIn+1), _mm_loadu_si128(vIn+2) };
+
+			for (int j=0;j<3;j++)
+			{
+				__m128i vPlane = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(vSource[0],vMask[j][0]),_mm_shuffle_epi8(vSource[1],vMask[j][1])),
+											  _mm_shuffle_epi8(vSource[2],vMask[j][2]));
+
+				_mm256_storeu_ps(fPlanes[j]+i,	_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(vPlane)));
+				_mm256_storeu_ps(fPlanes[j]+i+8,_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(vPlane,8))));
+			}
+		}
+		DeinterleaveRowScalar(sSource+i*3,fRed+i,fGreen+i,fBlue+i,iPixels-i);
+	}
+
+#endif // kSageCoreX86
+
+	// -----------------------------------
+	// Dispatch
+	// -----------------------------------
+
+	struct FloatRowKernels_t
+	{
+		void (*InterleaveRow)	(const float * fRed,const float * fGreen,const float * fBlue,unsigned char * sDest,int iPixels);
+		void (*DeinterleaveRow)	(const unsigned char * sSource,float * fRed,float * fGreen,float * fBlue,int iPixels);
+	};
+
+	// GetFloatRowKernels() -- The conversions for the current SIMD level (see SetSimdLevel())
+
+	inline const FloatRowKernels_t & GetFloatRowKernels()
+	{
+		static const FloatRowKernels_t stScalar	= { InterleaveRowScalar,	DeinterleaveRowScalar	};
+#if kSageCoreX86
+		static const FloatRowKernels_t stSSE2	= { InterleaveRowSSE2,		DeinterleaveRowScalar	};
+		static const FloatRowKernels_t stAVX2	= { InterleaveRowAVX2,		DeinterleaveRowAVX2		};
+
+		switch (GetSimdLevel())
+		{
+			case SimdLevel::AVX2:	return stAVX2;
+			case SimdLevel::SSE2:	return stSSE2;
+			default:				break;
+		}
+#endif
+		return stScalar;
+	}
+
+	// -----------------------------------
+	// Bitmap conversions
+	// -----------------------------------
+
+	// ConverttoBitmap() -- Convert a float bitmap into an existing 24-bit bitmap of the same size (FloatBitmap_t::ConverttoBitmap(stSource))
+	//
+	inline bool ConverttoBitmap(const FloatBitmap_t & fSource,Bitmap_t & stDest,int iThreads = 1)
+	{
+		if (!fSource.isValid() || !stDest.isValid()) return false;
+		if (fSource.iWidth != stDest.iWidth || fSource.iHeight != stDest.iHeight) return false;
+
+		auto & stKernels = GetFloatRowKernels();
+		int iWidth = fSource.iWidth;
+
+		ParallelRows(fSource.iHeight,iWidth,iThreads,[&](int iStart,int iEnd)
+		{
+			for (int i=iStart;i<iEnd;i++)
+			{
+				size_t iPlace = (size_t) i*iWidth;
+				stKernels.InterleaveRow(fSource.fRed+iPlace,fSource.fGreen+iPlace,fSource.fBlue+iPlace,stDest.Row(i),iWidth);
+			}
+		});
+		return true;
+	}
+
+	// ConverttoBitmap() -- Convert a float bitmap to a new 24-bit bitmap (FloatBitmap_t::ConverttoBitmap()).  Free it with DeleteBitmap().
+	//
+	[[nodiscard]] inline Bitmap_t ConverttoBitmap(const FloatBitmap_t & fSource,int iThreads = 1,bool * bSuccess = nullptr)
+	{
+		Bitmap_t stDest = fSource.isValid() ? CreateBitmap(fSource.iWidth,fSource.iHeight) : Bitmap_t{};
+		bool bResult = stDest.isValid() && ConverttoBitmap(fSource,stDest,iThreads);
+		if (!bResult) DeleteBitmap(stDest);
+		if (bSuccess) *bSuccess = bResult;
+		return stDest;
+	}
+
+	// ConverttoFloat() -- Convert a 24-bit bitmap into an existing float bitmap of the same size (RawBitmap_t::ConverttoFloat(fBitmap))
+	//
+	inline bool ConverttoFloat(const Bitmap_t & stSource,FloatBitmap_t & fDest,int iThreads = 1)
+	{
+		if (!stSource.isValid() || !fDest.isValid()) return false;
+		if (fDest.iWidth != stSource.iWidth || fDest.iHeight != stSource.iHeight) return false;
+
+		auto & stKernels = GetFloatRowKernels();
+		int iWidth = stSource.iWidth;
+
+		ParallelRows(stSource.iHeight,iWidth,iThreads,[&](int iStart,int iEnd)
+		{
+			for (int i=iStart;i<iEnd;i++)
+			{
+				size_t iPlace = (size_t) i*iWidth;
+				stKernels.DeinterleaveRow(stSource.Row(i),fDest.fRed+iPlace,fDest.fGreen+iPlace,fDest.fBlue+iPlace,iWidth);
+			}
+		});
+		return true;
+	}
+
+	// ConverttoFloat() -- Convert a 24-bit bitmap to a new float bitmap (RawBitmap_t::ConverttoFloat()).  Free it with DeleteFloatBitmap().
+	//
+	[[nodiscard]] inline FloatBitmap_t ConverttoFloat(const Bitmap_t & stSource,int iThreads = 1,bool * bSuccess = nullptr)
+	{
+		FloatBitmap_t fDest = stSource.isValid() ? CreateFloatBitmap(stSource.iWidth,stSource.iHeight) : FloatBitmap_t{};
+		bool bResult = fDest.isValid() && ConverttoFloat(stSource,fDest,iThreads);
+		if (!bResult) DeleteFloatBitmap(fDest);
+		if (bSuccess) *bSuccess = bResult;
+		return fDest;
+	}
+
+}; // namespace Core
+}; // namespace Sage
+#endif // _CFloatKernels_H_
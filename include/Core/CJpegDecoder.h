@@ -0,0 +1,930 @@
+//#pragma once
+#if !defined(_CJpegDecoder_H_)
+#define _CJpegDecoder_H_
+
+// ---------------------------------------------------------------
+// CJpegDecoder.H -- Re-entrant baseline JPEG decoder for Core code
+// ---------------------------------------------------------------
+//
+// Sage::CJpeg decodes behind a process-wide busy flag, so only one JPEG is decoded at a time and any other thread asking
+// for one sleeps until it is done.  CJpegDecoder keeps all of its state in the object, so any number of decoders can run at
+// once (one per thread).  A decoder can be reused for any number of images, and keeps its buffers between them, so a
+// thread working through a batch of images doesn't allocate for each one.
+//
+// Supported are baseline and extended sequential Huffman JPEGs (SOF0/SOF1) with 8-bit samples, grayscale, YCbCr or Adobe RGB,
+// any sampling factors and restart markers -- i.e. what cameras and most image editors write.  Chroma is upsampled by replication.
+//
+// Images can be decoded at 1/2, 1/4 or 1/8 size (see SetScale()).  The reduction is done in the inverse DCT, as libjpeg does it,
+// so a thumbnail costs a fraction of the time and memory of a full decode.  Subsampled chroma is decoded at the next size up
+// (i.e. 2x2 samples per block for 4:2:0 at 1/8), so at reduced sizes it isn't replicated.
+//
+// Progressive, lossless, arithmetic-coded, 12-bit and CMYK JPEGs return JpegStatus::Unsupported, so the caller can fall back
+// to Sage::CJpeg.  ReadJpegFile() and ReadJpegFiles() in SageKernels.h do this.
+//
+// DecodeJpegFiles() decodes a list of files across the Core thread pool (see Core/CParallel.h), one file per task.
+//
+// To get the size of a JPEG without decoding it, use ProbeJpeg() or ProbeJpegFile() (see Core/CJpegInfo.h).
+//
+// Usage:
+//
+//		CJpegDecoder cDecoder;
+//		if (cDecoder.ReadHeaderFile("photo.jpg") == JpegStatus::Ok)
+//		{
+//			Bitmap_t stBitmap = CreateBitmap(cDecoder.GetWidth(),cDecoder.GetHeight());
+//			cDecoder.Decode(stBitmap);
+//		}
+//
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "SageCore.h"
+#include "CParallel.h"
+#include "CJpegInfo.h"
+
+namespace Sage
+{
+namespace Core
+{
+	// kJpegZigzag -- Natural (row-major) position of each coefficient in zigzag order
+
+	static constexpr unsigned char kJpegZigzag[64] =
+	{
+		 0, 1, 8,16, 9, 2, 3,10,17,24,32,25,18,11, 4, 5,
+		12,19,26,33,40,48,41,34,27,20,13, 6, 7,14,21,28,
+		35,42,49,56,57,50,43,36,29,22,15,23,30,37,44,51,
+		58,59,52,45,38,31,39,46,53,60,61,54,47,55,62,63,
+	};
+
+	static constexpr int kJpegFastBits		= 9;				// Huffman codes up to this length are decoded with one table lookup
+	static constexpr long long kJpegMaxPixels	= 1 << 28;		// Largest image accepted (256M pixels)
+
+	// JpegClamp() -- Clamp to 0-255
+
+	static inline unsigned char JpegClamp(int iValue) { return (unsigned char) (iValue < 0 ? 0 : iValue > 255 ? 255 : iValue); }
+
+	// JpegSaturate() -- Clamp to +/- iMax.  Coefficients of a valid file never reach the limits it is used with; a damaged file can
+	// give any value, and the limits keep the integer IDCT from overflowing on them.
+	//
+	static constexpr int kJpegMaxCoef	= 32767;		// Dequantized coefficients (and DC predictions) -- the range of a short
+	static constexpr int kJpegMaxTemp	= 65535;		// Column pass outputs of JpegIdctBlock(), so the row pass stays within an int
+
+	static inline int JpegSaturate(int iValue,int iMax) { return iValue < -iMax ? -iMax : iValue > iMax ? iMax : iValue; }
+
+	// JpegIdct8() -- One 8-point pass of the integer inverse DCT (the accurate "islow" form), with 12-bit fixed-point constants.
+	// The outputs are scaled by 1 << 12 (plus the 1 << 3 of the DCT itself); the caller rounds and shifts them down.
+	//
+	static inline void JpegIdct8(int s0,int s1,int s2,int s3,int s4,int s5,int s6,int s7,int * iOut)
+	{
+		// Even part
+
+		int p1 = (s2 + s6)*2217;									// 0.541196100
+		int t2 = p1 + s6*-7567;										// -1.847759065
+		int t3 = p1 + s2*3135;										// 0.765366865
+		int t0 = (s0 + s4)*4096;
+		int t1 = (s0 - s4)*4096;
+
+		int x0 = t0 + t3;
+		int x3 = t0 - t3;
+		int x1 = t1 + t2;
+		int x2 = t1 - t2;
+
+		// Odd part
+
+		int p3 = s7 + s3;
+		int p4 = s5 + s1;
+		int p5 = (p3 + p4)*4816;									// 1.175875602
+		int o0 = s7*1223;											// 0.298631336
+		int o1 = s5*8410;											// 2.053119869
+		int o2 = s3*12586;											// 3.072711026
+		int o3 = s1*6149;											// 1.501321110
+		int q1 = p5 + (s7 + s1)*-3685;								// -0.899976223
+		int q2 = p5 + (s5 + s3)*-10497;								// -2.562915447
+		p3 *= -8034;												// -1.961570560
+		p4 *= -1598;												// -0.390180644
+
+		o3 += q1 + p4;
+		o2 += q2 + p3;
+		o1 += q2 + p4;
+		o0 += q1 + p3;
+
+		iOut[0] = x0 + o3;	iOut[7] = x0 - o3;
+		iOut[1] = x1 + o2;	iOut[6] = x1 - o2;
+		iOut[2] = x2 + o1;	iOut[5] = x2 - o1;
+		iOut[3] = x3 + o0;	iOut[4] = x3 - o0;
+	}
+
+	// JpegIdctBlock() -- Inverse DCT of one dequantized 8x8 block (natural order) into 8x8 samples at sDest
+
+	static inline void JpegIdctBlock(const short * sCoef,unsigned char * sDest,int iStride)
+	{
+		int iTemp[64];
+		int iOut[8];
+
+		// Columns -- keep 2 extra bits of precision for the row pass
+
+		for (int i=0;i<8;i++)
+		{
+			const short * s = sCoef + i;
+			if (!(s[8] | s[16] | s[24] | s[32] | s[40] | s[48] | s[56]))
+			{
+				int iDC = JpegSaturate(s[0]*4,kJpegMaxTemp);
+				for (int j=0;j<8;j++) iTemp[j*8 + i] = iDC;
+				continue;
+			}
+			JpegIdct8(s[0],s[8],s[16],s[24],s[32],s[40],s[48],s[56],iOut);
+			for (int j=0;j<8;j++) iTemp[j*8 + i] = JpegSaturate((iOut[j] + 512) >> 10,kJpegMaxTemp);
+		}
+
+		// Rows -- remove the remaining 1 << 17, and add the 128 level shift before rounding
+
+		for (int i=0;i<8;i++,sDest += iStride)
+		{
+			const int * s = iTemp + i*8;
+			JpegIdct8(s[0],s[1],s[2],s[3],s[4],s[5],s[6],s[7],iOut);
+			for (int j=0;j<8;j++) sDest[j] = JpegClamp((iOut[j] + (1 << 16) + (128 << 17)) >> 17);
+		}
+	}
+
+	// JpegIdctReduced() -- n-point inverse DCT (n = 8, 4, 2 or 1) of the 8 coefficients s[0], s[iStep], ... s[7*iStep], for a
+	// decode at 8/n size.  Following libjpeg (jidctred.c), each output is the average of n adjacent outputs of the 8-point IDCT, so
+	// the odd coefficients are folded in rather than dropped.  The outputs are scaled by 1 << JpegReducedBits(n).
+	//
+	// The sums are 64-bit, so no coefficient can overflow them.
+	//
+	static constexpr int JpegReducedBits(int n) { return n == 8 ? 12 : n == 4 ? 14 : n == 2 ? 15 : 0; }
+
+	template <int n>
+	static inline void JpegIdctReduced(const long long * s,int iStep,long long * iOut)
+	{
+		if constexpr (n == 1)
+		{
+			iOut[0] = s[0];
+		}
+		else if constexpr (n == 2)
+		{
+			long long s0 = s[0], s1 = s[iStep], s3 = s[3*iStep], s5 = s[5*iStep], s7 = s[7*iStep];
+			long long e = s0*32768;
+			long long o = s7*-5906 + s5*6967 + s3*-10426 + s1*29692;		// 13-bit constants, as libjpeg's jpeg_idct_2x2()
+			iOut[0] = e + o;	iOut[1] = e - o;
+		}
+		else if constexpr (n == 4)
+		{
+			// 13-bit constants, as libjpeg's jpeg_idct_4x4() (s[4*iStep] doesn't contribute)
+
+			long long s0 = s[0], s1 = s[iStep], s2 = s[2*iStep], s3 = s[3*iStep], s5 = s[5*iStep], s6 = s[6*iStep], s7 = s[7*iStep];
+			long long e0 = s0*16384;
+			long long e2 = s2*15137 + s6*-6270;
+			long long o0 = s7*-1730 + s5*11893 + s3*-17799 + s1*8697;
+			long long o2 = s7*-4176 + s5*-4926 + s3*7373 + s1*20995;
+			iOut[0] = e0 + e2 + o2;		iOut[3] = e0 + e2 - o2;
+			iOut[1] = e0 - e2 + o0;		iOut[2] = e0 - e2 - o0;
+		}
+		else
+		{
+			// 8 points -- JpegIdct8(), in 64 bits
+
+			static_assert(n == 8,"JpegIdctReduced() is for n = 8, 4, 2 or 1");
+			long long s0 = s[0], s1 = s[iStep], s2 = s[2*iStep], s3 = s[3*iStep], s4 = s[4*iStep], s5 = s[5*iStep], s6 = s[6*iStep], s7 = s[7*iStep];
+
+			long long p1 = (s2 + s6)*2217;
+			long long t2 = p1 + s6*-7567, t3 = p1 + s2*3135;
+			long long t0 = (s0 + s4)*4096, t1 = (s0 - s4)*4096;
+			long long x0 = t0 + t3, x3 = t0 - t3, x1 = t1 + t2, x2 = t1 - t2;
+
+			long long p3 = s7 + s3, p4 = s5 + s1;
+			long long p5 = (p3 + p4)*4816;
+			long long q1 = p5 + (s7 + s1)*-3685;
+			long long q2 = p5 + (s5 + s3)*-10497;
+			p3 *= -8034;
+			p4 *= -1598;
+			long long o0 = s7*1223 + q1 + p3;
+			long long o1 = s5*8410 + q2 + p4;
+			long long o2 = s3*12586 + q2 + p3;
+			long long o3 = s1*6149 + q1 + p4;
+
+			iOut[0] = x0 + o3;	iOut[7] = x0 - o3;
+			iOut[1] = x1 + o2;	iOut[6] = x1 - o2;
+			iOut[2] = x2 + o1;	iOut[5] = x2 - o1;
+			iOut[3] = x3 + o0;	iOut[4] = x3 - o0;
+		}
+	}
+
+	// JpegIdctBlockReduced() -- Inverse DCT of one dequantized 8x8 block into iW x iH samples (each 8, 4, 2 or 1) at sDest.
+	// Different widths and heights are used for chroma that is subsampled in one direction only (see CJpegDecoder::Decode()).
+	//
+	template <int iW,int iH>
+	static inline void JpegIdctBlockReduced(const short * sCoef,unsigned char * sDest,int iStride)
+	{
+		static constexpr int kShift = JpegReducedBits(iW) + JpegReducedBits(iH) + 3;
+		long long iColumn[8];
+		long long iTemp[iH*8];
+		long long iOut[8];
+
+		// Columns -- the row pass of an n-point IDCT doesn't use every column (i.e. the 2-point one uses 0, 1, 3, 5 and 7)
+
+		for (int i=0;i<8;i++)
+		{
+			if ((iW == 1 && i) || (iW == 2 && (i == 2 || i == 4 || i == 6)) || (iW == 4 && i == 4)) continue;
+			for (int j=0;j<8;j++) iColumn[j] = sCoef[j*8 + i];
+			JpegIdctReduced<iH>(iColumn,1,iOut);
+			for (int j=0;j<iH;j++) iTemp[j*8 + i] = iOut[j];
+		}
+
+		// Rows, with the 128 level shift
+
+		for (int i=0;i<iH;i++,sDest += iStride)
+		{
+			JpegIdctReduced<iW>(iTemp + i*8,1,iOut);
+			for (int j=0;j<iW;j++) sDest[j] = JpegClamp((int) ((iOut[j] + (1LL << (kShift-1))) >> kShift) + 128);
+		}
+	}
+
+	// -----------------------------------------
+	// CJpegDecoder -- Re-entrant JPEG decoder
+	// -----------------------------------------
+
+	class CJpegDecoder
+	{
+		using JpegIdct_t = void (*)(const short * sCoef,unsigned char * sDest,int iStride);
+
+		// JpegHuffman_t -- One Huffman table.  uiFast[] holds (length << 8) | value for codes up to kJpegFastBits long, 0 for longer codes.
+
+		struct JpegHuffman_t
+		{
+			unsigned short uiFast[1 << kJpegFastBits];
+			unsigned char ucValues[256];
+			unsigned int uiMaxCode[18];					// One past the last code of each length, left-aligned to 16 bits
+			int iDelta[17];								// Value index minus code, for each length
+			bool bValid;
+		};
+
+		struct JpegComponent_t
+		{
+			int iId;
+			int iH, iV;									// Sampling factors
+			int iQuant;									// Quantization table
+			int iDC, iAC;								// Huffman tables for the current scan
+			int iPred;									// DC predictor
+			int iStride;								// Plane width (a whole number of MCUs)
+			int iPlaneHeight;
+			int iBlockW, iBlockH;						// Samples per block across and down (see GetBlockSize())
+			JpegIdct_t fIdct;							// Inverse DCT for that block size
+			std::vector<unsigned char> vPlane;
+		};
+
+		const unsigned char * m_sPos	= nullptr;
+		const unsigned char * m_sEnd	= nullptr;
+		std::vector<unsigned char> m_vFile;				// File data for ReadHeaderFile()
+
+		unsigned short m_uiQuant[4][64];				// In zigzag order
+		JpegHuffman_t m_stHuffman[8];					// DC tables 0-3, then AC tables 0-3
+		JpegComponent_t m_stComponents[3];
+		int m_iScan[3];									// Components in the current scan
+		int m_iScanComponents	= 0;
+
+		int m_iWidth			= 0;						// Full image size
+		int m_iHeight			= 0;
+		int m_iScale			= 1;						// 1, 2, 4 or 8 (see SetScale())
+		int m_iBlock			= 8;						// Decoded block size: 8/m_iScale
+		int m_iOutWidth			= 0;						// Decoded (scaled) size
+		int m_iOutHeight		= 0;
+		int m_iComponents		= 0;
+		int m_iHMax				= 1;
+		int m_iVMax				= 1;
+		int m_iMcuX				= 0;
+		int m_iMcuY				= 0;
+		int m_iRestart			= 0;
+		int m_iAdobeTransform	= -1;					// -1 = no Adobe marker
+		bool m_bJfif			= false;
+		bool m_bHeader			= false;
+
+		// Entropy-coded data bit reader.  Bits are left-aligned in m_uiBits.
+
+		unsigned int m_uiBits	= 0;
+		int m_iBitCount			= 0;
+		bool m_bMarker			= false;				// Reached a marker -- zeros are fed from here on
+
+		std::vector<int> m_vXMap;						// Sample column of each output column, per component
+
+		// FillBits() -- Load bytes until there are at least 25 bits.  Stuffed zeros are removed; a marker stops the load.
+
+		void FillBits()
+		{
+			while (m_iBitCount <= 24)
+			{
+				unsigned int uiByte = 0;
+				if (!m_bMarker && m_sPos < m_sEnd)
+				{
+					uiByte = *m_sPos;
+					if (uiByte != 0xFF) m_sPos++;
+					else if (m_sPos + 1 < m_sEnd && !m_sPos[1]) m_sPos += 2;
+					else { m_bMarker = true; uiByte = 0; }
+				}
+				m_uiBits |= uiByte << (24 - m_iBitCount);
+				m_iBitCount += 8;
+			}
+		}
+
+		void ResetBits() { m_uiBits = 0; m_iBitCount = 0; m_bMarker = false; }
+
+		// DecodeHuffman() -- Next Huffman-coded value, or -1 for a bad code
+
+		int DecodeHuffman(const JpegHuffman_t & stTable)
+		{
+			if (m_iBitCount < 16) FillBits();
+
+			int iFast = stTable.uiFast[m_uiBits >> (32 - kJpegFastBits)];
+			if (iFast)
+			{
+				int iLength = iFast >> 8;
+				m_uiBits <<= iLength;
+				m_iBitCount -= iLength;
+				return iFast & 0xFF;
+			}
+
+			unsigned int uiTop = m_uiBits >> 16;
+			int iLength = kJpegFastBits + 1;
+			while (iLength <= 16 && uiTop >= stTable.uiMaxCode[iLength]) iLength++;
+			if (iLength > 16) return -1;
+
+			int iIndex = (int) (m_uiBits >> (32 - iLength)) + stTable.iDelta[iLength];
+			if (iIndex < 0 || iIndex > 255) return -1;
+			m_uiBits <<= iLength;
+			m_iBitCount -= iLength;
+			return stTable.ucValues[iIndex];
+		}
+
+		// Receive() -- Read an iBits-bit value (1-16) and sign-extend it as JPEG does (values below half are negative)
+
+		int Receive(int iBits)
+		{
+			if (m_iBitCount < iBits) FillBits();
+			unsigned int uiValue = m_uiBits >> (32 - iBits);
+			m_uiBits <<= iBits;
+			m_iBitCount -= iBits;
+			return uiValue < (1u << (iBits-1)) ? (int) uiValue - (1 << iBits) + 1 : (int) uiValue;
+		}
+
+		static bool BuildHuffman(JpegHuffman_t & stTable,const unsigned char * ucCounts,const unsigned char * ucValues,int iValues)
+		{
+			memcpy(stTable.ucValues,ucValues,iValues);
+			memset(stTable.uiFast,0,sizeof(stTable.uiFast));
+
+			unsigned int uiCode = 0;
+			int iIndex = 0;
+			for (int iLength=1;iLength<=16;iLength++)
+			{
+				stTable.iDelta[iLength] = iIndex - (int) uiCode;
+				for (int i=0;i<ucCounts[iLength-1];i++,iIndex++,uiCode++)
+				{
+					if (uiCode >= (1u << iLength)) return false;				// Over-subscribed
+					if (iLength > kJpegFastBits) continue;
+					int iShift = kJpegFastBits - iLength;
+					for (int j=0;j<(1 << iShift);j++) stTable.uiFast[(uiCode << iShift) + j] = (unsigned short) ((iLength << 8) | ucValues[iIndex]);
+				}
+				stTable.uiMaxCode[iLength] = uiCode << (16 - iLength);
+				uiCode <<= 1;
+			}
+			stTable.uiMaxCode[17] = 0xFFFFFFFF;
+			stTable.bValid = true;
+			return true;
+		}
+
+		// Segment reading.  The read functions return false for a segment that runs past the end of the data.
+
+		int ReadWord(const unsigned char * s) { return (s[0] << 8) | s[1]; }
+
+		bool ReadQuant(const unsigned char * s,int iLength)
+		{
+			while (iLength > 0)
+			{
+				int iPrecision	= s[0] >> 4;
+				int iTable		= s[0] & 15;
+				int iSize		= 1 + (iPrecision ? 128 : 64);
+				if (iTable > 3 || iPrecision > 1 || iSize > iLength) return false;
+				for (int i=0;i<64;i++) m_uiQuant[iTable][i] = (unsigned short) (iPrecision ? ReadWord(s + 1 + i*2) : s[1+i]);
+				s += iSize;
+				iLength -= iSize;
+			}
+			return true;
+		}
+
+		bool ReadHuffman(const unsigned char * s,int iLength)
+		{
+			while (iLength > 0)
+			{
+				if (iLength < 17) return false;
+				int iClass = s[0] >> 4;
+				int iTable = s[0] & 15;
+				if (iClass > 1 || iTable > 3) return false;
+
+				int iValues = 0;
+				for (int i=0;i<16;i++) iValues += s[1+i];
+				if (iValues > 256 || 17 + iValues > iLength) return false;
+				if (!BuildHuffman(m_stHuffman[iClass*4 + iTable],s + 1,s + 17,iValues)) return false;
+				s += 17 + iValues;
+				iLength -= 17 + iValues;
+			}
+			return true;
+		}
+
+		JpegStatus ReadFrame(const unsigned char * s,int iLength)
+		{
+			if (iLength < 6) return JpegStatus::Error;
+			if (s[0] != 8) return JpegStatus::Unsupported;						// 12-bit samples
+
+			m_iHeight		= ReadWord(s + 1);
+			m_iWidth		= ReadWord(s + 3);
+			m_iComponents	= s[5];
+			if (!m_iHeight) return JpegStatus::Unsupported;					// Height set later by a DNL marker
+			if (!m_iWidth || (long long) m_iWidth*m_iHeight > kJpegMaxPixels) return JpegStatus::Error;
+			if (m_iComponents != 1 && m_iComponents != 3) return JpegStatus::Unsupported;
+			if (iLength < 6 + m_iComponents*3) return JpegStatus::Error;
+
+			m_iHMax = m_iVMax = 1;
+			for (int i=0;i<m_iComponents;i++)
+			{
+				auto & stComp = m_stComponents[i];
+				stComp.iId		= s[6 + i*3];
+				stComp.iH		= s[7 + i*3] >> 4;
+				stComp.iV		= s[7 + i*3] & 15;
+				stComp.iQuant	= s[8 + i*3];
+				if (stComp.iH < 1 || stComp.iH > 4 || stComp.iV < 1 || stComp.iV > 4 || stComp.iQuant > 3) return JpegStatus::Error;
+				if (stComp.iH > m_iHMax) m_iHMax = stComp.iH;
+				if (stComp.iV > m_iVMax) m_iVMax = stComp.iV;
+			}
+
+			// A single-component image is coded in 8x8 blocks whatever its sampling factors say
+
+			if (m_iComponents == 1) m_stComponents[0].iH = m_stComponents[0].iV = m_iHMax = m_iVMax = 1;
+
+			m_iMcuX			= (m_iWidth  + m_iHMax*8 - 1)/(m_iHMax*8);
+			m_iMcuY			= (m_iHeight + m_iVMax*8 - 1)/(m_iVMax*8);
+			m_iOutWidth		= m_iWidth;
+			m_iOutHeight	= m_iHeight;
+			return JpegStatus::Ok;
+		}
+
+		bool ReadScan(const unsigned char * s,int iLength)
+		{
+			m_iScanComponents = iLength > 0 ? s[0] : 0;
+			if (m_iScanComponents < 1 || m_iScanComponents > m_iComponents || iLength < 4 + m_iScanComponents*2) return false;
+
+			for (int i=0;i<m_iScanComponents;i++)
+			{
+				int iId = s[1 + i*2];
+				int iComp = 0;
+				while (iComp < m_iComponents && m_stComponents[iComp].iId != iId) iComp++;
+				if (iComp == m_iComponents) return false;
+
+				auto & stComp = m_stComponents[iComp];
+				stComp.iDC = s[2 + i*2] >> 4;
+				stComp.iAC = 4 + (s[2 + i*2] & 15);
+				if (stComp.iDC > 3 || stComp.iAC > 7 || !m_stHuffman[stComp.iDC].bValid || !m_stHuffman[stComp.iAC].bValid) return false;
+				m_iScan[i] = iComp;
+			}
+			return true;
+		}
+
+		// NextMarker() -- Find the next marker from m_sPos, skipping any stray bytes and fill bytes.  Returns 0 at the end of the data.
+
+		int NextMarker()
+		{
+			while (m_sPos + 1 < m_sEnd)
+			{
+				if (m_sPos[0] == 0xFF && m_sPos[1] && m_sPos[1] != 0xFF)
+				{
+					int iMarker = m_sPos[1];
+					m_sPos += 2;
+					return iMarker;
+				}
+				m_sPos++;
+			}
+			m_sPos = m_sEnd;
+			return 0;
+		}
+
+		// Restart() -- Reset the bit reader and DC predictors at a restart marker
+
+		void Restart()
+		{
+			ResetBits();
+			while (m_sPos + 1 < m_sEnd)
+			{
+				if (m_sPos[0] == 0xFF && m_sPos[1] >= 0xD0 && m_sPos[1] <= 0xD7) { m_sPos += 2; break; }
+				if (m_sPos[0] == 0xFF && m_sPos[1] && m_sPos[1] != 0xFF) break;		// Some other marker -- the data is damaged
+				m_sPos++;
+			}
+			for (int i=0;i<m_iComponents;i++) m_stComponents[i].iPred = 0;
+		}
+
+		// GetIdct() -- The inverse DCT giving iW x iH samples per block (each 8, 4, 2 or 1)
+
+		static JpegIdct_t GetIdct(int iW,int iH)
+		{
+			static const JpegIdct_t fIdct[4][4] =
+			{
+				{ JpegIdctBlockReduced<1,1>, JpegIdctBlockReduced<2,1>, JpegIdctBlockReduced<4,1>, JpegIdctBlockReduced<8,1> },
+				{ JpegIdctBlockReduced<1,2>, JpegIdctBlockReduced<2,2>, JpegIdctBlockReduced<4,2>, JpegIdctBlockReduced<8,2> },
+				{ JpegIdctBlockReduced<1,4>, JpegIdctBlockReduced<2,4>, JpegIdctBlockReduced<4,4>, JpegIdctBlockReduced<8,4> },
+				{ JpegIdctBlockReduced<1,8>, JpegIdctBlockReduced<2,8>, JpegIdctBlockReduced<4,8>, JpegIdctBlock },
+			};
+			auto fLog2 = [](int n) { return n == 8 ? 3 : n == 4 ? 2 : n == 2 ? 1 : 0; };
+			return fIdct[fLog2(iH)][fLog2(iW)];
+		}
+
+		// GetBlockSize() -- Samples per block, across or down, for a component with sampling factor iFactor of iMax.
+		// Subsampled components are decoded at a larger size than m_iBlock (up to 8), so they come out at the scaled output resolution
+		// instead of being replicated up to it.  This needs the subsampling to be 2x or 4x; other ratios use m_iBlock.
+		//
+		int GetBlockSize(int iFactor,int iMax) const
+		{
+			if (iMax % iFactor) return m_iBlock;
+			int iRatio = iMax/iFactor;
+			if (iRatio != 1 && iRatio != 2 && iRatio != 4) return m_iBlock;
+			return m_iBlock*iRatio < 8 ? m_iBlock*iRatio : 8;
+		}
+
+		// DecodeBlock() -- Decode and dequantize one 8x8 block into sCoef (natural order)
+
+		bool DecodeBlock(short * sCoef,JpegComponent_t & stComp)
+		{
+			memset(sCoef,0,64*sizeof(short));
+			const unsigned short * uiQuant = m_uiQuant[stComp.iQuant];
+
+			int iBits = DecodeHuffman(m_stHuffman[stComp.iDC]);
+			if (iBits < 0 || iBits > 16) return false;
+			if (iBits) stComp.iPred = JpegSaturate(stComp.iPred + Receive(iBits),kJpegMaxCoef);
+			sCoef[0] = (short) JpegSaturate(stComp.iPred*uiQuant[0],kJpegMaxCoef);
+
+			const JpegHuffman_t & stAC = m_stHuffman[stComp.iAC];
+			for (int k=1;k<64;)
+			{
+				int iCode = DecodeHuffman(stAC);
+				if (iCode < 0) return false;
+				int iSize	= iCode & 15;
+				int iRun	= iCode >> 4;
+				if (!iSize)
+				{
+					if (iRun != 15) break;				// End of block
+					k += 16;
+					continue;
+				}
+				k += iRun;
+				if (k > 63) return false;
+				sCoef[kJpegZigzag[k]] = (short) JpegSaturate(Receive(iSize)*uiQuant[k],kJpegMaxCoef);		// Fits an int: 15 bits by 16
+				k++;
+			}
+			return true;
+		}
+
+		// DecodeScan() -- Decode the entropy-coded data of one scan into the component planes
+
+		bool DecodeScan()
+		{
+			short sCoef[64];
+			ResetBits();
+			for (int i=0;i<m_iComponents;i++) m_stComponents[i].iPred = 0;
+
+			// A single-component scan is coded block by block over just the component's own area, not in MCUs
+
+			int iUnitsX = m_iMcuX;
+			int iUnitsY = m_iMcuY;
+			if (m_iScanComponents == 1)
+			{
+				auto & stComp = m_stComponents[m_iScan[0]];
+				iUnitsX = ((m_iWidth*stComp.iH + m_iHMax - 1)/m_iHMax + 7)/8;
+				iUnitsY = ((m_iHeight*stComp.iV + m_iVMax - 1)/m_iVMax + 7)/8;
+			}
+
+			int iRestartLeft = m_iRestart;
+			for (int iY=0;iY<iUnitsY;iY++)
+				for (int iX=0;iX<iUnitsX;iX++)
+				{
+					if (m_iScanComponents == 1)
+					{
+						auto & stComp = m_stComponents[m_iScan[0]];
+						if (!DecodeBlock(sCoef,stComp)) return false;
+						stComp.fIdct(sCoef,stComp.vPlane.data() + (size_t) iY*stComp.iBlockH*stComp.iStride + iX*stComp.iBlockW,stComp.iStride);
+					}
+					else
+					{
+						for (int i=0;i<m_iScanComponents;i++)
+						{
+							auto & stComp = m_stComponents[m_iScan[i]];
+							for (int iBlockY=0;iBlockY<stComp.iV;iBlockY++)
+								for (int iBlockX=0;iBlockX<stComp.iH;iBlockX++)
+								{
+									if (!DecodeBlock(sCoef,stComp)) return false;
+									size_t iRow = (size_t) (iY*stComp.iV + iBlockY)*stComp.iBlockH;
+									stComp.fIdct(sCoef,stComp.vPlane.data() + iRow*stComp.iStride + (iX*stComp.iH + iBlockX)*stComp.iBlockW,stComp.iStride);
+								}
+						}
+					}
+					if (m_iRestart && !--iRestartLeft)
+					{
+						Restart();
+						iRestartLeft = m_iRestart;
+					}
+				}
+			return true;
+		}
+
+		// ConvertRows() -- Upsample and color-convert the component planes into stDest
+
+		void ConvertRows(Bitmap_t & stDest)
+		{
+			// Column map for each component, so any sampling factors and block sizes work the same way.  A component decoded at
+			// iBlockW samples per block has iH*iBlockW/(m_iHMax*m_iBlock) plane columns per output column (1 unless replicated).
+
+			m_vXMap.resize((size_t) m_iOutWidth*m_iComponents);
+			for (int i=0;i<m_iComponents;i++)
+			{
+				auto & stComp = m_stComponents[i];
+				for (int iX=0;iX<m_iOutWidth;iX++) m_vXMap[(size_t) i*m_iOutWidth + iX] = iX*stComp.iH*stComp.iBlockW/(m_iHMax*m_iBlock);
+			}
+
+			bool bRGB = m_iComponents == 3 && (m_iAdobeTransform == 0 ||
+						(!m_bJfif && m_iAdobeTransform < 0 && m_stComponents[0].iId == 'R' && m_stComponents[1].iId == 'G' && m_stComponents[2].iId == 'B'));
+
+			for (int iY=0;iY<m_iOutHeight;iY++)
+			{
+				unsigned char * sDest = stDest.Row(iY);
+				const unsigned char * sRow[3];
+				for (int i=0;i<m_iComponents;i++)
+				{
+					auto & stComp = m_stComponents[i];
+					sRow[i] = stComp.vPlane.data() + (size_t) (iY*stComp.iV*stComp.iBlockH/(m_iVMax*m_iBlock))*stComp.iStride;
+				}
+
+				if (m_iComponents == 1)
+				{
+					for (int iX=0;iX<m_iOutWidth;iX++,sDest += 3) sDest[0] = sDest[1] = sDest[2] = sRow[0][iX];
+					continue;
+				}
+
+				const int * iMap1 = m_vXMap.data() + m_iOutWidth;
+				const int * iMap2 = m_vXMap.data() + 2*m_iOutWidth;
+
+				if (bRGB)
+				{
+					for (int iX=0;iX<m_iOutWidth;iX++,sDest += 3)
+					{
+						sDest[0] = sRow[2][iMap2[iX]];
+						sDest[1] = sRow[1][iMap1[iX]];
+						sDest[2] = sRow[0][m_vXMap[iX]];
+					}
+					continue;
+				}
+
+				// YCbCr -> RGB with 16-bit fixed-point constants (JFIF/ITU-R BT.601, full range)
+
+				for (int iX=0;iX<m_iOutWidth;iX++,sDest += 3)
+				{
+					int iLuma	= sRow[0][m_vXMap[iX]];
+					int iCb		= sRow[1][iMap1[iX]] - 128;
+					int iCr		= sRow[2][iMap2[iX]] - 128;
+					sDest[0] = JpegClamp(iLuma + ((116130*iCb + 32768) >> 16));
+					sDest[1] = JpegClamp(iLuma + ((-22554*iCb - 46802*iCr + 32768) >> 16));
+					sDest[2] = JpegClamp(iLuma + ((91881*iCr + 32768) >> 16));
+				}
+			}
+		}
+
+	public:
+
+		// ReadHeader() -- Read the markers up to the first scan.  After this, GetWidth() and GetHeight() give the image size.
+		// sData must stay valid until Decode() is called.
+		//
+		JpegStatus ReadHeader(const unsigned char * sData,size_t iLength)
+		{
+			m_bHeader			= false;
+			m_iWidth			= m_iHeight = 0;
+			m_iOutWidth			= m_iOutHeight = 0;
+			m_iScale			= 1;
+			m_iBlock			= 8;
+			m_iRestart			= 0;
+			m_iAdobeTransform	= -1;
+			m_bJfif				= false;
+			for (auto & stTable : m_stHuffman) stTable.bValid = false;
+
+			if (!sData || !iLength) return JpegStatus::FileLengthZero;
+			if (iLength < 4 || sData[0] != 0xFF || sData[1] != 0xD8) return JpegStatus::Error;
+
+			m_sPos	= sData + 2;
+			m_sEnd	= sData + iLength;
+
+			bool bFrame = false;
+			for (;;)
+			{
+				const unsigned char * sMarker = m_sPos;
+				int iMarker = NextMarker();
+				if (!iMarker || iMarker == 0xD9) return JpegStatus::Error;					// No image data
+				if (iMarker >= 0xD0 && iMarker <= 0xD7) continue;							// Stray restart marker
+
+				if (m_sPos + 2 > m_sEnd) return JpegStatus::Error;
+				int iSegment = ReadWord(m_sPos) - 2;
+				const unsigned char * s = m_sPos + 2;
+				if (iSegment < 0 || s + iSegment > m_sEnd) return JpegStatus::Error;
+				m_sPos = s + iSegment;
+
+				switch (iMarker)
+				{
+					case 0xC0:		// Baseline
+					case 0xC1:		// Extended sequential
+					{
+						if (bFrame) return JpegStatus::Error;
+						JpegStatus eStatus = ReadFrame(s,iSegment);
+						if (eStatus != JpegStatus::Ok) return eStatus;
+						bFrame = true;
+						break;
+					}
+					case 0xC4: if (!ReadHuffman(s,iSegment)) return JpegStatus::Error; break;
+					case 0xDB: if (!ReadQuant(s,iSegment)) return JpegStatus::Error; break;
+					case 0xDD: if (iSegment < 2) return JpegStatus::Error; m_iRestart = ReadWord(s); break;
+					case 0xE0: if (iSegment >= 5 && !memcmp(s,"JFIF",5)) m_bJfif = true; break;
+					case 0xEE: if (iSegment >= 12 && !memcmp(s,"Adobe",5)) m_iAdobeTransform = s[11]; break;
+					case 0xDA:
+						if (!bFrame) return JpegStatus::Error;
+						m_sPos = sMarker;				// Decode() starts from the first scan
+						m_bHeader = true;
+						return JpegStatus::Ok;
+					default:
+						if (isJpegFrame(iMarker)) return JpegStatus::Unsupported;		// Progressive, lossless or arithmetic-coded
+						break;					// APPn, COM, etc.
+				}
+			}
+		}
+
+		// ReadHeaderFile() -- Read a file into the decoder's own buffer, then call ReadHeader()
+
+		JpegStatus ReadHeaderFile(const char * sPath)
+		{
+			m_bHeader = false;
+			if (!sPath || !*sPath) return JpegStatus::EmptyFilePath;
+
+			FILE * fp = fopen(sPath,"rb");
+			if (!fp) return JpegStatus::FileNotFound;
+
+			fseek(fp,0,SEEK_END);
+			long iSize = ftell(fp);
+			fseek(fp,0,SEEK_SET);
+			if (iSize <= 0) { fclose(fp); return JpegStatus::FileLengthZero; }
+
+			m_vFile.resize((size_t) iSize);
+			bool bRead = fread(m_vFile.data(),1,(size_t) iSize,fp) == (size_t) iSize;
+			fclose(fp);
+			if (!bRead) return JpegStatus::Error;
+
+			return ReadHeader(m_vFile.data(),m_vFile.size());
+		}
+
+		// GetWidth()/GetHeight() -- Size of the decoded bitmap, at the current scale.  GetImageWidth()/GetImageHeight() give the full size.
+
+		int GetWidth() const		{ return m_iOutWidth; }
+		int GetHeight() const		{ return m_iOutHeight; }
+		int GetImageWidth() const	{ return m_iWidth; }
+		int GetImageHeight() const	{ return m_iHeight; }
+		int GetComponents() const	{ return m_iComponents; }
+		int GetScale() const		{ return m_iScale; }
+
+		// SetScale() -- Decode at 1/iScale size (iScale = 1, 2, 4 or 8), rounded up.  Call after ReadHeader(), which resets the scale to 1.
+
+		bool SetScale(int iScale)
+		{
+			if (iScale != 1 && iScale != 2 && iScale != 4 && iScale != 8) return false;
+			m_iScale		= iScale;
+			m_iBlock		= 8/iScale;
+			m_iOutWidth		= (m_iWidth  + iScale - 1)/iScale;
+			m_iOutHeight	= (m_iHeight + iScale - 1)/iScale;
+			return true;
+		}
+
+		// GetScaleFor() -- Largest scale (1, 2, 4 or 8) that still decodes an iWidth x iHeight image to at least iMinWidth x iMinHeight,
+		// so it can then be resized down to that size without losing detail.
+		//
+		static int GetScaleFor(int iWidth,int iHeight,int iMinWidth,int iMinHeight)
+		{
+			int iScale = 8;
+			while (iScale > 1 && ((iWidth + iScale - 1)/iScale < iMinWidth || (iHeight + iScale - 1)/iScale < iMinHeight)) iScale /= 2;
+			return iScale;
+		}
+
+		// Decode() -- Decode the image from the last ReadHeader() into stDest, which must be GetWidth() x GetHeight() (the scaled size).
+		// Data cut short decodes as far as it goes; the rest of the image is gray.
+		//
+		JpegStatus Decode(Bitmap_t & stDest)
+		{
+			if (!m_bHeader) return JpegStatus::Error;
+			if (!stDest.isValid() || stDest.iWidth != m_iOutWidth || stDest.iHeight != m_iOutHeight) return JpegStatus::Error;
+			m_bHeader = false;
+
+			for (int i=0;i<m_iComponents;i++)
+			{
+				auto & stComp = m_stComponents[i];
+				stComp.iBlockW		= GetBlockSize(stComp.iH,m_iHMax);
+				stComp.iBlockH		= GetBlockSize(stComp.iV,m_iVMax);
+				stComp.fIdct		= GetIdct(stComp.iBlockW,stComp.iBlockH);
+				stComp.iStride		= m_iMcuX*stComp.iH*stComp.iBlockW;
+				stComp.iPlaneHeight	= m_iMcuY*stComp.iV*stComp.iBlockH;
+				stComp.vPlane.assign((size_t) stComp.iStride*stComp.iPlaneHeight,128);
+			}
+
+			// Scans, plus any tables between them, until EOI or the end of the data
+
+			bool bScan = false;
+			for (;;)
+			{
+				int iMarker = NextMarker();
+				if (!iMarker || iMarker == 0xD9) break;
+				if (iMarker >= 0xD0 && iMarker <= 0xD7) continue;
+
+				if (m_sPos + 2 > m_sEnd) break;
+				int iSegment = ReadWord(m_sPos) - 2;
+				const unsigned char * s = m_sPos + 2;
+				if (iSegment < 0 || s + iSegment > m_sEnd) break;
+				m_sPos = s + iSegment;
+
+				bool bResult = true;
+				switch (iMarker)
+				{
+					case 0xC4: bResult = ReadHuffman(s,iSegment); break;
+					case 0xDB: bResult = ReadQuant(s,iSegment); break;
+					case 0xDD: bResult = iSegment >= 2; if (bResult) m_iRestart = ReadWord(s); break;
+					case 0xDA:
+						bResult = ReadScan(s,iSegment) && DecodeScan();
+						bScan |= bResult;
+						break;
+					default: break;
+				}
+				if (!bResult) break;
+			}
+			if (!bScan) return JpegStatus::Error;
+
+			ConvertRows(stDest);
+			return JpegStatus::Ok;
+		}
+	};
+
+	// GetThreadJpegDecoder() -- A decoder for the calling thread, so batch decoding reuses one set of buffers per thread
+
+	inline CJpegDecoder & GetThreadJpegDecoder() { thread_local CJpegDecoder cDecoder; return cDecoder; }
+
+	// DecodeJpeg() -- Decode a JPEG in memory to a new bitmap (free it with DeleteBitmap()), at 1/iScale size (1, 2, 4 or 8).
+	// The bitmap is empty (isValid() == false) on failure, and *eStatus says why.
+	//
+	inline Bitmap_t DecodeJpeg(const unsigned char * sData,size_t iLength,JpegStatus * eStatus = nullptr,int iScale = 1)
+	{
+		CJpegDecoder & cDecoder = GetThreadJpegDecoder();
+		Bitmap_t stBitmap = {};
+
+		JpegStatus eResult = cDecoder.ReadHeader(sData,iLength);
+		if (eResult == JpegStatus::Ok && !cDecoder.SetScale(iScale)) eResult = JpegStatus::Error;
+		if (eResult == JpegStatus::Ok)
+		{
+			stBitmap = CreateBitmap(cDecoder.GetWidth(),cDecoder.GetHeight());
+			eResult = stBitmap.isValid() ? cDecoder.Decode(stBitmap) : JpegStatus::Error;
+			if (eResult != JpegStatus::Ok) DeleteBitmap(stBitmap);
+		}
+		if (eStatus) *eStatus = eResult;
+		return stBitmap;
+	}
+
+	// DecodeJpegFile() -- Decode a JPEG file to a new bitmap (free it with DeleteBitmap()).  See DecodeJpeg().
+
+	inline Bitmap_t DecodeJpegFile(const char * sPath,JpegStatus * eStatus = nullptr,int iScale = 1)
+	{
+		CJpegDecoder & cDecoder = GetThreadJpegDecoder();
+		Bitmap_t stBitmap = {};
+
+		JpegStatus eResult = cDecoder.ReadHeaderFile(sPath);
+		if (eResult == JpegStatus::Ok && !cDecoder.SetScale(iScale)) eResult = JpegStatus::Error;
+		if (eResult == JpegStatus::Ok)
+		{
+			stBitmap = CreateBitmap(cDecoder.GetWidth(),cDecoder.GetHeight());
+			eResult = stBitmap.isValid() ? cDecoder.Decode(stBitmap) : JpegStatus::Error;
+			if (eResult != JpegStatus::Ok) DeleteBitmap(stBitmap);
+		}
+		if (eStatus) *eStatus = eResult;
+		return stBitmap;
+	}
+
+	// DecodeJpegFiles() -- Decode a list of JPEG files on up to iThreads threads (0 = every thread in the Core thread pool).
+	// Returns one bitmap per file, in the same order; files that fail are empty bitmaps, with the reason in vStatus (if given).
+	// Free the bitmaps with DeleteBitmap().
+	//
+	inline std::vector<Bitmap_t> DecodeJpegFiles(const std::vector<std::string> & vPaths,int iThreads = 0,std::vector<JpegStatus> * vStatus = nullptr)
+	{
+		std::vector<Bitmap_t> vBitmaps(vPaths.size());
+		std::vector<JpegStatus> vResults(vPaths.size());
+
+		auto fTile = [&](int iFile) { vBitmaps[iFile] = DecodeJpegFile(vPaths[iFile].c_str(),&vResults[iFile]); };
+		GetThreadPool().Run((int) vPaths.size(),GetThreadCount(iThreads),fTile);
+
+		if (vStatus) *vStatus = std::move(vResults);
+		return vBitmaps;
+	}
+
+}; // namespace Core
+}; // namespace Sage
+#endif // _CJpegDecoder_H_
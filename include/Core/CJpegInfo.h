@@ -0,0 +1,154 @@
+//#pragma once
+#if !defined(_CJpegInfo_H_)
+#define _CJpegInfo_H_
+
+// --------------------------------------------------------
+// CJpegInfo.H -- JPEG header probe (no pixels are decoded)
+// --------------------------------------------------------
+//
+// ProbeJpeg() and ProbeJpegFile() find a JPEG's frame (SOF) header and return its size, number of components and whether
+// it is progressive.  Only the marker segments before the frame header are walked -- nothing is decoded -- so this takes
+// microseconds, i.e. for laying out a gallery before any image is loaded.
+//
+// ProbeJpegFile() skips over the segments with fseek() rather than reading them, so large EXIF blocks and embedded
+// thumbnails in front of the frame header are not read from the disk.
+//
+#include <stdio.h>
+#include "SageCore.h"
+
+namespace Sage
+{
+namespace Core
+{
+	// JpegStatus -- The same values as Sage::CJpeg::Status, plus Unsupported for JPEG types CJpegDecoder doesn't handle
+
+	enum class JpegStatus
+	{
+		Ok,
+		EmptyFilePath,
+		FileNotFound,
+		FileLengthZero,
+		Error,
+		Unsupported,
+	};
+
+	// JpegInfo_t -- Image information from the frame header
+
+	struct JpegInfo_t
+	{
+		int iWidth;
+		int iHeight;
+		int iComponents;			// 1 = grayscale, 3 = color, 4 = CMYK
+		int iPrecision;				// Bits per sample (8 or 12)
+		bool bProgressive;
+		bool bDecodable;			// Can be decoded by Core::CJpegDecoder (otherwise only by Sage::CJpeg)
+	};
+
+	// isJpegFrame() -- True for the SOF markers (0xC0-0xCF, except DHT, JPG and DAC)
+
+	static constexpr bool isJpegFrame(int iMarker) { return iMarker >= 0xC0 && iMarker <= 0xCF && iMarker != 0xC4 && iMarker != 0xC8 && iMarker != 0xCC; }
+
+	// isJpegStandalone() -- True for markers with no length or data following them (SOI, RSTn, TEM)
+
+	static constexpr bool isJpegStandalone(int iMarker) { return iMarker == 0xD8 || (iMarker >= 0xD0 && iMarker <= 0xD7) || iMarker == 0x01; }
+
+	// ReadJpegFrameInfo() -- Fill stInfo from the data of a frame header (the 6 bytes after the segment length)
+
+	static inline void ReadJpegFrameInfo(int iMarker,const unsigned char * s,JpegInfo_t & stInfo)
+	{
+		stInfo.iPrecision	= s[0];
+		stInfo.iHeight		= (s[1] << 8) | s[2];
+		stInfo.iWidth		= (s[3] << 8) | s[4];
+		stInfo.iComponents	= s[5];
+		stInfo.bProgressive	= iMarker == 0xC2 || iMarker == 0xC6 || iMarker == 0xCA || iMarker == 0xCE;
+		stInfo.bDecodable	= (iMarker == 0xC0 || iMarker == 0xC1) && stInfo.iPrecision == 8 && stInfo.iHeight > 0 &&
+							  (stInfo.iComponents == 1 || stInfo.iComponents == 3);
+	}
+
+	// ProbeJpeg() -- Read the frame header of a JPEG in memory.  Returns JpegStatus::Error if the data isn't a JPEG or
+	// ends before the frame header.
+	//
+	inline JpegStatus ProbeJpeg(const unsigned char * sData,size_t iLength,JpegInfo_t & stInfo)
+	{
+		stInfo = {};
+		if (!sData || !iLength) return JpegStatus::FileLengthZero;
+		if (iLength < 4 || sData[0] != 0xFF || sData[1] != 0xD8) return JpegStatus::Error;
+
+		size_t iPos = 2;
+		for (;;)
+		{
+			// Skip anything up to the next marker, and any fill bytes
+
+			while (iPos < iLength && sData[iPos] != 0xFF) iPos++;
+			while (iPos < iLength && sData[iPos] == 0xFF) iPos++;
+			if (iPos >= iLength) return JpegStatus::Error;
+
+			int iMarker = sData[iPos++];
+			if (isJpegStandalone(iMarker)) continue;
+			if (iMarker == 0xD9 || iMarker == 0xDA) return JpegStatus::Error;		// EOI or a scan before any frame header
+
+			if (iPos + 2 > iLength) return JpegStatus::Error;
+			size_t iSegment = (sData[iPos] << 8) | sData[iPos+1];
+			if (iSegment < 2) return JpegStatus::Error;
+
+			if (isJpegFrame(iMarker))
+			{
+				if (iSegment < 8 || iPos + 8 > iLength) return JpegStatus::Error;
+				ReadJpegFrameInfo(iMarker,sData + iPos + 2,stInfo);
+				return JpegStatus::Ok;
+			}
+			iPos += iSegment;
+		}
+	}
+
+	// ProbeJpegFile() -- Read the frame header of a JPEG file.  See ProbeJpeg().
+
+	inline JpegStatus ProbeJpegFile(const char * sPath,JpegInfo_t & stInfo)
+	{
+		stInfo = {};
+		if (!sPath || !*sPath) return JpegStatus::EmptyFilePath;
+
+		FILE * fp = fopen(sPath,"rb");
+		if (!fp) return JpegStatus::FileNotFound;
+
+		JpegStatus eStatus = JpegStatus::Error;
+		int c1 = fgetc(fp);
+		int c2 = fgetc(fp);
+		if (c1 == EOF) eStatus = JpegStatus::FileLengthZero;
+		else if (c1 == 0xFF && c2 == 0xD8)
+		{
+			for (;;)
+			{
+				int c = fgetc(fp);
+				while (c != EOF && c != 0xFF) c = fgetc(fp);
+				while (c == 0xFF) c = fgetc(fp);
+				if (c == EOF) break;
+
+				int iMarker = c;
+				if (isJpegStandalone(iMarker)) continue;
+				if (iMarker == 0xD9 || iMarker == 0xDA) break;
+
+				unsigned char sSegment[8];
+				if (fread(sSegment,1,2,fp) != 2) break;
+				long iSegment = (sSegment[0] << 8) | sSegment[1];
+				if (iSegment < 2) break;
+
+				if (isJpegFrame(iMarker))
+				{
+					if (iSegment >= 8 && fread(sSegment + 2,1,6,fp) == 6)
+					{
+						ReadJpegFrameInfo(iMarker,sSegment + 2,stInfo);
+						eStatus = JpegStatus::Ok;
+					}
+					break;
+				}
+				if (fseek(fp,iSegment - 2,SEEK_CUR)) break;
+			}
+		}
+		fclose(fp);
+		return eStatus;
+	}
+
+}; // namespace Core
+}; // namespace Sage
+#endif // _CJpegInfo_H_
@@ -0,0 +1,215 @@
+//#pragma once
+#if !defined(_CLazyBitmaps_H_)
+#define _CLazyBitmaps_H_
+
+// ---------------------------------------------------------------------
+// CLazyBitmaps.H -- Bitmaps decoded on first use, under a memory budget
+// ---------------------------------------------------------------------
+//
+// A button style has up to ten state bitmaps (normal, high, pressed, disabled, checked, ...), but most buttons are only
+// ever drawn in two or three of them.  CLazyBitmaps holds each bitmap as its source (i.e. a JPEG inside a mapped PGR, see
+// CSagePGR::GetFileView()) and decodes it the first time Get() is called for it.
+//
+// Decoded bitmaps stay cached until the cache goes over its memory budget, when the least-recently used ones are freed --
+// they are decoded again if they are needed later.  The bitmap just returned by Get() is never the one freed.
+//
+// Each bitmap is added with a decode function and its source:
+//
+//		bool fDecode(Bitmap_t & stBitmap,const void * pSource,size_t iSize)	-- fills stBitmap (allocated with CreateBitmap())
+//
+// The source data is not copied, so it must stay valid for as long as the bitmap is in the cache.
+//
+// AddJpeg() bitmaps are decoded with Core::DecodeJpeg().  JPEGs it can't decode (i.e. progressive JPEGs) are passed on to the
+// decoder set with SetJpegFallback() -- SageKernels.h sets Sage::CJpeg -- and fail to decode without one.
+//
+// Notes:
+//
+//		The pointer returned by Get() is valid until the next Get(), SetBudget(), Evict() or Clear(), any of which can free it.
+//		Add() doesn't move the entries (they are kept in a std::deque), so it leaves the pointer valid.
+//		CLazyBitmaps is not thread-safe -- it is meant to be used from the thread drawing the controls.
+//
+#include "SageCore.h"
+#include "CJpegDecoder.h"
+#include <atomic>
+#include <deque>
+
+namespace Sage
+{
+namespace Core
+{
+	typedef bool (*fDecodeBitmap_t)(Bitmap_t & stBitmap,const void * pSource,size_t iSize);
+
+	// SetJpegFallback(), GetJpegFallback() -- The decoder for JPEGs Core::DecodeJpeg() can't decode (JpegStatus::Unsupported),
+	// shared by every CLazyBitmaps.  nullptr (the default) lets those JPEGs fail.
+
+	inline std::atomic<fDecodeBitmap_t> & JpegFallback() { static std::atomic<fDecodeBitmap_t> fFallback { nullptr }; return fFallback; }
+	inline void SetJpegFallback(fDecodeBitmap_t fDecode)	{ JpegFallback().store(fDecode);	}
+	inline fDecodeBitmap_t GetJpegFallback()				{ return JpegFallback().load();	}
+
+	struct LazyBitmapStats_t
+	{
+		long long iHits;				// Get() calls served from the cache
+		long long iDecodes;				// Get() calls that decoded the bitmap
+		long long iEvictions;			// Bitmaps freed to stay under the budget
+		long long iFailed;				// Decodes that failed
+		size_t iResidentBytes;			// Memory held by decoded bitmaps now
+		size_t iPeakBytes;				// Most memory held by decoded bitmaps at one time
+		int iResident;					// Number of decoded bitmaps now
+	};
+
+	class CLazyBitmaps
+	{
+	public:
+		static constexpr size_t kNoBudget = (size_t) -1;
+
+	private:
+		struct Entry_t
+		{
+			fDecodeBitmap_t fDecode;
+			const void * pSource;
+			size_t iSize;
+			Bitmap_t stBitmap;
+			int iPrev;					// Least-recently used list (resident entries only), -1 = end
+			int iNext;
+		};
+
+		std::deque<Entry_t> m_vEntries;			// A deque, so Add() doesn't move the decoded bitmaps
+		int m_iOldest			= -1;
+		int m_iNewest			= -1;
+		size_t m_iBudget		= kNoBudget;
+		LazyBitmapStats_t m_stStats = {};
+
+		static size_t BitmapBytes(const Bitmap_t & stBitmap)
+		{
+			return (size_t) stBitmap.iWidthBytes*stBitmap.iHeight + (stBitmap.sMask ? (size_t) stBitmap.iWidth*stBitmap.iHeight : 0);
+		}
+
+		void Unlink(int iID)
+		{
+			Entry_t & stEntry = m_vEntries[iID];
+			if (stEntry.iPrev >= 0) m_vEntries[stEntry.iPrev].iNext = stEntry.iNext; else m_iOldest = stEntry.iNext;
+			if (stEntry.iNext >= 0) m_vEntries[stEntry.iNext].iPrev = stEntry.iPrev; else m_iNewest = stEntry.iPrev;
+			stEntry.iPrev = stEntry.iNext = -1;
+		}
+
+		void LinkNewest(int iID)
+		{
+			Entry_t & stEntry = m_vEntries[iID];
+			stEntry.iPrev = m_iNewest;
+			stEntry.iNext = -1;
+			if (m_iNewest >= 0) m_vEntries[m_iNewest].iNext = iID; else m_iOldest = iID;
+			m_iNewest = iID;
+		}
+
+		void Free(int iID)
+		{
+			Entry_t & stEntry = m_vEntries[iID];
+			Unlink(iID);
+			m_stStats.iResidentBytes -= BitmapBytes(stEntry.stBitmap);
+			m_stStats.iResident--;
+			DeleteBitmap(stEntry.stBitmap);
+		}
+
+		// Trim() -- Free the least-recently used bitmaps until the cache is within the budget, keeping iKeep
+
+		void Trim(int iKeep = -1)
+		{
+			int iID = m_iOldest;
+			while (iID >= 0 && m_stStats.iResidentBytes > m_iBudget)
+			{
+				int iNext = m_vEntries[iID].iNext;
+				if (iID != iKeep) { Free(iID); m_stStats.iEvictions++; }
+				iID = iNext;
+			}
+		}
+
+		static bool DecodeJpegSource(Bitmap_t & stBitmap,const void * pSource,size_t iSize)
+		{
+			JpegStatus eStatus;
+			stBitmap = DecodeJpeg((const unsigned char *) pSource,iSize,&eStatus);
+			if (eStatus != JpegStatus::Unsupported) return eStatus == JpegStatus::Ok;
+
+			DeleteBitmap(stBitmap);
+			fDecodeBitmap_t fFallback = GetJpegFallback();
+			return fFallback && fFallback(stBitmap,pSource,iSize);
+		}
+
+	public:
+		CLazyBitmaps(size_t iBudget = kNoBudget) : m_iBudget(iBudget) {}
+		~CLazyBitmaps() { Clear(); }
+
+		CLazyBitmaps(const CLazyBitmaps &) = delete;
+		CLazyBitmaps & operator = (const CLazyBitmaps &) = delete;
+
+		// Add() -- Add a bitmap to be decoded with fDecode(stBitmap,pSource,iSize) on first use.  Returns its ID.
+
+		int Add(fDecodeBitmap_t fDecode,const void * pSource,size_t iSize = 0)
+		{
+			m_vEntries.push_back({ fDecode, pSource, iSize, {}, -1, -1 });
+			return (int) m_vEntries.size() - 1;
+		}
+
+		// AddJpeg() -- Add a JPEG in memory, decoded with Core::DecodeJpeg() (or the JPEG fallback) on first use
+
+		int AddJpeg(const unsigned char * sData,size_t iLength) { return Add(DecodeJpegSource,sData,iLength); }
+
+		// Get() -- The bitmap for iID, decoding it if it isn't in the cache.  Returns nullptr if iID is invalid or can't be decoded.
+
+		const Bitmap_t * Get(int iID)
+		{
+			if (iID < 0 || iID >= (int) m_vEntries.size()) return nullptr;
+			Entry_t & stEntry = m_vEntries[iID];
+
+			if (stEntry.stBitmap.stMem)
+			{
+				m_stStats.iHits++;
+				Unlink(iID);
+				LinkNewest(iID);
+				return &stEntry.stBitmap;
+			}
+
+			m_stStats.iDecodes++;
+			if (!stEntry.fDecode || !stEntry.fDecode(stEntry.stBitmap,stEntry.pSource,stEntry.iSize) || !stEntry.stBitmap.isValid())
+			{
+				DeleteBitmap(stEntry.stBitmap);
+				m_stStats.iFailed++;
+				return nullptr;
+			}
+
+			LinkNewest(iID);
+			m_stStats.iResidentBytes += BitmapBytes(stEntry.stBitmap);
+			m_stStats.iResident++;
+			if (m_stStats.iResidentBytes > m_stStats.iPeakBytes) m_stStats.iPeakBytes = m_stStats.iResidentBytes;
+
+			Trim(iID);
+			return &stEntry.stBitmap;
+		}
+
+		// isResident() -- True if iID is decoded and in the cache
+
+		bool isResident(int iID) const { return iID >= 0 && iID < (int) m_vEntries.size() && m_vEntries[iID].stBitmap.stMem; }
+
+		// SetBudget() -- Set the most memory decoded bitmaps may use (kNoBudget = no limit), freeing bitmaps if needed
+
+		void SetBudget(size_t iBudget) { m_iBudget = iBudget; Trim(); }
+		size_t GetBudget() const { return m_iBudget; }
+
+		// Evict() -- Free one decoded bitmap (it is decoded again on the next Get())
+
+		void Evict(int iID) { if (isResident(iID)) Free(iID); }
+
+		// Clear() -- Free every decoded bitmap and remove all entries
+
+		void Clear()
+		{
+			while (m_iOldest >= 0) Free(m_iOldest);
+			m_vEntries.clear();
+		}
+
+		int GetCount() const { return (int) m_vEntries.size(); }
+		const LazyBitmapStats_t & GetStats() const { return m_stStats; }
+	};
+
+}; // namespace Core
+}; // namespace Sage
+#endif // _CLazyBitmaps_H_
@@ -0,0 +1,269 @@
+//#pragma once
+#if !defined(_COptConst_H_)
+#define _COptConst_H_
+
+// -------------------------------------------------------------------
+// COptConst.H -- Options built and parsed at compile time (constexpr)
+// -------------------------------------------------------------------
+//
+// Most opt:: chains are constant, i.e. Font("Arial,20") | fgColor("red") | Transparent(), but each one is still built into a
+// string at run time, every time the line runs, and parsed again by the control.  The copt:: functions build the same chain as a
+// COptConst, which is constexpr: the options string and its OptKey table (as in COptParse) are built by the compiler.
+//
+//		static constexpr auto kOpt = copt::Font("Arial,20") | copt::fgColor("red") | copt::Transparent();
+//
+//		kOpt.s()							-- "Font=\"Arial,20\",fgColor=\"red\",Transparent", for cwfOpt or COptParse
+//		kOpt.isSet(OptKey::Transparent)		-- true, at compile time
+//
+// To pass a constant chain to a function taking a cwfOpt, use SAGE_OPT() (see SageOpt.h), which builds the cwfOpt once for
+// the call site and passes the same object every time after that:
+//
+//		cWin.NewButton(10,10,"OK",SAGE_OPT(copt::Style("Panel") | copt::fgColor("red")));
+//
+// copt::str() adds text as it is, as opt::str() does -- it is in the string, but options in it are not in the OptKey table.
+//
+// Chains are limited to kMaxLength - 1 characters.  A longer chain is cut short and isOverflow() returns true
+// (SAGE_OPT() checks this with a static_assert).
+//
+#include "COptParse.h"
+
+namespace Sage
+{
+namespace Core
+{
+	class COptConst
+	{
+	public:
+		static constexpr int kMaxLength = 256;
+
+	private:
+		char m_sOpt[kMaxLength]					= {};
+		int m_iLength							= 0;
+		bool m_bOverflow						= false;
+		bool m_bSet[(int) OptKey::Count]		= {};
+		short m_iValue[(int) OptKey::Count]		= {};		// Offset of the value in m_sOpt (unquoted), or -1 for a flag
+		short m_iValueLength[(int) OptKey::Count] = {};
+
+		constexpr void Append(char c)
+		{
+			if (m_iLength < kMaxLength - 1) m_sOpt[m_iLength++] = c;
+			else m_bOverflow = true;
+		}
+		constexpr void Append(const char * sString,int iLength = -1)
+		{
+			for (int i=0;iLength < 0 ? sString[i] != 0 : i < iLength;i++) Append(sString[i]);
+		}
+
+		// Add() -- Name, Name="Value" or Name=Value, keeping the value's place for the OptKey table
+
+		constexpr COptConst & Add(OptKey eKey,const char * sName,const char * sValue,bool bQuote)
+		{
+			if (m_iLength) Append(',');
+			Append(sName);
+			int iValue = -1, iValueLength = 0;
+			if (sValue)
+			{
+				Append('=');
+				if (bQuote) Append('"');
+				iValue = m_iLength;
+				Append(sValue);
+				iValueLength = m_iLength - iValue;
+				if (bQuote) Append('"');
+			}
+			if (eKey < OptKey::Count && !m_bSet[(int) eKey] && !m_bOverflow)
+			{
+				m_bSet[(int) eKey]			= true;
+				m_iValue[(int) eKey]		= (short) iValue;
+				m_iValueLength[(int) eKey]	= (short) iValueLength;
+			}
+			return *this;
+		}
+
+		static constexpr int FormatInt(char * sOut,long long iValue)
+		{
+			char sDigits[24] = {};
+			int iDigits = 0, iLength = 0;
+			bool bNegative = iValue < 0;
+			unsigned long long uiValue = bNegative ? 0ull - (unsigned long long) iValue : (unsigned long long) iValue;
+			do { sDigits[iDigits++] = (char) ('0' + uiValue % 10); uiValue /= 10; } while (uiValue);
+			if (bNegative) sOut[iLength++] = '-';
+			while (iDigits) sOut[iLength++] = sDigits[--iDigits];
+			sOut[iLength] = 0;
+			return iLength;
+		}
+
+		// FormatColor() -- \x123456, as cwfOpt writes DWORD colors
+
+		static constexpr int FormatColor(char * sOut,unsigned int uiColor)
+		{
+			int iDigits = uiColor > 0xFFFFFF ? 8 : 6, iLength = 0;
+			sOut[iLength++] = '\\';
+			sOut[iLength++] = 'x';
+			for (int i=iDigits-1;i>=0;i--) sOut[iLength++] = "0123456789ABCDEF"[(uiColor >> (i*4)) & 15];
+			sOut[iLength] = 0;
+			return iLength;
+		}
+
+	public:
+		constexpr COptConst() {}
+
+		constexpr COptConst & AddString(OptKey eKey,const char * sName,const char * sValue)	{ return Add(eKey,sName,sValue ? sValue : "",true); }
+		constexpr COptConst & AddFlag(OptKey eKey,const char * sName)							{ return Add(eKey,sName,nullptr,false); }
+		constexpr COptConst & AddInt(OptKey eKey,const char * sName,long long iValue)
+		{
+			char sValue[24] = {};
+			FormatInt(sValue,iValue);
+			return Add(eKey,sName,sValue,false);
+		}
+		constexpr COptConst & AddColor(OptKey eKey,const char * sName,unsigned int uiColor)
+		{
+			char sValue[12] = {};
+			FormatColor(sValue,uiColor);
+			return Add(eKey,sName,sValue,false);
+		}
+		constexpr COptConst & AddText(const char * sText)
+		{
+			if (!sText || !*sText) return *this;
+			if (m_iLength) Append(',');
+			Append(sText);
+			return *this;
+		}
+
+		// operator | -- Append another chain.  As with cwfOpt, the first of a repeated option is the one used.
+
+		constexpr COptConst & operator |= (const COptConst & cOpt)
+		{
+			if (!cOpt.m_iLength) return *this;
+			if (m_iLength) Append(',');
+			int iOffset = m_iLength;
+			Append(cOpt.m_sOpt,cOpt.m_iLength);
+			for (int i=0;i<(int) OptKey::Count;i++)
+			{
+				if (!cOpt.m_bSet[i] || m_bSet[i]) continue;
+				bool bFits = cOpt.m_iValue[i] < 0 ? iOffset + cOpt.m_iLength <= m_iLength : iOffset + cOpt.m_iValue[i] + cOpt.m_iValueLength[i] <= m_iLength;
+				if (!bFits) continue;
+				m_bSet[i]			= true;
+				m_iValue[i]			= cOpt.m_iValue[i] < 0 ? (short) -1 : (short) (cOpt.m_iValue[i] + iOffset);
+				m_iValueLength[i]	= cOpt.m_iValueLength[i];
+			}
+			return *this;
+		}
+		friend constexpr COptConst operator | (COptConst cOpt1,const COptConst & cOpt2) { return cOpt1 |= cOpt2; }
+
+		// s() -- The options string, as cwfOpt would build it
+
+		constexpr const char * s() const	{ return m_sOpt; }
+		constexpr int GetLength() const		{ return m_iLength; }
+		constexpr bool isOverflow() const	{ return m_bOverflow; }
+
+		// isSet(), GetValue() -- The OptKey table.  GetValue() returns the value's length (-1 if the option isn't set, 0 for a flag)
+		// and points sValue to it (not terminated -- it is followed by the rest of the string).
+
+		constexpr bool isSet(OptKey eKey) const { return eKey < OptKey::Count && m_bSet[(int) eKey]; }
+		constexpr int GetValue(OptKey eKey,const char * & sValue) const
+		{
+			sValue = nullptr;
+			if (!isSet(eKey)) return -1;
+			if (m_iValue[(int) eKey] < 0) return 0;
+			sValue = m_sOpt + m_iValue[(int) eKey];
+			return m_iValueLength[(int) eKey];
+		}
+
+		// GetInt(), GetColor() -- Numeric values, as COptParse::GetInt() and GetColor().  GetColor() resolves stock color names
+		// (see CColorTable.h) at compile time; other names are looked up in GetColorTable() (user colors, then its resolver) at
+		// run time, without COptParse's cache.
+
+		constexpr int GetInt(OptKey eKey,int iDefault = 0) const
+		{
+			const char * sValue = nullptr;
+			int iLength = GetValue(eKey,sValue);
+			if (iLength <= 0) return iDefault;
+			bool bNegative = sValue[0] == '-';
+			int i = bNegative || sValue[0] == '+' ? 1 : 0;
+			if (i >= iLength || sValue[i] < '0' || sValue[i] > '9') return iDefault;
+			long long iValue = 0;
+			for (;i < iLength && sValue[i] >= '0' && sValue[i] <= '9';i++) iValue = iValue*10 + (sValue[i] - '0');
+			return (int) (bNegative ? -iValue : iValue);
+		}
+		constexpr bool GetColor(OptKey eKey,Color_t & rgbColor) const
+		{
+			const char * sValue = nullptr;
+			int iLength = GetValue(eKey,sValue);
+			if (iLength <= 0) return false;
+
+			// Stock color names are resolved here too, so they can be resolved at compile time (other names can't be)
+
+			if (sValue[0] != '\\')
+			{
+				char sName[32] = {};
+				if (iLength >= (int) sizeof(sName)) return false;
+				for (int i=0;i<iLength;i++) sName[i] = sValue[i];
+				return CColorTable::GetStockColor(sName,rgbColor) || GetColorTable().GetColor(sName,rgbColor);
+			}
+			if (iLength < 3 || (sValue[1] != 'x' && sValue[1] != 'X')) return false;
+			unsigned int uiColor = 0;
+			for (int i=2;i<iLength;i++)
+			{
+				char c = sValue[i];
+				int iDigit = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+				if (iDigit < 0) return false;
+				uiColor = uiColor*16 + (unsigned int) iDigit;
+			}
+			rgbColor = (Color_t) uiColor;
+			return true;
+		}
+	};
+
+	// copt:: -- constexpr versions of the opt:: functions, for constant chains
+
+	namespace copt
+	{
+		#define SAGE_COPT_STRING(_Name)	constexpr COptConst _Name(const char * sValue)	{ return COptConst().AddString(OptKey::_Name,#_Name,sValue); }
+		#define SAGE_COPT_COLOR(_Name)	SAGE_COPT_ALIAS(_Name,_Name)
+		#define SAGE_COPT_ALIAS(_Name,_Key)	constexpr COptConst _Name(const char * sValue)	{ return COptConst().AddString(OptKey::_Key,#_Name,sValue); }	\
+											constexpr COptConst _Name(unsigned int uiColor)	{ return COptConst().AddColor(OptKey::_Key,#_Name,uiColor); }
+		#define SAGE_COPT_INT(_Name)	constexpr COptConst _Name(int iValue)			{ return COptConst().AddInt(OptKey::_Name,#_Name,iValue); }
+		#define SAGE_COPT_FLAG(_Name)	constexpr COptConst _Name()						{ return COptConst().AddFlag(OptKey::_Name,#_Name); }
+
+		SAGE_COPT_STRING(Name)		SAGE_COPT_STRING(Title)			SAGE_COPT_STRING(Label)			SAGE_COPT_STRING(Style)
+		SAGE_COPT_STRING(Font)		SAGE_COPT_STRING(FontHigh)		SAGE_COPT_STRING(FontChecked)	SAGE_COPT_STRING(ValueFont)
+		SAGE_COPT_STRING(Group)		SAGE_COPT_STRING(Plate)			SAGE_COPT_STRING(ValidateGroup)
+
+		SAGE_COPT_COLOR(bgColor)	SAGE_COPT_COLOR(bgHigh)			SAGE_COPT_COLOR(bgChecked)		SAGE_COPT_COLOR(fgColor)
+		SAGE_COPT_COLOR(fgHigh)		SAGE_COPT_COLOR(fgChecked)		SAGE_COPT_ALIAS(TextColor,fgColor)	SAGE_COPT_COLOR(ValueColor)
+		SAGE_COPT_COLOR(Color)
+
+		SAGE_COPT_INT(MinValue)		SAGE_COPT_INT(MaxValue)			SAGE_COPT_INT(Default)			SAGE_COPT_INT(CharWidth)
+		SAGE_COPT_INT(Width)		SAGE_COPT_INT(PadX)				SAGE_COPT_INT(PadY)				SAGE_COPT_INT(X)
+		SAGE_COPT_INT(TabPos)		SAGE_COPT_INT(Tab)				SAGE_COPT_INT(GroupID)			SAGE_COPT_INT(ControlID)
+
+		SAGE_COPT_FLAG(Border)		SAGE_COPT_FLAG(ThickBorder)		SAGE_COPT_FLAG(AddBorder)		SAGE_COPT_FLAG(NoBorder)
+		SAGE_COPT_FLAG(ColorsBW)	SAGE_COPT_FLAG(Horz)			SAGE_COPT_FLAG(Vert)			SAGE_COPT_FLAG(Horizontal)
+		SAGE_COPT_FLAG(Vertical)	SAGE_COPT_FLAG(ShowValue)		SAGE_COPT_FLAG(WinTooltip)		SAGE_COPT_FLAG(EnableFocusBox)
+		SAGE_COPT_FLAG(Disabled)	SAGE_COPT_FLAG(AllowScroll)		SAGE_COPT_FLAG(WinColors)		SAGE_COPT_FLAG(UseLast)
+		SAGE_COPT_FLAG(Newline)		SAGE_COPT_FLAG(IconInfo)		SAGE_COPT_FLAG(IconWarning)		SAGE_COPT_FLAG(IconStop)
+		SAGE_COPT_FLAG(IconNone)	SAGE_COPT_FLAG(NoCancel)		SAGE_COPT_FLAG(CancelOk)		SAGE_COPT_FLAG(HideCancel)
+		SAGE_COPT_FLAG(ProgressBar)	SAGE_COPT_FLAG(Transparent)		SAGE_COPT_FLAG(Hidden)			SAGE_COPT_FLAG(FastMode)
+		SAGE_COPT_FLAG(Center)		SAGE_COPT_FLAG(CenterX)			SAGE_COPT_FLAG(CenterY)			SAGE_COPT_FLAG(NoScrollbar)
+		SAGE_COPT_FLAG(TextCenter)	SAGE_COPT_FLAG(TextCenterX)		SAGE_COPT_FLAG(TextCenterY)		SAGE_COPT_FLAG(TextRight)
+		SAGE_COPT_FLAG(TextLeft)	SAGE_COPT_FLAG(TextTop)			SAGE_COPT_FLAG(TextBottom)		SAGE_COPT_FLAG(Popup)
+		SAGE_COPT_FLAG(NoClose)		SAGE_COPT_FLAG(AddShadow)		SAGE_COPT_FLAG(AllowDrag)		SAGE_COPT_FLAG(ReadOnly)
+		SAGE_COPT_FLAG(NumbersOnly)	SAGE_COPT_FLAG(FloatsOnly)		SAGE_COPT_FLAG(JustCenter)		SAGE_COPT_FLAG(JustCenterX)
+		SAGE_COPT_FLAG(JustCenterY)	SAGE_COPT_FLAG(JustRight)		SAGE_COPT_FLAG(JustLeft)		SAGE_COPT_FLAG(JustTop)
+		SAGE_COPT_FLAG(JustBottom)	SAGE_COPT_FLAG(JustTopRight)	SAGE_COPT_FLAG(JustTopLeft)		SAGE_COPT_FLAG(JustBottomRight)
+		SAGE_COPT_FLAG(JustBottomLeft) SAGE_COPT_FLAG(JustBottomCenter) SAGE_COPT_FLAG(JustTopCenter)
+
+		#undef SAGE_COPT_STRING
+		#undef SAGE_COPT_COLOR
+		#undef SAGE_COPT_ALIAS
+		#undef SAGE_COPT_INT
+		#undef SAGE_COPT_FLAG
+
+		// str() -- Text added as it is (i.e. options for a widget).  It is not in the OptKey table.
+
+		constexpr COptConst str(const char * sText) { return COptConst().AddText(sText); }
+	};
+
+}; // namespace Core
+}; // namespace Sage
+#endif // _COptConst_H_
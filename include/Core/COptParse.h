@@ -0,0 +1,345 @@
+//#pragma once
+#if !defined(_COptParse_H_)
+#define _COptParse_H_
+
+// ---------------------------------------------------------------
+// COptParse.H -- Options strings (cwfOpt) parsed once, typed keys
+// ---------------------------------------------------------------
+//
+// Options built with opt:: (i.e. fgColor("Red") | Style("Panel") | Transparent()) reach a control as one string, such as
+//
+//		fgColor="Red",Style="Panel",Transparent
+//
+// and each option the control looks for is another scan of the whole string.  COptParse splits the string once into a
+// table indexed by OptKey, so each lookup after that is an array access:
+//
+//		Core::COptParse cOpt(*cwOpt);
+//		const char * sStyle = cOpt.GetString(OptKey::Style,"Default");
+//		bool bTransparent	= cOpt.GetBool(OptKey::Transparent);
+//		int iWidth			= cOpt.GetInt(OptKey::Width,100);
+//
+// Options that aren't in OptKey (i.e. from str() or literal(), or a widget's own options) are kept too, and are found by
+// name with the same functions taking a const char * name -- so nothing in the string is lost.
+//
+// Format: options are separated by commas (outside of quotes), and are either a name on its own (a flag, such as
+// Transparent) or Name=Value.  Values can be quoted with "" or ''.  Names are not case-sensitive.  If an option is given more
+// than once, the first one is used -- the same as a search from the start of the string.
+//
+// Aliases are read as the option they stand for, as the controls document them: TextColor and fg are fgColor, and bg is
+// bgColor.  So GetColor(OptKey::fgColor) finds TextColor="Red", and an alias given first wins over the option it stands for.
+//
+// Colors are returned as Core::Color_t when given as a number (\x123456 or a decimal value, as DWORD colors are written by
+// cwfOpt) or a name (i.e. "Red" or a MakeColor() name, looked up in GetColorTable() -- see CColorTable.h).  A named color is
+// looked up once and cached with the option; the cache is checked against the table's generation, so a later MakeColor()
+// is still seen.  Because of the cache, one COptParse shouldn't be read from more than one thread at a time.
+//
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "SageCore.h"
+#include "CColorTable.h"
+
+namespace Sage
+{
+namespace Core
+{
+	// The options with typed keys -- the single-value and flag options of cwfOpt
+
+	#define SAGE_OPT_KEYS(_)																								\
+		_(Name) _(Title) _(Label) _(Style) _(Font) _(FontHigh) _(FontChecked) _(ValueFont) _(Group) _(GroupID) _(ControlID)	\
+		_(Plate) _(Default) _(ValidateGroup)																				\
+		_(bgColor) _(bgHigh) _(bgChecked) _(fgColor) _(fgHigh) _(fgChecked) _(ValueColor) _(Color)						\
+		_(MinValue) _(MaxValue) _(CharWidth) _(Width) _(PadX) _(PadY) _(X) _(TabPos) _(Tab) _(Newline)						\
+		_(Border) _(ThickBorder) _(AddBorder) _(NoBorder) _(ColorsBW) _(Horz) _(Vert) _(Horizontal) _(Vertical)			\
+		_(ShowValue) _(WinTooltip) _(EnableFocusBox) _(Disabled) _(AllowScroll) _(WinColors) _(UseLast)					\
+		_(IconInfo) _(IconWarning) _(IconStop) _(IconNone) _(NoCancel) _(CancelOk) _(HideCancel) _(ProgressBar)			\
+		_(Transparent) _(Hidden) _(FastMode) _(Center) _(CenterX) _(CenterY) _(CenterXY) _(NoScrollbar)					\
+		_(TextCenter) _(TextCenterX) _(TextCenterY) _(TextRight) _(TextLeft) _(TextTop) _(TextBottom)						\
+		_(Popup) _(NoClose) _(AddShadow) _(AllowDrag) _(ReadOnly) _(NumbersOnly) _(FloatsOnly)								\
+		_(JustCenter) _(JustCenterX) _(JustCenterY) _(JustRight) _(JustLeft) _(JustTop) _(JustBottom)						\
+		_(JustTopRight) _(JustTopLeft) _(JustBottomRight) _(JustBottomLeft) _(JustBottomCenter) _(JustTopCenter)
+
+	#define SAGE_OPT_ENUM(_Name) _Name,
+	enum class OptKey : unsigned char
+	{
+		SAGE_OPT_KEYS(SAGE_OPT_ENUM)
+		Count,
+		Unknown = Count,
+	};
+	#undef SAGE_OPT_ENUM
+
+	// OptNameCompare() -- Case-insensitive compare of sName[0,iLength) with the terminated string sKey
+
+	static inline int OptNameCompare(const char * sName,size_t iLength,const char * sKey)
+	{
+		for (size_t i=0;i<iLength;i++)
+		{
+			int c1 = (unsigned char) sName[i], c2 = (unsigned char) sKey[i];
+			if (c1 >= 'A' && c1 <= 'Z') c1 += 'a' - 'A';
+			if (c2 >= 'A' && c2 <= 'Z') c2 += 'a' - 'A';
+			if (c1 != c2 || !c2) return c1 - c2;
+		}
+		return sKey[iLength] ? -1 : 0;
+	}
+
+	// GetOptName() -- The name of an OptKey, as it appears in option strings
+
+	static inline const char * GetOptName(OptKey eKey)
+	{
+		#define SAGE_OPT_NAME(_Name) #_Name,
+		static const char * sNames[] = { SAGE_OPT_KEYS(SAGE_OPT_NAME) "" };
+		#undef SAGE_OPT_NAME
+		return sNames[eKey < OptKey::Count ? (int) eKey : (int) OptKey::Count];
+	}
+
+	// FindOptKey() -- The OptKey for a name or alias (not case-sensitive), or OptKey::Unknown
+
+	static inline OptKey FindOptKey(const char * sName,size_t iLength)
+	{
+		// The names sorted once, for a binary search
+
+		static const std::vector<OptKey> vSorted = []
+		{
+			std::vector<OptKey> vKeys;
+			for (int i=0;i<(int) OptKey::Count;i++) vKeys.push_back((OptKey) i);
+			std::sort(vKeys.begin(),vKeys.end(),[](OptKey e1,OptKey e2) { return OptNameCompare(GetOptName(e1),strlen(GetOptName(e1)),GetOptName(e2)) < 0; });
+			return vKeys;
+		}();
+
+		auto itKey = std::lower_bound(vSorted.begin(),vSorted.end(),0,[&](OptKey eKey,int) { return OptNameCompare(sName,iLength,GetOptName(eKey)) > 0; });
+		if (itKey != vSorted.end() && !OptNameCompare(sName,iLength,GetOptName(*itKey))) return *itKey;
+
+		// Aliases -- other names for an option
+
+		static const struct { const char * sAlias; OptKey eKey; } stAliases[] =
+		{
+			{ "TextColor",	OptKey::fgColor },
+			{ "fg",			OptKey::fgColor },
+			{ "bg",			OptKey::bgColor },
+		};
+		for (auto & stAlias : stAliases) if (!OptNameCompare(sName,iLength,stAlias.sAlias)) return stAlias.eKey;
+		return OptKey::Unknown;
+	}
+	static inline OptKey FindOptKey(const char * sName) { return sName ? FindOptKey(sName,strlen(sName)) : OptKey::Unknown; }
+
+	class COptParse
+	{
+	private:
+		struct Option_t
+		{
+			unsigned short iName;			// Name and value, as offsets into m_sOpt (the value is unquoted and terminated)
+			unsigned short iNameLength;
+			unsigned short iValue;
+			bool bSet;
+			bool bHasValue;
+			mutable unsigned int uiColorGeneration;	// GetColorTable() generation of rgbColor, or 0 if not cached
+			mutable Color_t rgbColor;
+		};
+
+		std::string m_sOpt;									// Copy of the string, with values terminated in place
+		Option_t m_stKeys[(int) OptKey::Count] = {};
+		std::vector<Option_t> m_vOther;						// Options without an OptKey, in order
+
+		static bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+		const Option_t * Find(const char * sName) const
+		{
+			if (!sName) return nullptr;
+			OptKey eKey = FindOptKey(sName);
+			if (eKey != OptKey::Unknown) return m_stKeys[(int) eKey].bSet ? &m_stKeys[(int) eKey] : nullptr;
+			for (auto & stOption : m_vOther)
+				if (!OptNameCompare(m_sOpt.c_str() + stOption.iName,stOption.iNameLength,sName)) return &stOption;
+			return nullptr;
+		}
+		const Option_t * Find(OptKey eKey) const { return eKey < OptKey::Count && m_stKeys[(int) eKey].bSet ? &m_stKeys[(int) eKey] : nullptr; }
+
+		const char * Value(const Option_t * stOption) const { return stOption && stOption->bHasValue ? m_sOpt.c_str() + stOption->iValue : nullptr; }
+
+		static bool toInt(const char * sValue,int & iValue)
+		{
+			if (!sValue || !*sValue) return false;
+			char * sEnd;
+			long iResult = strtol(sValue,&sEnd,0);
+			if (sEnd == sValue) return false;
+			iValue = (int) iResult;
+			return true;
+		}
+		static bool toFloat(const char * sValue,double & fValue)
+		{
+			if (!sValue || !*sValue) return false;
+			char * sEnd;
+			double fResult = strtod(sValue,&sEnd);
+			if (sEnd == sValue) return false;
+			fValue = fResult;
+			return true;
+		}
+		static bool toColor(const char * sValue,Color_t & rgbColor)
+		{
+			if (!sValue) return false;
+			char * sEnd;
+			unsigned long uiColor;
+			if (sValue[0] == '\\' && (sValue[1] == 'x' || sValue[1] == 'X')) uiColor = strtoul(sValue + 2,&sEnd,16);
+			else if (sValue[0] >= '0' && sValue[0] <= '9') uiColor = strtoul(sValue,&sEnd,0);
+			else return false;
+			if (*sEnd) return false;
+			rgbColor = (Color_t) uiColor;
+			return true;
+		}
+
+		// GetColor() -- A numeric color, or a named color through the cache.  Colors from the color table's resolver (see
+		// CColorTable::SetResolver()) aren't cached, as the table can't tell when they change.
+
+		bool GetColor(const Option_t * stOption,Color_t & rgbColor) const
+		{
+			const char * sValue = Value(stOption);
+			if (toColor(sValue,rgbColor)) return true;
+			if (!sValue || !*sValue) return false;
+
+			CColorTable & cTable = GetColorTable();
+			unsigned int uiGeneration = cTable.GetGeneration();
+			if (stOption->uiColorGeneration != uiGeneration)
+			{
+				bool bResolved;
+				if (!cTable.GetColor(sValue,rgbColor,&bResolved)) return false;
+				if (bResolved) return true;
+				stOption->rgbColor			= rgbColor;
+				stOption->uiColorGeneration	= uiGeneration;
+			}
+			rgbColor = stOption->rgbColor;
+			return true;
+		}
+
+	public:
+		COptParse() {}
+		COptParse(const char * sOpt) { Parse(sOpt); }
+
+		// Parse() -- Split an options string.  Strings of 64K or more are cut at 64K.
+
+		void Parse(const char * sOpt)
+		{
+			m_sOpt.clear();
+			m_vOther.clear();
+			for (auto & stKey : m_stKeys) stKey = {};
+			if (!sOpt || !*sOpt) return;
+
+			m_sOpt.assign(sOpt,std::min(strlen(sOpt),(size_t) 0xFFFE));
+			char * s = &m_sOpt[0];
+			size_t iLength = m_sOpt.size();
+			size_t iPos = 0;
+
+			while (iPos < iLength)
+			{
+				while (iPos < iLength && (isSpace(s[iPos]) || s[iPos] == ',')) iPos++;
+				if (iPos >= iLength) break;
+
+				// Name, up to '=', ',' or a space
+
+				Option_t stOption = {};
+				stOption.iName = (unsigned short) iPos;
+				while (iPos < iLength && s[iPos] != '=' && s[iPos] != ',' && !isSpace(s[iPos])) iPos++;
+				stOption.iNameLength = (unsigned short) (iPos - stOption.iName);
+				stOption.bSet = true;
+
+				while (iPos < iLength && isSpace(s[iPos])) iPos++;
+				if (iPos < iLength && s[iPos] == '=')
+				{
+					iPos++;
+					while (iPos < iLength && isSpace(s[iPos])) iPos++;
+
+					// Value -- quoted (up to the closing quote) or up to the next ','.  The value is terminated in place.
+
+					stOption.bHasValue = true;
+					if (iPos < iLength && (s[iPos] == '"' || s[iPos] == '\''))
+					{
+						char cQuote = s[iPos++];
+						stOption.iValue = (unsigned short) iPos;
+						while (iPos < iLength && s[iPos] != cQuote) iPos++;
+						if (iPos < iLength) s[iPos++] = 0;
+						while (iPos < iLength && s[iPos] != ',') iPos++;
+					}
+					else
+					{
+						stOption.iValue = (unsigned short) iPos;
+						while (iPos < iLength && s[iPos] != ',') iPos++;
+						size_t iEnd = iPos;
+						while (iEnd > stOption.iValue && isSpace(s[iEnd-1])) iEnd--;
+						if (iEnd < iLength) s[iEnd] = 0;
+					}
+					if (iPos < iLength) s[iPos++] = 0;
+				}
+				if (!stOption.iNameLength) continue;
+
+				OptKey eKey = FindOptKey(s + stOption.iName,stOption.iNameLength);
+				if (eKey != OptKey::Unknown) { if (!m_stKeys[(int) eKey].bSet) m_stKeys[(int) eKey] = stOption; }
+				else m_vOther.push_back(stOption);
+			}
+		}
+
+		// isSet() -- True if the option is in the string (with or without a value)
+
+		bool isSet(OptKey eKey) const		{ return Find(eKey) != nullptr; }
+		bool isSet(const char * sName) const	{ return Find(sName) != nullptr; }
+
+		// GetBool() -- True if the flag is in the string (i.e. Transparent), or its value is non-zero/"true"
+
+		bool GetBool(OptKey eKey,bool bDefault = false) const			{ return GetBool(Find(eKey),bDefault); }
+		bool GetBool(const char * sName,bool bDefault = false) const	{ return GetBool(Find(sName),bDefault); }
+
+		// GetInt(), GetFloat() -- The option's numeric value, or the default if it isn't set or isn't a number
+
+		int GetInt(OptKey eKey,int iDefault = 0,bool * bSet = nullptr) const				{ return GetInt(Find(eKey),iDefault,bSet); }
+		int GetInt(const char * sName,int iDefault = 0,bool * bSet = nullptr) const		{ return GetInt(Find(sName),iDefault,bSet); }
+		double GetFloat(OptKey eKey,double fDefault = 0,bool * bSet = nullptr) const		{ return GetFloat(Find(eKey),fDefault,bSet); }
+		double GetFloat(const char * sName,double fDefault = 0,bool * bSet = nullptr) const	{ return GetFloat(Find(sName),fDefault,bSet); }
+
+		// GetString() -- The option's value (unquoted), or sDefault if it isn't set.  Valid until the next Parse().
+
+		const char * GetString(OptKey eKey,const char * sDefault = nullptr) const		{ const char * s = Value(Find(eKey)); return s ? s : sDefault; }
+		const char * GetString(const char * sName,const char * sDefault = nullptr) const	{ const char * s = Value(Find(sName)); return s ? s : sDefault; }
+
+		// GetColor() -- The option's color, as a number or a color name.  Returns false if it isn't set or the name isn't found.
+
+		bool GetColor(OptKey eKey,Color_t & rgbColor) const		{ return GetColor(Find(eKey),rgbColor); }
+		bool GetColor(const char * sName,Color_t & rgbColor) const	{ return GetColor(Find(sName),rgbColor); }
+
+		// GetOtherCount(), GetOtherName(), GetOther() -- The options without an OptKey, in order (i.e. for a widget's own options)
+
+		int GetOtherCount() const { return (int) m_vOther.size(); }
+		std::string GetOtherName(int iIndex) const
+		{
+			if (iIndex < 0 || iIndex >= (int) m_vOther.size()) return std::string();
+			return std::string(m_sOpt.c_str() + m_vOther[iIndex].iName,m_vOther[iIndex].iNameLength);
+		}
+		const char * GetOther(int iIndex) const { return iIndex >= 0 && iIndex < (int) m_vOther.size() ? Value(&m_vOther[iIndex]) : nullptr; }
+
+	private:
+		bool GetBool(const Option_t * stOption,bool bDefault) const
+		{
+			if (!stOption) return bDefault;
+			const char * sValue = Value(stOption);
+			if (!sValue) return true;
+			int iValue;
+			if (toInt(sValue,iValue)) return iValue != 0;
+			return !OptNameCompare(sValue,strlen(sValue),"true") || !OptNameCompare(sValue,strlen(sValue),"yes");
+		}
+		int GetInt(const Option_t * stOption,int iDefault,bool * bSet) const
+		{
+			int iValue = iDefault;
+			bool bFound = toInt(Value(stOption),iValue);
+			if (bSet) *bSet = bFound;
+			return bFound ? iValue : iDefault;
+		}
+		double GetFloat(const Option_t * stOption,double fDefault,bool * bSet) const
+		{
+			double fValue = fDefault;
+			bool bFound = toFloat(Value(stOption),fValue);
+			if (bSet) *bSet = bFound;
+			return bFound ? fValue : fDefault;
+		}
+	};
+
+}; // namespace Core
+}; // namespace Sage
+#endif // _COptParse_H_
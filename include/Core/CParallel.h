@@ -0,0 +1,263 @@
+//#pragma once
+#if !defined(_CParallel_H_)
+#define _CParallel_H_
+
+// -----------------------------------------------------------
+// CParallel.H -- Tiled, work-stealing threading for Core code
+// -----------------------------------------------------------
+//
+// ParallelRows() splits a range of rows into cache-sized tiles (bands of rows) and runs them on a persistent thread pool.
+//
+// Each thread starts with its own run of tiles.  When it runs out, it steals tiles from the other threads' runs, so one slow thread
+// (or a core busy with something else) doesn't hold up the whole operation.  The calling thread always takes part.
+//
+// Each row is written by only one thread, so results are the same regardless of the number of threads or which thread ran which tile.
+//
+// Jobs below the threshold (see SetParallelThreshold()) stay on the calling thread, as waking the pool would cost more than it saves.
+//
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Sage
+{
+namespace Core
+{
+	// kParallelMinPixels -- Default threshold: below this many pixels, the kernels stay single-threaded
+	// kParallelTilePixels -- Pixels per tile (about 192K of 24-bit pixels, to stay within a core's L2 cache)
+
+	static constexpr int kParallelMinPixels		= 256*1024;
+	static constexpr int kParallelTilePixels	= 64*1024;
+
+	// ParallelThreshold() -- Current threshold, in pixels (see SetParallelThreshold())
+
+	inline std::atomic<int> & ParallelThreshold() { static std::atomic<int> iThreshold { kParallelMinPixels }; return iThreshold; }
+
+	// SetParallelThreshold() -- Set the number of pixels below which an operation stays on the calling thread.  0 always uses the pool.
+
+	inline void SetParallelThreshold(int iPixels) { ParallelThreshold().store(iPixels < 0 ? 0 : iPixels,std::memory_order_relaxed); }
+	inline int GetParallelThreshold() { return ParallelThreshold().load(std::memory_order_relaxed); }
+
+	// ----------------------------------------------------
+	// CThreadPool -- Persistent workers for ParallelRows()
+	// ----------------------------------------------------
+
+	class CThreadPool
+	{
+	public:
+		static constexpr int kMaxThreads = 64;
+
+	private:
+		// Run_t -- One thread's run of tiles [iNext,iEnd).  Other threads steal from iNext when their own run is used up.
+
+		struct alignas(64) Run_t
+		{
+			std::atomic<int> iNext;
+			int iEnd;
+		};
+
+		struct Job_t
+		{
+			void (*fTile)(void * pContext,int iTile);
+			void * pContext;
+			int iThreads;
+			Run_t stRuns[kMaxThreads];
+		};
+
+		std::vector<std::thread> m_vThreads;
+		std::atomic<int> m_iThreadCount { 1 };	// m_vThreads.size() + 1, readable without m_mutexRun (see GetThreadCount())
+		std::mutex m_mutexRun;					// One job at a time
+		std::mutex m_mutex;
+		std::condition_variable m_cvWork;
+		std::condition_variable m_cvDone;
+		Job_t * m_stJob				= nullptr;
+		unsigned int m_uiGeneration	= 0;
+		int m_iRemaining			= 0;		// Workers still on the current job
+		bool m_bStop				= false;
+
+		static bool & InPool() { thread_local bool bInPool = false; return bInPool; }
+
+		// Work() -- Run this thread's tiles, then steal from the others until every run is empty
+
+		static void Work(Job_t & stJob,int iThread)
+		{
+			for (int i=0;i<stJob.iThreads;i++)
+			{
+				Run_t & stRun = stJob.stRuns[(iThread + i) % stJob.iThreads];
+				for (;;)
+				{
+					int iTile = stRun.iNext.fetch_add(1,std::memory_order_relaxed);
+					if (iTile >= stRun.iEnd) break;
+					stJob.fTile(stJob.pContext,iTile);
+				}
+			}
+		}
+
+		void WorkerLoop(int iThread)
+		{
+			InPool() = true;
+			unsigned int uiGeneration = 0;
+			for (;;)
+			{
+				Job_t * stJob;
+				{
+					std::unique_lock<std::mutex> lock(m_mutex);
+					m_cvWork.wait(lock,[&] { return m_bStop || m_uiGeneration != uiGeneration; });
+					if (m_bStop) return;
+					uiGeneration = m_uiGeneration;
+					stJob = m_stJob;
+				}
+				if (!stJob || iThread >= stJob->iThreads) continue;		// Not needed for this job (or it has already finished)
+
+				Work(*stJob,iThread);
+
+				std::lock_guard<std::mutex> lock(m_mutex);
+				if (!--m_iRemaining) m_cvDone.notify_one();
+			}
+		}
+
+		void Start(int iWorkers)
+		{
+			m_bStop = false;
+			for (int i=0;i<iWorkers;i++) m_vThreads.emplace_back([this,i] { WorkerLoop(i+1); });
+			m_iThreadCount.store(iWorkers + 1,std::memory_order_relaxed);
+		}
+		void Stop()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_bStop = true;
+			}
+			m_cvWork.notify_all();
+			for (auto & cThread : m_vThreads) cThread.join();
+			m_vThreads.clear();
+		}
+
+	public:
+		// iThreads includes the calling thread, so a pool of N threads starts N-1 workers.  0 = one per hardware thread.
+
+		CThreadPool(int iThreads = 0)
+		{
+			if (iThreads <= 0) iThreads = (int) std::thread::hardware_concurrency();
+			Start((iThreads < 1 ? 1 : iThreads > kMaxThreads ? kMaxThreads : iThreads) - 1);
+		}
+		~CThreadPool() { Stop(); }
+
+		CThreadPool(const CThreadPool &) = delete;
+		CThreadPool & operator = (const CThreadPool &) = delete;
+
+		// GetThreadCount() -- Threads available to a job, including the calling thread.  This can be called while SetThreadCount()
+		// restarts the pool (it returns the old count until the new threads are started); Run() checks it again under its lock.
+
+		int GetThreadCount() const { return m_iThreadCount.load(std::memory_order_relaxed); }
+
+		// SetThreadCount() -- Restart the pool with iThreads threads (including the calling thread).  0 = one per hardware thread.
+
+		void SetThreadCount(int iThreads)
+		{
+			std::lock_guard<std::mutex> lock(m_mutexRun);
+			if (iThreads <= 0) iThreads = (int) std::thread::hardware_concurrency();
+			iThreads = iThreads < 1 ? 1 : iThreads > kMaxThreads ? kMaxThreads : iThreads;
+			if (iThreads == GetThreadCount()) return;
+			Stop();
+			Start(iThreads-1);
+		}
+
+		// Run() -- Call fTile(iTile) for each tile in [0,iTiles) on up to iThreads threads, and return when all tiles are done.
+		// Called from inside a pool thread (i.e. a nested Run()), the tiles run on the calling thread.
+		//
+		template <class _t>
+		void Run(int iTiles,int iThreads,_t & fTile)
+		{
+			if (iTiles <= 0) return;
+			if (iThreads > GetThreadCount()) iThreads = GetThreadCount();
+			if (iThreads > iTiles) iThreads = iTiles;
+
+			if (iThreads <= 1 || InPool())
+			{
+				for (int i=0;i<iTiles;i++) fTile(i);
+				return;
+			}
+
+			std::lock_guard<std::mutex> lockRun(m_mutexRun);
+			iThreads = iThreads > GetThreadCount() ? GetThreadCount() : iThreads;		// In case SetThreadCount() ran in between
+
+			Job_t stJob;
+			stJob.fTile		= [](void * pContext,int iTile) { (*(_t *) pContext)(iTile); };
+			stJob.pContext	= &fTile;
+			stJob.iThreads	= iThreads;
+			for (int i=0;i<iThreads;i++)
+			{
+				stJob.stRuns[i].iNext.store((int) ((long long) iTiles*i/iThreads),std::memory_order_relaxed);
+				stJob.stRuns[i].iEnd = (int) ((long long) iTiles*(i+1)/iThreads);
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_stJob			= &stJob;
+				m_iRemaining	= iThreads-1;
+				m_uiGeneration++;
+			}
+			m_cvWork.notify_all();
+
+			bool & bInPool = InPool();
+			bInPool = true;
+			Work(stJob,0);
+			bInPool = false;
+
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_cvDone.wait(lock,[&] { return !m_iRemaining; });
+			m_stJob = nullptr;
+		}
+	};
+
+	// GetThreadPool() -- The shared pool used by the Core kernels, started on first use with one thread per hardware thread
+
+	inline CThreadPool & GetThreadPool() { static CThreadPool cPool; return cPool; }
+
+	// SetThreadCount() -- Set the number of threads in the shared pool (including the calling thread).  0 = one per hardware thread.
+
+	inline void SetThreadCount(int iThreads) { GetThreadPool().SetThreadCount(iThreads); }
+
+	// GetThreadCount() -- Resolve a thread count: 0 (or less) means every thread in the shared pool.
+
+	inline int GetThreadCount(int iThreads)
+	{
+		if (iThreads > 0) return iThreads;
+		return GetThreadPool().GetThreadCount();
+	}
+
+	// ParallelRows() -- Run fFunction(iStartRow,iEndRow) over [0,iRows) on up to iThreads threads (0 = all threads in the pool).
+	// The rows are split into tiles of about kParallelTilePixels each.  iPixelsPerRow sets the tile height and the threshold check.
+	//
+	template <class _t>
+	inline void ParallelRows(int iRows,int iPixelsPerRow,int iThreads,_t fFunction)
+	{
+		if (iRows <= 0) return;
+		iThreads = GetThreadCount(iThreads);
+		if ((long long) iRows*iPixelsPerRow < GetParallelThreshold()) iThreads = 1;
+
+		if (iThreads <= 1)
+		{
+			fFunction(0,iRows);
+			return;
+		}
+
+		int iTileRows	= iPixelsPerRow > 0 ? kParallelTilePixels/iPixelsPerRow : iRows;
+		if (iTileRows < 1) iTileRows = 1;
+		int iTiles		= (iRows + iTileRows - 1)/iTileRows;
+
+		auto fTile = [&](int iTile)
+		{
+			int iStart	= iTile*iTileRows;
+			int iEnd	= iStart + iTileRows < iRows ? iStart + iTileRows : iRows;
+			fFunction(iStart,iEnd);
+		};
+		GetThreadPool().Run(iTiles,iThreads,fTile);
+	}
+
+}; // namespace Core
+}; // namespace Sage
+#endif // _CParallel_H_
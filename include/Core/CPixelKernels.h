@@ -0,0 +1,257 @@
+//#pragma once
+#if !defined(_CPixelKernels_H_)
+#define _CPixelKernels_H_
+
+// --------------------------------------------------------
+// CPixelKernels.H -- Portable 24-bit pixel kernels (Core)
+// --------------------------------------------------------
+//
+// These are the pixel operations behind RawBitmap_t (CopyFrom(), Copyto(), FillColor(), ApplyMaskColor(), ApplyMaskGraphic(),
+// ReverseBitmap() and MasktoBmp()), written against the Core types only so they can be built and timed on any platform.
+//
+// All kernels clip the requested region against both bitmaps.  They return false when a bitmap is invalid or the sizes do not match,
+// and true otherwise (including when the region clips to nothing).
+//
+// Masks are applied per channel, rounded to nearest:
+//
+//		Dest = (Source*Mask + Background*(255-Mask))/255
+//
+// With 24-bit masks, each channel uses its own mask value (a gray mask has the same value in each channel).
+// The 8-bit versions use the mask plane (sMask) of the source bitmap, one value per pixel.
+//
+// The blends use the SSE2 or AVX2 row kernels when the CPU supports them (see CRowKernels.h); the results are the same at every level.
+//
+// "bReverse" treats the source (and mask) as bottom-up, the same as the 'R' versions of the RawBitmap_t functions, i.e. ApplyMaskGraphicR()
+//
+// "iThreads" splits large regions into row tiles on the shared thread pool (see CParallel.h).  1 (the default) stays on the calling thread,
+// and 0 uses every thread in the pool.  Each output row is written by one thread, so the results are the same for any thread count.
+//
+#include "SageCore.h"
+#include "CRowKernels.h"
+#include "CParallel.h"
+
+namespace Sage
+{
+namespace Core
+{
+	// ClipRegion() -- Clip a Source->Dest region against both bitmaps.
+	// An empty szSize (i.e. {0,0}) means the size of the Source bitmap from pSource.
+	// Returns false if nothing is left to draw.
+	//
+	inline bool ClipRegion(const Bitmap_t & stSource,Point_t & pSource,const Bitmap_t & stDest,Point_t & pDest,Size_t & szSize)
+	{
+		if (!szSize.cx && !szSize.cy) szSize = { stSource.iWidth - pSource.x, stSource.iHeight - pSource.y };
+
+		if (pSource.x < 0)	{ pDest.x	-= pSource.x;	szSize.cx += pSource.x;	pSource.x	= 0; }
+		if (pSource.y < 0)	{ pDest.y	-= pSource.y;	szSize.cy += pSource.y;	pSource.y	= 0; }
+		if (pDest.x < 0)	{ pSource.x -= pDest.x;		szSize.cx += pDest.x;	pDest.x		= 0; }
+		if (pDest.y < 0)	{ pSource.y -= pDest.y;		szSize.cy += pDest.y;	pDest.y		= 0; }
+
+		if (szSize.cx > stSource.iWidth  - pSource.x)	szSize.cx = stSource.iWidth  - pSource.x;
+		if (szSize.cy > stSource.iHeight - pSource.y)	szSize.cy = stSource.iHeight - pSource.y;
+		if (szSize.cx > stDest.iWidth    - pDest.x)		szSize.cx = stDest.iWidth    - pDest.x;
+		if (szSize.cy > stDest.iHeight   - pDest.y)		szSize.cy = stDest.iHeight   - pDest.y;
+
+		return szSize.cx > 0 && szSize.cy > 0;
+	}
+
+	// SourceRow() -- Memory row for visual row iY, taking bottom-up (reversed) bitmaps into account
+
+	static inline int SourceRow(const Bitmap_t & stBitmap,int iY,bool bReverse) { return bReverse ? stBitmap.iHeight - 1 - iY : iY; }
+
+	// ------------------------------
+	// Bitmap kernels
+	// ------------------------------
+
+	// CopyBitmap() -- Copy a region of stSource into stDest (RawBitmap_t::CopyFrom() and RawBitmap_t::Copyto())
+	// An empty szSize copies the entire source (clipped to the destination).
+	//
+	inline bool CopyBitmap(const Bitmap_t & stSource,Point_t pSourceStart,Bitmap_t & stDest,Point_t pDestStart,Size_t szSize = { 0,0 },int iThreads = 1)
+	{
+		if (!stSource.isValid() || !stDest.isValid()) return false;
+		if (!ClipRegion(stSource,pSourceStart,stDest,pDestStart,szSize)) return true;
+
+		size_t iBytes = (size_t) szSize.cx*3;
+
+		// Copying within the same bitmap depends on row order, so it stays on one thread.  When the destination is below the
+		// source, the rows are copied bottom-up so that no source row is overwritten before it is read.
+
+		if (stSource.stMem == stDest.stMem)
+		{
+			bool bBottomUp = pDestStart.y > pSourceStart.y;
+			for (int n=0;n<szSize.cy;n++)
+			{
+				int i = bBottomUp ? szSize.cy - 1 - n : n;
+				memmove(stDest.Row(pDestStart.y+i) + pDestStart.x*3,stSource.Row(pSourceStart.y+i) + pSourceStart.x*3,iBytes);
+			}
+			return true;
+		}
+
+		ParallelRows(szSize.cy,szSize.cx,iThreads,[&](int iStart,int iEnd)
+		{
+			for (int i=iStart;i<iEnd;i++) memcpy(stDest.Row(pDestStart.y+i) + pDestStart.x*3,stSource.Row(pSourceStart.y+i) + pSourceStart.x*3,iBytes);
+		});
+		return true;
+	}
+
+	// CopyBitmap() -- Copy all of stSource into stDest at (0,0)
+
+	inline bool CopyBitmap(const Bitmap_t & stSource,Bitmap_t & stDest,int iThreads = 1) { return CopyBitmap(stSource,{ 0,0 },stDest,{ 0,0 },{ 0,0 },iThreads); }
+
+	// FillBitmap() -- Fill a region with a solid color (RawBitmap_t::FillColor()).  An empty szSize fills from pStart to the end of the bitmap.
+	//
+	inline bool FillBitmap(Bitmap_t & stDest,Color_t rgbColor,Point_t pStart = { 0,0 },Size_t szSize = { 0,0 },int iThreads = 1)
+	{
+		if (!stDest.isValid()) return false;
+		Point_t pSource = pStart;
+		if (!ClipRegion(stDest,pSource,stDest,pStart,szSize)) return true;
+
+		// Fill the first row pixel-by-pixel, then copy it to the remaining rows
+
+		unsigned char * sFirst = stDest.Row(pStart.y) + pStart.x*3;
+		unsigned char ucRed = (unsigned char) GetRed(rgbColor), ucGreen = (unsigned char) GetGreen(rgbColor), ucBlue = (unsigned char) GetBlue(rgbColor);
+
+		for (int i=0;i<szSize.cx;i++)
+		{
+			sFirst[i*3+0] = ucBlue;
+			sFirst[i*3+1] = ucGreen;
+			sFirst[i*3+2] = ucRed;
+		}
+		size_t iBytes = (size_t) szSize.cx*3;
+		ParallelRows(szSize.cy-1,szSize.cx,iThreads,[&](int iStart,int iEnd)
+		{
+			for (int i=iStart+1;i<=iEnd;i++) memcpy(stDest.Row(pStart.y+i) + pStart.x*3,sFirst,iBytes);
+		});
+		return true;
+	}
+
+	// ApplyMaskColor() -- Blend a solid color into stDest through a 24-bit mask (RawBitmap_t::ApplyMaskColor())
+	// An empty szSize uses the mask size from pMaskStart.
+	//
+	inline bool ApplyMaskColor(Color_t rgbColor,const Bitmap_t & stMask,Point_t pMaskStart,Bitmap_t & stDest,Point_t pDestStart,Size_t szSize = { 0,0 },bool bReverse = false,int iThreads = 1)
+	{
+		if (!stMask.isValid() || !stDest.isValid()) return false;
+		if (!ClipRegion(stMask,pMaskStart,stDest,pDestStart,szSize)) return true;
+
+		unsigned char sColor[3] = { (unsigned char) GetBlue(rgbColor), (unsigned char) GetGreen(rgbColor), (unsigned char) GetRed(rgbColor) };
+		auto & stKernels = GetRowKernels();
+
+		ParallelRows(szSize.cy,szSize.cx,iThreads,[&](int iStart,int iEnd)
+		{
+			for (int i=iStart;i<iEnd;i++)
+			{
+				stKernels.BlendColorRow(sColor,stMask.Row(SourceRow(stMask,pMaskStart.y+i,bReverse)) + pMaskStart.x*3,
+								stDest.Row(pDestStart.y+i) + pDestStart.x*3,szSize.cx*3);
+			}
+		});
+		return true;
+	}
+
+	// ApplyMaskGraphic() -- Blend stSource over stBackground into stDest through a 24-bit mask.  All bitmaps must be the same size.
+	// stBackground and stDest may be the same bitmap.
+	//
+	inline bool ApplyMaskGraphic(const Bitmap_t & stSource,const Bitmap_t & stMask,const Bitmap_t & stBackground,Bitmap_t & stDest,int iThreads = 1)
+	{
+		if (!stSource.isValid() || !stMask.isValid() || !stBackground.isValid() || !stDest.isValid()) return false;
+
+		int iWidth = stSource.iWidth, iHeight = stSource.iHeight;
+		if (stMask.iWidth != iWidth			|| stMask.iHeight != iHeight		||
+			stBackground.iWidth != iWidth	|| stBackground.iHeight != iHeight	||
+			stDest.iWidth != iWidth			|| stDest.iHeight != iHeight) return false;
+
+		auto & stKernels = GetRowKernels();
+		ParallelRows(iHeight,iWidth,iThreads,[&](int iStart,int iEnd)
+		{
+			for (int i=iStart;i<iEnd;i++) stKernels.BlendRow(stSource.Row(i),stMask.Row(i),stBackground.Row(i),stDest.Row(i),iWidth*3);
+		});
+		return true;
+	}
+
+	// ApplyMaskGraphic() -- Blend a region of stSource into stDest through the source's 8-bit mask plane (sMask).
+	// The destination is also the background.   An empty szSize uses the source size from pSourceStart.
+	//
+	inline bool ApplyMaskGraphic(const Bitmap_t & stSource,Point_t pSourceStart,Bitmap_t & stDest,Point_t pDestStart,Size_t szSize = { 0,0 },bool bReverse = false,int iThreads = 1)
+	{
+		if (!stSource.isValid() || !stSource.sMask || !stDest.isValid()) return false;
+		if (!ClipRegion(stSource,pSourceStart,stDest,pDestStart,szSize)) return true;
+
+		// Blending a bitmap into itself depends on row order, so it stays on one thread
+
+		if (stSource.stMem == stDest.stMem) iThreads = 1;
+
+		auto & stKernels = GetRowKernels();
+		ParallelRows(szSize.cy,szSize.cx,iThreads,[&](int iStart,int iEnd)
+		{
+			for (int i=iStart;i<iEnd;i++)
+			{
+				int iRow = SourceRow(stSource,pSourceStart.y+i,bReverse);
+				unsigned char * sDest = stDest.Row(pDestStart.y+i) + pDestStart.x*3;
+
+				stKernels.BlendRow8(stSource.Row(iRow) + pSourceStart.x*3,stSource.MaskRow(iRow) + pSourceStart.x,sDest,sDest,szSize.cx);
+			}
+		});
+		return true;
+	}
+
+	// ReverseBitmap() -- Flip the bitmap vertically, in place (RawBitmap_t::ReverseBitmap())
+	//
+	inline bool ReverseBitmap(Bitmap_t & stBitmap,int iThreads = 1)
+	{
+		if (!stBitmap.isValid()) return false;
+
+		int iBytes = stBitmap.iWidth*3;
+
+		// Each pair of rows is swapped by one thread, so only the top half is split into tiles
+
+		ParallelRows(stBitmap.iHeight/2,stBitmap.iWidth*2,iThreads,[&](int iStart,int iEnd)
+		{
+			// Swap rows through a small stack buffer so nothing is allocated
+
+			unsigned char sTemp[4096];
+
+			for (int i=iStart;i<iEnd;i++)
+			{
+				unsigned char * sTop	= stBitmap.Row(i);
+				unsigned char * sBottom	= stBitmap.Row(stBitmap.iHeight-1-i);
+
+				for (int iPlace=0;iPlace<iBytes;iPlace += (int) sizeof(sTemp))
+				{
+					int iCount = iBytes - iPlace < (int) sizeof(sTemp) ? iBytes - iPlace : (int) sizeof(sTemp);
+					memcpy(sTemp,sTop+iPlace,iCount);
+					memcpy(sTop+iPlace,sBottom+iPlace,iCount);
+					memcpy(sBottom+iPlace,sTemp,iCount);
+				}
+				if (stBitmap.sMask)
+				{
+					unsigned char * sMaskTop	= stBitmap.MaskRow(i);
+					unsigned char * sMaskBottom	= stBitmap.MaskRow(stBitmap.iHeight-1-i);
+					for (int j=0;j<stBitmap.iWidth;j++) { unsigned char c = sMaskTop[j]; sMaskTop[j] = sMaskBottom[j]; sMaskBottom[j] = c; }
+				}
+			}
+		});
+		return true;
+	}
+
+	// MasktoBmp() -- Expand the 8-bit mask plane of stSource into a gray 24-bit bitmap in stDest (RawBitmap_t::MasktoBmp())
+	// Both bitmaps must be the same size.
+	//
+	inline bool MasktoBmp(const Bitmap_t & stSource,Bitmap_t & stDest,int iThreads = 1)
+	{
+		if (!stSource.isValid() || !stSource.sMask || !stDest.isValid()) return false;
+		if (stSource.iWidth != stDest.iWidth || stSource.iHeight != stDest.iHeight) return false;
+
+		ParallelRows(stSource.iHeight,stSource.iWidth,iThreads,[&](int iStart,int iEnd)
+		{
+			for (int i=iStart;i<iEnd;i++)
+			{
+				const unsigned char * sMask = stSource.MaskRow(i);
+				unsigned char * sDest = stDest.Row(i);
+				for (int j=0;j<stSource.iWidth;j++) sDest[j*3] = sDest[j*3+1] = sDest[j*3+2] = sMask[j];
+			}
+		});
+		return true;
+	}
+
+}; // namespace Core
+}; // namespace Sage
+#endif // _CPixelKernels_H_
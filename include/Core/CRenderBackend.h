@@ -0,0 +1,120 @@
+//#pragma once
+#if !defined(_CRenderBackend_H_)
+#define _CRenderBackend_H_
+
+// ----------------------------------------------------------
+// CRenderBackend.H -- The drawing functions, as an interface
+// ----------------------------------------------------------
+//
+// CWindow's drawing functions (DrawRectangle(), DrawCircle(), SetPixel(), Cls(), DisplayBitmap(), etc.) draw through GDI, so
+// drawing code written against CWindow needs a window.  CRenderBackend has the same functions as an interface, so the same
+// drawing code can draw to different targets:
+//
+//		Core::CSoftRender	-- draws into a 32-bit bitmap in memory, with no window or GDI (Core/CSoftRender.h).  This runs
+//							   anywhere -- headless, in tests, on Linux, or to render off-screen.
+//		Sage::CWindowRender	-- draws to a CWindow, as its drawing functions do (CWindowRender.h)
+//
+// i.e.
+//
+//		void DrawScene(Core::CRenderBackend & cRender)
+//		{
+//			cRender.Cls(MakeRGB(0,0,64),MakeRGB(0,0,0));
+//			cRender.DrawCircle(200,200,50,MakeRGB(255,0,0),MakeRGB(255,255,255));
+//		}
+//
+// As with CWindow, the first color fills the shape and the second (optional, -1 for none) is the outline, drawn with the pen
+// thickness (SetPenThickness(), 1 by default).  Colors are Core::Color_t values (RGB()).
+//
+// Bitmap32_t is a 32-bit bitmap (the memory of a RawBitmap32_t): Blue, Green, Red, and an alpha (Mask) byte per pixel, with rows
+// in memory order.  Row 0 is the top row -- CWindowRender displays Core bitmaps right side up.
+//
+#include "SageCore.h"
+
+namespace Sage
+{
+namespace Core
+{
+	// ---------------------------------------
+	// Bitmap32_t -- 32-bit bitmap memory view
+	// ---------------------------------------
+	//
+	// This mirrors the memory portion of Sage::RawBitmap32_t.  Bitmap32_t does not own its memory -- use CreateBitmap32() and
+	// DeleteBitmap32() below, or wrap memory owned by a RawBitmap32_t (see toCore() in SageKernels.h).
+	//
+	struct Bitmap32_t
+	{
+		int iWidth;
+		int iHeight;
+		int iWidthBytes;
+		unsigned char * stMem;
+
+		bool isValid() const { return stMem && iWidth > 0 && iHeight > 0 && iWidthBytes >= iWidth*4; }
+		unsigned int * Row(int iY) const { return (unsigned int *) (stMem + (size_t) iY*iWidthBytes); }
+		Size_t GetSize() const { return { iWidth, iHeight }; }
+	};
+
+	// CreateBitmap32() -- Allocate a 32-bit bitmap.  The memory is not cleared.
+	// Returns an empty Bitmap32_t (isValid() == false) on failure.
+	//
+	inline Bitmap32_t CreateBitmap32(int iWidth,int iHeight)
+	{
+		Bitmap32_t stBitmap = {};
+		if (iWidth <= 0 || iHeight <= 0) return stBitmap;
+		stBitmap.stMem = (unsigned char *) malloc((size_t) iWidth*4*iHeight);
+		if (!stBitmap.stMem) return stBitmap;
+		stBitmap.iWidth			= iWidth;
+		stBitmap.iHeight		= iHeight;
+		stBitmap.iWidthBytes	= iWidth*4;
+		return stBitmap;
+	}
+
+	// DeleteBitmap32() -- Free memory allocated with CreateBitmap32() and clear the structure
+
+	inline void DeleteBitmap32(Bitmap32_t & stBitmap)
+	{
+		if (stBitmap.stMem) free(stBitmap.stMem);
+		stBitmap = {};
+	}
+
+	class CRenderBackend
+	{
+	public:
+		virtual ~CRenderBackend() { }
+
+		// GetSize() -- The size of the drawing area
+		//
+		virtual Size_t GetSize() = 0;
+
+		// SetPenThickness() -- The thickness of lines and outlines (1 by default)
+		//
+		virtual bool SetPenThickness(int iThickness) = 0;
+
+		virtual bool SetPixel(int iX,int iY,Color_t rgbColor) = 0;
+		virtual bool DrawLine(int ix1,int iy1,int ix2,int iy2,int iColor) = 0;
+		virtual bool DrawRectangle(int iX,int iY,int iWidth,int iHeight,int iColor,int iColor2 = -1) = 0;
+		virtual bool DrawCircle(int iX,int iY,int iRadius,int iColor,int iColor2 = -1) = 0;
+		virtual bool DrawPolygon(const Point_t * pPoints,int iVertices,int iColor,int iColor2 = -1) = 0;
+		virtual bool DrawTriangle(Point_t v1,Point_t v2,Point_t v3,int iColor,int iColor2 = -1)
+		{
+			Point_t pPoints[3] = { v1, v2, v3 };
+			return DrawPolygon(pPoints,3,iColor,iColor2);
+		}
+
+		// Cls() -- Clear to a color, or a gradient from iColor1 (top) to iColor2 (bottom).  With no color, the color from the
+		// last Cls() is used.
+		//
+		virtual void Cls(int iColor1 = -1,int iColor2 = -1) = 0;
+
+		// DisplayBitmap() -- Copy a 24-bit (Bitmap_t) or 32-bit (Bitmap32_t) bitmap to (iX,iY)
+		//
+		virtual bool DisplayBitmap(int iX,int iY,const Bitmap_t & stBitmap) = 0;
+		virtual bool DisplayBitmap(int iX,int iY,const Bitmap32_t & stBitmap) = 0;
+
+		// BlendBitmap() -- Blend a 32-bit bitmap at (iX,iY) through its alpha (Mask) byte
+		//
+		virtual bool BlendBitmap(int iX,int iY,const Bitmap32_t & stBitmap) = 0;
+	};
+
+}; // namespace Core
+}; // namespace Sage
+#endif // _CRenderBackend_H_
@@ -0,0 +1,461 @@
+//#pragma once
+#if !defined(_CResample_H_)
+#define _CResample_H_
+
+// -------------------------------------------------------
+// CResample.H -- Separable 24-bit bitmap resizing (Core)
+// -------------------------------------------------------
+//
+// ResizeBitmap() scales a 24-bit bitmap to any size with a Box, Bilinear or Lanczos3 filter.  This is the scaling behind QuickThumbnail(),
+// available without a window so thumbnails can be made in bulk.
+//
+// The resize is done in two passes: first vertically (source rows -> output rows, at the source width), then horizontally.
+// The vertical pass is a weighted sum of whole rows, so it vectorizes across the row; doing it first means most of the work of a large
+// reduction (i.e. a photo down to a thumbnail) happens in the SIMD-friendly pass.
+//
+// Filter weights are computed once per resize (per axis) and stored as 14-bit fixed-point values that add up to exactly 1.0, so a solid
+// color stays exactly the same color.  All sums are done in integers, so the Scalar, SSE2 and AVX2 versions give the same output.
+//
+// iThreads splits the rows across the Core thread pool (see CParallel.h) -- 1 (the default) stays on the calling thread; 0 uses every thread.
+//
+#include <math.h>
+#include <vector>
+#include "SageCore.h"
+#include "CRowKernels.h"
+#include "CParallel.h"
+#include "CBitmapPool.h"
+#include "CPixelKernels.h"
+
+namespace Sage
+{
+namespace Core
+{
+	enum class ResizeFilter
+	{
+		Box,			// Average of the covered pixels.  Fastest; blocky when enlarging
+		Bilinear,		// Triangle filter (bilinear when enlarging, area-weighted when reducing)
+		Lanczos3,		// Sharpest; best for thumbnails and photos
+	};
+
+	static constexpr int kResampleBits	= 14;					// Fixed-point precision of the filter weights
+	static constexpr int kResampleOne	= 1 << kResampleBits;
+	static constexpr int kResampleRound	= 1 << (kResampleBits-1);
+	static constexpr int kResampleStrip	= 4096;					// Bytes per strip in the vertical pass (a multiple of 32)
+
+	// ResampleWeights_t -- Precomputed filter weights for one axis.
+	// Output pixel i is the sum of source pixels [vStart[i],vStart[i]+vCount[i]) times vWeights[i*iTaps ...].
+	//
+	struct ResampleWeights_t
+	{
+		int iSize;						// Number of output pixels
+		int iTaps;						// Weights stored per output pixel (at least the largest vCount)
+		std::vector<int> vStart;
+		std::vector<int> vCount;
+		std::vector<short> vWeights;
+
+		const short * Weights(int i) const { return vWeights.data() + (size_t) i*iTaps; }
+	};
+
+	// ResampleFilter() -- Filter value at distance fX (in output pixels), and the filter's support (radius)
+
+	static inline double ResampleFilter(ResizeFilter eFilter,double fX)
+	{
+		switch (eFilter)
+		{
+			case ResizeFilter::Box:
+				return fX >= -0.5 && fX < 0.5 ? 1.0 : 0.0;
+			case ResizeFilter::Bilinear:
+				fX = fabs(fX);
+				return fX < 1.0 ? 1.0 - fX : 0.0;
+			case ResizeFilter::Lanczos3:
+			default:
+			{
+				if (fX == 0.0) return 1.0;
+				if (fX <= -3.0 || fX >= 3.0) return 0.0;
+				const double fPi = 3.14159265358979323846;
+				double fPiX = fPi*fX;
+				return 3.0*sin(fPiX)*sin(fPiX/3.0)/(fPiX*fPiX);
+			}
+		}
+	}
+	static inline double ResampleSupport(ResizeFilter eFilter)
+	{
+		return eFilter == ResizeFilter::Box ? 0.5 : eFilter == ResizeFilter::Bilinear ? 1.0 : 3.0;
+	}
+
+	// ComputeResampleWeights() -- Fill stWeights for scaling iSource pixels to iDest pixels.  Returns false if either size is 0 or less.
+	//
+	inline bool ComputeResampleWeights(int iSource,int iDest,ResizeFilter eFilter,ResampleWeights_t & stWeights)
+	{
+		if (iSource <= 0 || iDest <= 0) return false;
+
+		// When reducing, the filter is stretched to cover every source pixel (i.e. 3 output pixels either side for Lanczos3)
+
+		double fScale		= (double) iSource/iDest;
+		double fFilterScale	= fScale > 1.0 ? fScale : 1.0;
+		double fSupport		= ResampleSupport(eFilter)*fFilterScale;
+		int iTaps			= (int) ceil(fSupport)*2 + 1;
+
+		stWeights.iSize = iDest;
+		stWeights.iTaps = iTaps;
+		stWeights.vStart.assign(iDest,0);
+		stWeights.vCount.assign(iDest,0);
+		stWeights.vWeights.assign((size_t) iDest*iTaps,0);
+
+		std::vector<double> vWeights(iTaps);
+
+		for (int i=0;i<iDest;i++)
+		{
+			double fCenter = (i + 0.5)*fScale;
+			int iMin = (int) floor(fCenter - fSupport + 0.5);
+			int iMax = (int) floor(fCenter + fSupport + 0.5);
+			if (iMin < 0) iMin = 0;
+			if (iMax > iSource) iMax = iSource;
+			int iCount = iMax - iMin;
+			if (iCount > iTaps) iCount = iTaps;
+
+			double fTotal = 0;
+			for (int k=0;k<iCount;k++)
+			{
+				vWeights[k] = ResampleFilter(eFilter,(iMin + k - fCenter + 0.5)/fFilterScale);
+				fTotal += vWeights[k];
+			}
+
+			// Nothing covered (can only happen with Box at extreme enlargements) -- use the nearest pixel
+
+			if (iCount <= 0 || fTotal == 0)
+			{
+				iMin = (int) fCenter;
+				if (iMin >= iSource) iMin = iSource-1;
+				iCount = 1;
+				vWeights[0] = fTotal = 1.0;
+			}
+
+			// Convert to fixed-point and put any rounding error on the largest weight, so the weights add up to exactly 1.0
+
+			short * sWeights = stWeights.vWeights.data() + (size_t) i*iTaps;
+			int iSum = 0, iLargest = 0;
+			for (int k=0;k<iCount;k++)
+			{
+				sWeights[k] = (short) floor(vWeights[k]/fTotal*kResampleOne + 0.5);
+				iSum += sWeights[k];
+				if (sWeights[k] > sWeights[iLargest]) iLargest = k;
+			}
+			sWeights[iLargest] = (short) (sWeights[iLargest] + kResampleOne - iSum);
+
+			// Drop zero weights at either end
+
+			while (iCount > 1 && !sWeights[iCount-1]) iCount--;
+			int iSkip = 0;
+			while (iSkip < iCount-1 && !sWeights[iSkip]) iSkip++;
+			if (iSkip)
+			{
+				for (int k=0;k<iCount-iSkip;k++) sWeights[k] = sWeights[k+iSkip];
+				for (int k=iCount-iSkip;k<iCount;k++) sWeights[k] = 0;
+				iMin += iSkip;
+				iCount -= iSkip;
+			}
+
+			stWeights.vStart[i] = iMin;
+			stWeights.vCount[i] = iCount;
+		}
+		return true;
+	}
+
+	// ResampleClamp() -- Round a fixed-point sum back to 0-255.  The SIMD versions shift and then saturate, which gives the same result.
+
+	static inline unsigned char ResampleClamp(int iSum)
+	{
+		iSum >>= kResampleBits;
+		return (unsigned char) (iSum < 0 ? 0 : iSum > 255 ? 255 : iSum);
+	}
+
+	// WeightPair() -- Two 16-bit weights packed into 32 bits, as (Weight1,Weight2) for _mm_madd_epi16()
+
+	static inline int WeightPair(short sWeight1,short sWeight2) { return (int) ((unsigned int) (unsigned short) sWeight1 | ((unsigned int) (unsigned short) sWeight2 << 16)); }
+
+	// -----------------------------------
+	// Scalar (reference) passes
+	// -----------------------------------
+
+	// VerticalRowScalar() -- One output row: the weighted sum of iCount source rows (iStride bytes apart), for iBytes bytes
+
+	inline void VerticalRowScalar(const unsigned char * sSource,size_t iStride,const short * sWeights,int iCount,unsigned char * sDest,int iBytes)
+	{
+		// Work through the row in blocks, adding one source row at a time, so each source row is read in order
+
+		int iSums[1024];
+		for (int iPlace=0;iPlace<iBytes;iPlace += 1024)
+		{
+			int iBlock = iBytes - iPlace < 1024 ? iBytes - iPlace : 1024;
+			for (int i=0;i<iBlock;i++) iSums[i] = kResampleRound;
+
+			const unsigned char * sRow = sSource + iPlace;
+			for (int k=0;k<iCount;k++,sRow += iStride)
+				for (int i=0;i<iBlock;i++) iSums[i] += sRow[i]*sWeights[k];
+
+			for (int i=0;i<iBlock;i++) sDest[iPlace+i] = ResampleClamp(iSums[i]);
+		}
+	}
+
+	// HorizontalPixelScalar() -- One 24-bit output pixel from iCount source pixels
+
+	static inline void HorizontalPixelScalar(const unsigned char * sSource,const short * sWeights,int iCount,unsigned char * sDest)
+	{
+		int iBlue = kResampleRound, iGreen = kResampleRound, iRed = kResampleRound;
+		for (int k=0;k<iCount;k++,sSource += 3)
+		{
+			iBlue	+= sSource[0]*sWeights[k];
+			iGreen	+= sSource[1]*sWeights[k];
+			iRed	+= sSource[2]*sWeights[k];
+		}
+		sDest[0] = ResampleClamp(iBlue);
+		sDest[1] = ResampleClamp(iGreen);
+		sDest[2] = ResampleClamp(iRed);
+	}
+
+	// HorizontalRowScalar() -- One output row of stWeights.iSize pixels.  The source width is only needed by the AVX2 pass (the
+	// scalar pass reads exactly the pixels the weights cover), so it is unnamed here.
+
+	inline void HorizontalRowScalar(const unsigned char * sSource,int /* iSourceWidth */,const ResampleWeights_t & stWeights,unsigned char * sDest)
+	{
+		for (int i=0;i<stWeights.iSize;i++)
+			HorizontalPixelScalar(sSource + stWeights.vStart[i]*3,stWeights.Weights(i),stWeights.vCount[i],sDest + i*3);
+	}
+
+#if kSageCoreX86
+
+	// -----------------------------------
+	// SSE2 passes
+	// -----------------------------------
+	//
+	// The vertical pass takes two source rows at a time: bytes from each row are interleaved as 16-bit pairs and multiplied by a
+	// (Weight1,Weight2) pair with _mm_madd_epi16(), giving 32-bit sums.  SSE2 has no byte shuffle, so the horizontal pass is scalar.
+	//
+	kSageTargetSSE2 inline void VerticalRowSSE2(const unsigned char * sSource,size_t iStride,const short * sWeights,int iCount,unsigned char * sDest,int iBytes)
+	{
+		__m128i vZero	= _mm_setzero_si128();
+		__m128i vRound	= _mm_set1_epi32(kResampleRound);
+		int i = 0;
+
+		for (;i+16<=iBytes;i+=16)
+		{
+			__m128i vSum0 = vRound, vSum1 = vRound, vSum2 = vRound, vSum3 = vRound;
+			const unsigned char * sPlace = sSource + i;
+
+			for (int k=0;k<iCount;k+=2,sPlace += 2*iStride)
+			{
+				bool bPair = k+1 < iCount;
+				__m128i vWeights	= _mm_set1_epi32(WeightPair(sWeights[k],bPair ? sWeights[k+1] : 0));
+				__m128i vRow1		= _mm_loadu_si128((const __m128i *) sPlace);
+				__m128i vRow2		= bPair ? _mm_loadu_si128((const __m128i *) (sPlace + iStride)) : vZero;
+
+				__m128i vLow1	= _mm_unpacklo_epi8(vRow1,vZero), vHigh1 = _mm_unpackhi_epi8(vRow1,vZero);
+				__m128i vLow2	= _mm_unpacklo_epi8(vRow2,vZero), vHigh2 = _mm_unpackhi_epi8(vRow2,vZero);
+
+				vSum0 = _mm_add_epi32(vSum0,_mm_madd_epi16(_mm_unpacklo_epi16(vLow1,vLow2),vWeights));
+				vSum1 = _mm_add_epi32(vSum1,_mm_madd_epi16(_mm_unpackhi_epi16(vLow1,vLow2),vWeights));
+				vSum2 = _mm_add_epi32(vSum2,_mm_madd_epi16(_mm_unpacklo_epi16(vHigh1,vHigh2),vWeights));
+				vSum3 = _mm_add_epi32(vSum3,_mm_madd_epi16(_mm_unpackhi_epi16(vHigh1,vHigh2),vWeights));
+			}
+			vSum0 = _mm_srai_epi32(vSum0,kResampleBits);
+			vSum1 = _mm_srai_epi32(vSum1,kResampleBits);
+			vSum2 = _mm_srai_epi32(vSum2,kResampleBits);
+			vSum3 = _mm_srai_epi32(vSum3,kResampleBits);
+			_mm_storeu_si128((__m128i *) (sDest+i),_mm_packus_epi16(_mm_packs_epi32(vSum0,vSum1),_mm_packs_epi32(vSum2,vSum3)));
+		}
+		if (i < iBytes) VerticalRowScalar(sSource+i,iStride,sWeights,iCount,sDest+i,iBytes-i);
+	}
+
+	// -----------------------------------
+	// AVX2 passes
+	// -----------------------------------
+	//
+	// The vertical pass is the SSE2 version at 32 bytes.  The unpacks and packs both work within 128-bit lanes, so the bytes come out in order.
+	//
+	// The horizontal pass takes two source pixels (6 bytes) at a time: a byte shuffle pairs up their channels as 16-bit (B1,B2),(G1,G2),(R1,R2)
+	// for _mm_madd_epi16().  Each load reads 8 bytes, so pixels near the end of the row (where that would read past it) use the scalar version.
+	//
+	kSageTargetAVX2 inline void VerticalRowAVX2(const unsigned char * sSource,size_t iStride,const short * sWeights,int iCount,unsigned char * sDest,int iBytes)
+	{
+		__m256i vZero	= _mm256_setzero_si256();
+		__m256i vRound	= _mm256_set1_epi32(kResampleRound);
+		int i = 0;
+
+		for (;i+32<=iBytes;i+=32)
+		{
+			__m256i vSum0 = vRound, vSum1 = vRound, vSum2 = vRound, vSum3 = vRound;
+			const unsigned char * sPlace = sSource + i;
+
+			for (int k=0;k<iCount;k+=2,sPlace += 2*iStride)
+			{
+				bool bPair = k+1 < iCount;
+				__m256i vWeights	= _mm256_set1_epi32(WeightPair(sWeights[k],bPair ? sWeights[k+1] : 0));
+				__m256i vRow1		= _mm256_loadu_si256((const __m256i *) sPlace);
+				__m256i vRow2		= bPair ? _mm256_loadu_si256((const __m256i *) (sPlace + iStride)) : vZero;
+
+				__m256i vLow1	= _mm256_unpacklo_epi8(vRow1,vZero), vHigh1 = _mm256_unpackhi_epi8(vRow1,vZero);
+				__m256i vLow2	= _mm256_unpacklo_epi8(vRow2,vZero), vHigh2 = _mm256_unpackhi_epi8(vRow2,vZero);
+
+				vSum0 = _mm256_add_epi32(vSum0,_mm256_madd_epi16(_mm256_unpacklo_epi16(vLow1,vLow2),vWeights));
+				vSum1 = _mm256_add_epi32(vSum1,_mm256_madd_epi16(_mm256_unpackhi_epi16(vLow1,vLow2),vWeights));
+				vSum2 = _mm256_add_epi32(vSum2,_mm256_madd_epi16(_mm256_unpacklo_epi16(vHigh1,vHigh2),vWeights));
+				vSum3 = _mm256_add_epi32(vSum3,_mm256_madd_epi16(_mm256_unpackhi_epi16(vHigh1,vHigh2),vWeights));
+			}
+			vSum0 = _mm256_srai_epi32(vSum0,kResampleBits);
+			vSum1 = _mm256_srai_epi32(vSum1,kResampleBits);
+			vSum2 = _mm256_srai_epi32(vSum2,kResampleBits);
+			vSum3 = _mm256_srai_epi32(vSum3,kResampleBits);
+			_mm256_storeu_si256((__m256i *) (sDest+i),_mm256_packus_epi16(_mm256_packs_epi32(vSum0,vSum1),_mm256_packs_epi32(vSum2,vSum3)));
+		}
+		if (i < iBytes) VerticalRowSSE2(sSource+i,iStride,sWeights,iCount,sDest+i,iBytes-i);
+	}
+
+	kSageTargetAVX2 inline void HorizontalRowAVX2(const unsigned char * sSource,int iSourceWidth,const ResampleWeights_t & stWeights,unsigned char * sDest)
+	{
+		const __m128i vPairs	= _mm_setr_epi8(0,-1,3,-1, 1,-1,4,-1, 2,-1,5,-1, -1,-1,-1,-1);
+		const __m128i vRound	= _mm_set1_epi32(kResampleRound);
+		int iLoadable			= iSourceWidth*3 >= 8 ? (iSourceWidth*3 - 8)/3 + 1 : 0;		// Pixels that can start an 8-byte load inside the row
+
+		for (int i=0;i<stWeights.iSize;i++)
+		{
+			int iStart	= stWeights.vStart[i];
+			int iCount	= stWeights.vCount[i];
+			const short * sWeights = stWeights.Weights(i);
+
+			// Pairs of pixels where both loads stay inside the row
+
+			int iPairs = iCount/2;
+			if (iStart + iPairs*2 - 2 >= iLoadable) iPairs = iLoadable > iStart ? (iLoadable - iStart + 1)/2 : 0;
+
+			__m128i vSum = vRound;
+			const unsigned char * sPlace = sSource + iStart*3;
+			for (int k=0;k<iPairs;k++,sPlace += 6)
+			{
+				__m128i vPixels		= _mm_shuffle_epi8(_mm_loadl_epi64((const __m128i *) sPlace),vPairs);
+				__m128i vWeights	= _mm_set1_epi32(WeightPair(sWeights[k*2],sWeights[k*2+1]));
+				vSum = _mm_add_epi32(vSum,_mm_madd_epi16(vPixels,vWeights));
+			}
+
+			// Finish any remaining pixels in scalar, starting from the SIMD sums
+
+			alignas(16) int iSums[4];
+			_mm_store_si128((__m128i *) iSums,vSum);
+			for (int k=iPairs*2;k<iCount;k++,sPlace += 3)
+			{
+				iSums[0] += sPlace[0]*sWeights[k];
+				iSums[1] += sPlace[1]*sWeights[k];
+				iSums[2] += sPlace[2]*sWeights[k];
+			}
+			sDest[i*3+0] = ResampleClamp(iSums[0]);
+			sDest[i*3+1] = ResampleClamp(iSums[1]);
+			sDest[i*3+2] = ResampleClamp(iSums[2]);
+		}
+	}
+#endif // kSageCoreX86
+
+	// -----------------------------------
+	// Dispatch
+	// -----------------------------------
+
+	struct ResampleKernels_t
+	{
+		void (*VerticalRow)		(const unsigned char * sSource,size_t iStride,const short * sWeights,int iCount,unsigned char * sDest,int iBytes);
+		void (*HorizontalRow)	(const unsigned char * sSource,int iSourceWidth,const ResampleWeights_t & stWeights,unsigned char * sDest);
+	};
+
+	// GetResampleKernels() -- The resize passes for the current SIMD level (see SetSimdLevel())
+
+	inline const ResampleKernels_t & GetResampleKernels()
+	{
+		static const ResampleKernels_t stScalar	= { VerticalRowScalar,	HorizontalRowScalar	};
+#if kSageCoreX86
+		static const ResampleKernels_t stSSE2	= { VerticalRowSSE2,	HorizontalRowScalar	};
+		static const ResampleKernels_t stAVX2	= { VerticalRowAVX2,	HorizontalRowAVX2	};
+
+		switch (GetSimdLevel())
+		{
+			case SimdLevel::AVX2:	return stAVX2;
+			case SimdLevel::SSE2:	return stSSE2;
+			default:				break;
+		}
+#endif
+		return stScalar;
+	}
+
+	// -----------------------------------
+	// Bitmap resize
+	// -----------------------------------
+
+	// ResizeBitmap() -- Scale stSource to the size of stDest.  The intermediate buffer comes from the bitmap pool (see CBitmapPool.h),
+	// so resizing many images of the same size does not allocate each time.
+	//
+	inline bool ResizeBitmap(const Bitmap_t & stSource,Bitmap_t & stDest,ResizeFilter eFilter = ResizeFilter::Lanczos3,int iThreads = 1)
+	{
+		if (!stSource.isValid() || !stDest.isValid()) return false;
+		if (stSource.iWidth == stDest.iWidth && stSource.iHeight == stDest.iHeight) return CopyBitmap(stSource,stDest,iThreads);
+
+		auto & stKernels = GetResampleKernels();
+		bool bVertical		= stSource.iHeight != stDest.iHeight;
+		bool bHorizontal	= stSource.iWidth != stDest.iWidth;
+
+		// Vertical pass: source -> stTemp (source width, output height).  Without a horizontal pass, it writes straight to stDest.
+
+		Bitmap_t stTemp = stSource;
+		if (bVertical)
+		{
+			ResampleWeights_t stWeights;
+			ComputeResampleWeights(stSource.iHeight,stDest.iHeight,eFilter,stWeights);
+
+			stTemp = bHorizontal ? CreatePooledBitmap(stSource.iWidth,stDest.iHeight) : stDest;
+			if (!stTemp.isValid()) return false;
+
+			// The pixel counts given to ParallelRows() are scaled by the filter length, so tiles hold about the same amount of work
+
+			int iBytes = stSource.iWidth*3;
+			ParallelRows(stDest.iHeight,stSource.iWidth*stWeights.iTaps/4,iThreads,[&](int iStart,int iEnd)
+			{
+				// Work in vertical strips so the source rows shared by neighboring output rows are still in the cache
+
+				for (int iStrip=0;iStrip<iBytes;iStrip += kResampleStrip)
+				{
+					int iStripBytes = iBytes - iStrip < kResampleStrip ? iBytes - iStrip : kResampleStrip;
+					for (int i=iStart;i<iEnd;i++)
+					{
+						stKernels.VerticalRow(stSource.Row(stWeights.vStart[i]) + iStrip,stSource.iWidthBytes,stWeights.Weights(i),stWeights.vCount[i],
+											  stTemp.Row(i) + iStrip,iStripBytes);
+					}
+				}
+			});
+		}
+
+		// Horizontal pass: stTemp -> stDest
+
+		if (bHorizontal)
+		{
+			ResampleWeights_t stWeights;
+			ComputeResampleWeights(stSource.iWidth,stDest.iWidth,eFilter,stWeights);
+
+			ParallelRows(stDest.iHeight,stDest.iWidth*stWeights.iTaps,iThreads,[&](int iStart,int iEnd)
+			{
+				for (int i=iStart;i<iEnd;i++) stKernels.HorizontalRow(stTemp.Row(i),stSource.iWidth,stWeights,stDest.Row(i));
+			});
+			if (bVertical) ReleasePooledBitmap(stTemp);
+		}
+		return true;
+	}
+
+	// ResizeBitmap() -- Scale stSource to a new iWidth x iHeight bitmap.  Free it with DeleteBitmap().
+
+	[[nodiscard]] inline Bitmap_t ResizeBitmap(const Bitmap_t & stSource,int iWidth,int iHeight,ResizeFilter eFilter = ResizeFilter::Lanczos3,int iThreads = 1,bool * bSuccess = nullptr)
+	{
+		Bitmap_t stDest = stSource.isValid() ? CreateBitmap(iWidth,iHeight) : Bitmap_t{};
+		bool bResult = stDest.isValid() && ResizeBitmap(stSource,stDest,eFilter,iThreads);
+		if (!bResult) DeleteBitmap(stDest);
+		if (bSuccess) *bSuccess = bResult;
+		return stDest;
+	}
+
+}; // namespace Core
+}; // namespace Sage
+#endif // _CResample_H_
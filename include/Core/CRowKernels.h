@@ -0,0 +1,375 @@
+//#pragma once
+#if !defined(_CRowKernels_H_)
+#define _CRowKernels_H_
+
+// --------------------------------------------------------------
+// CRowKernels.H -- Scalar, SSE2 and AVX2 row kernels with dispatch
+// --------------------------------------------------------------
+//
+// The mask blends behind ApplyMaskGraphic() and ApplyMaskColor() work on one row (span of bytes) at a time.
+// Each has three versions:
+//
+//		xxxScalar()		-- The reference version.  The SIMD versions are bit-exact with these.
+//		xxxSSE2()		-- 16 bytes at a time
+//		xxxAVX2()		-- 32 bytes at a time
+//
+// The best version for the CPU is picked on first use through GetRowKernels(), using CPUID (see CCpuInfo.h).
+// SetSimdLevel() can force a specific level, i.e. for comparing results or timing the versions against each other.
+//
+// Blends are rounded to nearest: Dest = (Source*Mask + Background*(255-Mask))/255, computed exactly in 16 bits with Div255().
+//
+#include <atomic>
+#include "SageCore.h"
+#include "CCpuInfo.h"
+
+#if kSageCoreX86
+	#include <emmintrin.h>
+	#include <immintrin.h>
+
+	// GCC/Clang need the target instruction set on each function using it; MSVC allows the intrinsics anywhere.
+
+	#if defined(_MSC_VER)
+		#define kSageTargetSSE2
+		#define kSageTargetAVX2
+	#else
+		#if defined(__x86_64__)
+			#define kSageTargetSSE2
+		#else
+			#define kSageTargetSSE2 __attribute__((target("sse2")))
+		#endif
+		#define kSageTargetAVX2 __attribute__((target("avx2")))
+	#endif
+#endif
+
+namespace Sage
+{
+namespace Core
+{
+	// Div255() -- (iValue/255) rounded to nearest, for iValue in [0,255*255].  This is exact and stays within 16 bits, so the SIMD versions do the same thing.
+
+	static inline unsigned int Div255(unsigned int iValue)
+	{
+		iValue += 128;
+		return (iValue + (iValue >> 8)) >> 8;
+	}
+
+	// -----------------------------------
+	// Scalar (reference) row kernels
+	// -----------------------------------
+
+	// BlendRowScalar() -- Blend Source over Background with a per-byte mask, for iBytes bytes (24-bit masks apply to each channel separately)
+
+	inline void BlendRowScalar(const unsigned char * sSource,const unsigned char * sMask,const unsigned char * sBackground,unsigned char * sDest,int iBytes)
+	{
+		for (int i=0;i<iBytes;i++)
+		{
+			unsigned int iMask = sMask[i];
+			sDest[i] = (unsigned char) Div255(sSource[i]*iMask + sBackground[i]*(255-iMask));
+		}
+	}
+
+	// BlendColorRowScalar() -- Blend a solid color into sDest with a per-byte mask.  sColor is the color in memory (Blue,Green,Red) order.
+	// iBytes must cover whole pixels.
+
+	inline void BlendColorRowScalar(const unsigned char * sColor,const unsigned char * sMask,unsigned char * sDest,int iBytes)
+	{
+		for (int i=0;i<iBytes;i+=3)
+		{
+			for (int j=0;j<3;j++)
+			{
+				unsigned int iMask = sMask[i+j];
+				sDest[i+j] = (unsigned char) Div255(sColor[j]*iMask + sDest[i+j]*(255-iMask));
+			}
+		}
+	}
+
+	// BlendRow8Scalar() -- Blend Source over Background with an 8-bit mask, one mask value per pixel, for iPixels pixels
+
+	inline void BlendRow8Scalar(const unsigned char * sSource,const unsigned char * sMask,const unsigned char * sBackground,unsigned char * sDest,int iPixels)
+	{
+		for (int i=0;i<iPixels;i++)
+		{
+			unsigned int iMask = sMask[i];
+			for (int j=0;j<3;j++)
+				sDest[i*3+j] = (unsigned char) Div255(sSource[i*3+j]*iMask + sBackground[i*3+j]*(255-iMask));
+		}
+	}
+
+#if kSageCoreX86
+
+	// -----------------------------------
+	// SSE2 row kernels
+	// -----------------------------------
+
+	// Blend16SSE2() -- Blend 16 bytes: unpack to 16 bits, multiply, Div255() and pack back.
+
+	kSageTargetSSE2 static inline __m128i Blend16SSE2(__m128i vSource,__m128i vMask,__m128i vBackground)
+	{
+		const __m128i vZero	= _mm_setzero_si128();
+		const __m128i v255	= _mm_set1_epi16(255);
+		const __m128i v128	= _mm_set1_epi16(128);
+
+		__m128i vMaskLo = _mm_unpacklo_epi8(vMask,vZero);
+		__m128i vMaskHi = _mm_unpackhi_epi8(vMask,vZero);
+
+		__m128i vLo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(vSource,vZero),vMaskLo),
+									_mm_mullo_epi16(_mm_unpacklo_epi8(vBackground,vZero),_mm_sub_epi16(v255,vMaskLo)));
+		__m128i vHi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(vSource,vZero),vMaskHi),
+									_mm_mullo_epi16(_mm_unpackhi_epi8(vBackground,vZero),_mm_sub_epi16(v255,vMaskHi)));
+
+		vLo = _mm_add_epi16(vLo,v128);
+		vHi = _mm_add_epi16(vHi,v128);
+		vLo = _mm_srli_epi16(_mm_add_epi16(vLo,_mm_srli_epi16(vLo,8)),8);
+		vHi = _mm_srli_epi16(_mm_add_epi16(vHi,_mm_srli_epi16(vHi,8)),8);
+
+		return _mm_packus_epi16(vLo,vHi);
+	}
+
+	kSageTargetSSE2 inline void BlendRowSSE2(const unsigned char * sSource,const unsigned char * sMask,const unsigned char * sBackground,unsigned char * sDest,int iBytes)
+	{
+		int i = 0;
+		for (;i+16<=iBytes;i+=16)
+		{
+			__m128i vResult = Blend16SSE2(_mm_loadu_si128((const __m128i *) (sSource+i)),_mm_loadu_si128((const __m128i *) (sMask+i)),
+										  _mm_loadu_si128((const __m128i *) (sBackground+i)));
+			_mm_storeu_si128((__m128i *) (sDest+i),vResult);
+		}
+		BlendRowScalar(sSource+i,sMask+i,sBackground+i,sDest+i,iBytes-i);
+	}
+
+	// BlendColorRowSSE2() -- 48 bytes (16 pixels) at a time, so the 3-byte color pattern lines up with three vectors
+
+	kSageTargetSSE2 inline void BlendColorRowSSE2(const unsigned char * sColor,const unsigned char * sMask,unsigned char * sDest,int iBytes)
+	{
+		unsigned char sPattern[48];
+		for (int i=0;i<48;i++) sPattern[i] = sColor[i % 3];
+
+		__m128i vColor0 = _mm_loadu_si128((const __m128i *) (sPattern+0));
+		__m128i vColor1 = _mm_loadu_si128((const __m128i *) (sPattern+16));
+		__m128i vColor2 = _mm_loadu_si128((const __m128i *) (sPattern+32));
+
+		int i = 0;
+		for (;i+48<=iBytes;i+=48)
+		{
+			__m128i * vDest = (__m128i *) (sDest+i);
+			const __m128i * vMask = (const __m128i *) (sMask+i);
+
+			_mm_storeu_si128(vDest+0,Blend16SSE2(vColor0,_mm_loadu_si128(vMask+0),_mm_loadu_si128(vDest+0)));
+			_mm_storeu_si128(vDest+1,Blend16SSE2(vColor1,_mm_loadu_si128(vMask+1),_mm_loadu_si128(vDest+1)));
+			_mm_storeu_si128(vDest+2,Blend16SSE2(vColor2,_mm_loadu_si128(vMask+2),_mm_loadu_si128(vDest+2)));
+		}
+		BlendColorRowScalar(sColor,sMask+i,sDest+i,iBytes-i);
+	}
+
+	// BlendRow8SSE2() -- SSE2 has no byte shuffle, so the 8-bit mask is expanded to 3 bytes per pixel 16 pixels at a time, then blended as 24-bit
+
+	kSageTargetSSE2 inline void BlendRow8SSE2(const unsigned char * sSource,const unsigned char * sMask,const unsigned char * sBackground,unsigned char * sDest,int iPixels)
+	{
+		unsigned char sMask24[48];
+		int i = 0;
+		for (;i+16<=iPixels;i+=16)
+		{
+			for (int j=0;j<16;j++) sMask24[j*3] = sMask24[j*3+1] = sMask24[j*3+2] = sMask[i+j];
+
+			for (int j=0;j<3;j++)
+			{
+				int iOffset = i*3 + j*16;
+				__m128i vResult = Blend16SSE2(_mm_loadu_si128((const __m128i *) (sSource+iOffset)),_mm_loadu_si128((const __m128i *) (sMask24+j*16)),
+											  _mm_loadu_si128((const __m128i *) (sBackground+iOffset)));
+				_mm_storeu_si128((__m128i *) (sDest+iOffset),vResult);
+			}
+		}
+		BlendRow8Scalar(sSource+i*3,sMask+i,sBackground+i*3,sDest+i*3,iPixels-i);
+	}
+
+	// -----------------------------------
+	// AVX2 row kernels
+	// -----------------------------------
+
+	// Blend32AVX2() -- Blend 32 bytes.  Unpack and pack both work within 128-bit lanes, so the byte order comes back out unchanged.
+
+	kSageTargetAVX2 static inline __m256i Blend32AVX2(__m256i vSource,__m256i vMask,__m256i vBackground)
+	{
+		const __m256i vZero	= _mm256_setzero_si256();
+		const __m256i v255	= _mm256_set1_epi16(255);
+		const __m256i v128	= _mm256_set1_epi16(128);
+
+		__m256i vMaskLo = _mm256_unpacklo_epi8(vMask,vZero);
+		__m256i vMaskHi = _mm256_unpackhi_epi8(vMask,vZero);
+
+		__m256i vLo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(vSource,vZero),vMaskLo),
+									   _mm256_mullo_epi16(_mm256_unpacklo_epi8(vBackground,vZero),_mm256_sub_epi16(v255,vMaskLo)));
+		__m256i vHi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(vSource,vZero),vMaskHi),
+									   _mm256_mullo_epi16(_mm256_unpackhi_epi8(vBackground,vZero),_mm256_sub_epi16(v255,vMaskHi)));
+
+		vLo = _mm256_add_epi16(vLo,v128);
+		vHi = _mm256_add_epi16(vHi,v128);
+		vLo = _mm256_srli_epi16(_mm256_add_epi16(vLo,_mm256_srli_epi16(vLo,8)),8);
+		vHi = _mm256_srli_epi16(_mm256_add_epi16(vHi,_mm256_srli_epi16(vHi,8)),8);
+
+		return _mm256_packus_epi16(vLo,vHi);
+	}
+
+	kSageTargetAVX2 inline void BlendRowAVX2(const unsigned char * sSource,const unsigned char * sMask,const unsigned char * sBackground,unsigned char * sDest,int iBytes)
+	{
+		int i = 0;
+		for (;i+32<=iBytes;i+=32)
+		{
+			__m256i vResult = Blend32AVX2(_mm256_loadu_si256((const __m256i *) (sSource+i)),_mm256_loadu_si256((const __m256i *) (sMask+i)),
+										  _mm256_loadu_si256((const __m256i *) (sBackground+i)));
+			_mm256_storeu_si256((__m256i *) (sDest+i),vResult);
+		}
+		BlendRowScalar(sSource+i,sMask+i,sBackground+i,sDest+i,iBytes-i);
+	}
+
+	// BlendColorRowAVX2() -- 96 bytes (32 pixels) at a time, so the 3-byte color pattern lines up with three vectors
+
+	kSageTargetAVX2 inline void BlendColorRowAVX2(const unsigned char * sColor,const unsigned char * sMask,unsigned char * sDest,int iBytes)
+	{
+		unsigned char sPattern[96];
+		for (int i=0;i<96;i++) sPattern[i] = sColor[i % 3];
+
+		__m256i vColor0 = _mm256_loadu_si256((const __m256i *) (sPattern+0));
+		__m256i vColor1 = _mm256_loadu_si256((const __m256i *) (sPattern+32));
+		__m256i vColor2 = _mm256_loadu_si256((const __m256i *) (sPattern+64));
+
+		int i = 0;
+		for (;i+96<=iBytes;i+=96)
+		{
+			__m256i * vDest = (__m256i *) (sDest+i);
+			const __m256i * vMask = (const __m256i *) (sMask+i);
+
+			_mm256_storeu_si256(vDest+0,Blend32AVX2(vColor0,_mm256_loadu_si256(vMask+0),_mm256_loadu_si256(vDest+0)));
+			_mm256_storeu_si256(vDest+1,Blend32AVX2(vColor1,_mm256_loadu_si256(vMask+1),_mm256_loadu_si256(vDest+1)));
+			_mm256_storeu_si256(vDest+2,Blend32AVX2(vColor2,_mm256_loadu_si256(vMask+2),_mm256_loadu_si256(vDest+2)));
+		}
+		BlendColorRowScalar(sColor,sMask+i,sDest+i,iBytes-i);
+	}
+
+	// ExpandMask16AVX2() -- Expand 16 8-bit mask values to 48 bytes (3 per pixel) with byte shuffles
+
+	kSageTargetAVX2 static inline void ExpandMask16AVX2(__m128i vMask,__m128i & vOut0,__m128i & vOut1,__m128i & vOut2)
+	{
+		vOut0 = _mm_shuffle_epi8(vMask,_mm_setr_epi8(0,0,0,1,1,1,2,2,2,3,3,3,4,4,4,5));
+		vOut1 = _mm_shuffle_epi8(vMask,_mm_setr_epi8(5,5,6,6,6,7,7,7,8,8,8,9,9,9,10,10));
+		vOut2 = _mm_shuffle_epi8(vMask,_mm_setr_epi8(10,11,11,11,12,12,12,13,13,13,14,14,14,15,15,15));
+	}
+
+	kSageTargetAVX2 static inline __m256i Combine128AVX2(__m128i vLow,__m128i vHigh)
+	{
+		return _mm256_inserti128_si256(_mm256_castsi128_si256(vLow),vHigh,1);
+	}
+
+	// BlendRow8AVX2() -- 32 pixels (96 bytes) at a time, expanding the 8-bit mask with byte shuffles
+
+	kSageTargetAVX2 inline void BlendRow8AVX2(const unsigned char * sSource,const unsigned char * sMask,const unsigned char * sBackground,unsigned char * sDest,int iPixels)
+	{
+		int i = 0;
+		for (;i+32<=iPixels;i+=32)
+		{
+			__m128i vM0, vM1, vM2, vM3, vM4, vM5;
+			ExpandMask16AVX2(_mm_loadu_si128((const __m128i *) (sMask+i)),vM0,vM1,vM2);
+			ExpandMask16AVX2(_mm_loadu_si128((const __m128i *) (sMask+i+16)),vM3,vM4,vM5);
+
+			__m256i vMask[3] = { Combine128AVX2(vM0,vM1), Combine128AVX2(vM2,vM3), Combine128AVX2(vM4,vM5) };
+
+			for (int j=0;j<3;j++)
+			{
+				int iOffset = i*3 + j*32;
+				__m256i vResult = Blend32AVX2(_mm256_loadu_si256((const __m256i *) (sSource+iOffset)),vMask[j],
+											  _mm256_loadu_si256((const __m256i *) (sBackground+iOffset)));
+				_mm256_storeu_si256((__m256i *) (sDest+iOffset),vResult);
+			}
+		}
+		BlendRow8Scalar(sSource+i*3,sMask+i,sBackground+i*3,sDest+i*3,iPixels-i);
+	}
+
+#endif // kSageCoreX86
+
+	// -----------------------------------
+	// Runtime dispatch
+	// -----------------------------------
+
+	enum class SimdLevel
+	{
+		Scalar,
+		SSE2,
+		AVX2,
+		Auto,			// Best level supported by the CPU
+	};
+
+	struct RowKernels_t
+	{
+		SimdLevel eLevel;
+		const char * sName;
+		void (*BlendRow)		(const unsigned char * sSource,const unsigned char * sMask,const unsigned char * sBackground,unsigned char * sDest,int iBytes);
+		void (*BlendColorRow)	(const unsigned char * sColor,const unsigned char * sMask,unsigned char * sDest,int iBytes);
+		void (*BlendRow8)		(const unsigned char * sSource,const unsigned char * sMask,const unsigned char * sBackground,unsigned char * sDest,int iPixels);
+	};
+
+	// GetRowKernelTable() -- Returns the kernels for a specific level, or nullptr if the CPU does not support it.
+
+	inline const RowKernels_t * GetRowKernelTable(SimdLevel eLevel)
+	{
+		static const RowKernels_t stScalar	= { SimdLevel::Scalar,	"Scalar",	BlendRowScalar,	BlendColorRowScalar,	BlendRow8Scalar	};
+#if kSageCoreX86
+		static const RowKernels_t stSSE2	= { SimdLevel::SSE2,	"SSE2",		BlendRowSSE2,	BlendColorRowSSE2,		BlendRow8SSE2	};
+		static const RowKernels_t stAVX2	= { SimdLevel::AVX2,	"AVX2",		BlendRowAVX2,	BlendColorRowAVX2,		BlendRow8AVX2	};
+#endif
+		auto & stCpu = GetCpuInfo();
+
+		switch (eLevel)
+		{
+			case SimdLevel::Scalar:	return &stScalar;
+#if kSageCoreX86
+			case SimdLevel::SSE2:	return stCpu.bSSE2 ? &stSSE2 : nullptr;
+			case SimdLevel::AVX2:	return stCpu.bAVX2 ? &stAVX2 : nullptr;
+			case SimdLevel::Auto:	return stCpu.bAVX2 ? &stAVX2 : stCpu.bSSE2 ? &stSSE2 : &stScalar;
+#else
+			case SimdLevel::Auto:	return &stScalar;
+#endif
+			default:				return nullptr;
+		}
+	}
+
+	static inline std::atomic<const RowKernels_t *> & ActiveRowKernels()
+	{
+		static std::atomic<const RowKernels_t *> stActive(GetRowKernelTable(SimdLevel::Auto));
+		return stActive;
+	}
+
+	// GetRowKernels() -- The row kernels in use (the best for the CPU unless changed with SetSimdLevel())
+
+	inline const RowKernels_t & GetRowKernels() { return *ActiveRowKernels().load(std::memory_order_relaxed); }
+
+	// SetSimdLevel() -- Force a SIMD level for all Core kernels.  Returns false (with no change) if the CPU does not support it.
+	// Use SimdLevel::Auto to return to the default.
+	//
+	inline bool SetSimdLevel(SimdLevel eLevel)
+	{
+		const RowKernels_t * stKernels = GetRowKernelTable(eLevel);
+		if (!stKernels) return false;
+		ActiveRowKernels().store(stKernels,std::memory_order_relaxed);
+		return true;
+	}
+
+	inline SimdLevel GetSimdLevel() { return GetRowKernels().eLevel; }
+
+	// BlendRow(), BlendColorRow(), BlendRow8() -- Dispatched versions of the row kernels above
+
+	inline void BlendRow(const unsigned char * sSource,const unsigned char * sMask,const unsigned char * sBackground,unsigned char * sDest,int iBytes)
+	{
+		GetRowKernels().BlendRow(sSource,sMask,sBackground,sDest,iBytes);
+	}
+	inline void BlendColorRow(const unsigned char * sColor,const unsigned char * sMask,unsigned char * sDest,int iBytes)
+	{
+		GetRowKernels().BlendColorRow(sColor,sMask,sDest,iBytes);
+	}
+	inline void BlendRow8(const unsigned char * sSource,const unsigned char * sMask,const unsigned char * sBackground,unsigned char * sDest,int iPixels)
+	{
+		GetRowKernels().BlendRow8(sSource,sMask,sBackground,sDest,iPixels);
+	}
+
+}; // namespace Core
+}; // namespace Sage
+#endif // _CRowKernels_H_
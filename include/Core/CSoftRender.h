@@ -0,0 +1,358 @@
+//#pragma once
+#if !defined(_CSoftRender_H_)
+#define _CSoftRender_H_
+
+// ------------------------------------------------------
+// CSoftRender.H -- Software drawing into a 32-bit bitmap
+// ------------------------------------------------------
+//
+// CSoftRender is the CRenderBackend (see Core/CRenderBackend.h) that draws into a Bitmap32_t in memory, without a window or GDI:
+//
+//		Core::Bitmap32_t stCanvas = Core::CreateBitmap32(1280,720);		// Or Core::toCore(MyRawBitmap32) (SageKernels.h)
+//		Core::CSoftRender cRender(stCanvas);
+//
+//		cRender.Cls(MakeRGB(0,0,64),MakeRGB(0,0,0));
+//		cRender.DrawCircle(200,200,50,MakeRGB(255,0,0));
+//
+// Everything is clipped to the bitmap.  Shapes are filled by scanline, sampling at pixel centers, so shapes that share an edge
+// don't overlap or leave gaps.  Lines are 1 pixel (Bresenham), or filled as a quadrangle for thicker pens.  Shapes are not
+// anti-aliased.
+//
+// Pixels are written with an alpha of 255.  BlendBitmap() blends with the source's alpha.
+//
+// CSoftRender doesn't own the bitmap, and isn't thread-safe (use one per thread, each with its own bitmap or part of one).
+//
+#include <math.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+#include "CRenderBackend.h"
+
+namespace Sage
+{
+namespace Core
+{
+	class CSoftRender : public CRenderBackend
+	{
+	private:
+		Bitmap32_t m_stCanvas;
+		int m_iPenThickness		= 1;
+		unsigned int m_uiClsColor	= 0xFF000000;
+		std::vector<float> m_vCross;			// Scanline crossings for FillPolygon() (kept to avoid allocating per shape)
+		std::vector<float> m_vX, m_vY;		// Vertices for DrawPolygon()
+
+		// Pixel() -- A Color_t (0x00BBGGRR) as a 32-bit pixel (B,G,R,A in memory)
+
+		static unsigned int Pixel(Color_t rgbColor)
+		{
+			return 0xFF000000 | ((rgbColor & 0xFF) << 16) | (rgbColor & 0xFF00) | ((rgbColor >> 16) & 0xFF);
+		}
+
+		// FillSpan() -- Fill pixels iX1 to iX2 (inclusive) of row iY, clipped
+
+		void FillSpan(int iX1,int iX2,int iY,unsigned int uiPixel)
+		{
+			if (iY < 0 || iY >= m_stCanvas.iHeight) return;
+			if (iX1 < 0) iX1 = 0;
+			if (iX2 >= m_stCanvas.iWidth) iX2 = m_stCanvas.iWidth - 1;
+			if (iX2 >= iX1) std::fill_n(m_stCanvas.Row(iY) + iX1,iX2 - iX1 + 1,uiPixel);
+		}
+
+		// FillRect() -- Fill (iX1,iY1) to (iX2,iY2), exclusive, clipped
+
+		void FillRect(int iX1,int iY1,int iX2,int iY2,unsigned int uiPixel)
+		{
+			if (iY1 < 0) iY1 = 0;
+			if (iY2 > m_stCanvas.iHeight) iY2 = m_stCanvas.iHeight;
+			for (int y=iY1;y<iY2;y++) FillSpan(iX1,iX2 - 1,y,uiPixel);
+		}
+
+		// FillPolygon() -- Fill a polygon (even-odd rule) with vertices in pfX/pfY, sampling at pixel centers
+
+		void FillPolygon(const float * pfX,const float * pfY,int iVertices,unsigned int uiPixel)
+		{
+			float fTop = pfY[0], fBottom = pfY[0];
+			for (int i=1;i<iVertices;i++) { fTop = std::min(fTop,pfY[i]); fBottom = std::max(fBottom,pfY[i]); }
+			int iTop	= std::max(0,(int) ceilf(fTop - 0.5f));
+			int iBottom	= std::min(m_stCanvas.iHeight - 1,(int) ceilf(fBottom - 0.5f) - 1);
+
+			for (int y=iTop;y<=iBottom;y++)
+			{
+				float fY = y + 0.5f;
+				m_vCross.clear();
+				for (int i=0,j=iVertices-1;i<iVertices;j=i++)
+				{
+					float fY1 = pfY[j], fY2 = pfY[i];
+					if ((fY1 <= fY && fY < fY2) || (fY2 <= fY && fY < fY1))
+						m_vCross.push_back(pfX[j] + (fY - fY1)*(pfX[i] - pfX[j])/(fY2 - fY1));
+				}
+				std::sort(m_vCross.begin(),m_vCross.end());
+				for (size_t i=0;i+1<m_vCross.size();i+=2)
+					FillSpan((int) ceilf(m_vCross[i] - 0.5f),(int) ceilf(m_vCross[i+1] - 0.5f) - 1,y,uiPixel);
+			}
+		}
+
+		// ThinLine() -- A 1-pixel line (the same pixels as Bresenham), clipped to the canvas before it is drawn.
+		//
+		// Step k along the major axis (the longer one) has its minor coordinate at floor((2*k*iMinor + iMajor)/(2*iMajor)) steps
+		// from the start.  Only the steps with the major coordinate on the canvas are walked, starting with the exact minor
+		// position and error for the first one, so a line far off the canvas costs no more than one across it.  Lengths and error
+		// terms are 64-bit, so any int coordinates work.
+		//
+		void ThinLine(int ix1,int iy1,int ix2,int iy2,unsigned int uiPixel)
+		{
+			long long iDX = llabs((long long) ix2 - ix1), iDY = llabs((long long) iy2 - iy1);
+			bool bXMajor = iDX >= iDY;
+
+			long long iMajor	= bXMajor ? iDX : iDY,					iMinor		= bXMajor ? iDY : iDX;
+			long long iStart	= bXMajor ? ix1 : iy1,					iMinorStart	= bXMajor ? iy1 : ix1;
+			int iStep			= (bXMajor ? ix1 < ix2 : iy1 < iy2) ? 1 : -1;
+			int iMinorStep		= (bXMajor ? iy1 < iy2 : ix1 < ix2) ? 1 : -1;
+			long long iSize		= bXMajor ? m_stCanvas.iWidth : m_stCanvas.iHeight;
+			long long iMinorSize	= bXMajor ? m_stCanvas.iHeight : m_stCanvas.iWidth;
+
+			if (!iMajor)
+			{
+				if ((unsigned) ix1 < (unsigned) m_stCanvas.iWidth && (unsigned) iy1 < (unsigned) m_stCanvas.iHeight) m_stCanvas.Row(iy1)[ix1] = uiPixel;
+				return;
+			}
+
+			// The steps with the major coordinate on the canvas
+
+			long long kFirst	= iStep > 0 ? std::max(0LL,-iStart) : std::max(0LL,iStart - (iSize - 1));
+			long long kLast		= iStep > 0 ? std::min(iMajor,iSize - 1 - iStart) : std::min(iMajor,iStart);
+			if (kFirst > kLast) return;
+
+			// Minor position and error at kFirst.  kFirst*iMinor <= iMajor^2 < 2^64, so it is exact as unsigned.
+
+			long long iMinorPos = 0, iError = iMajor;						// 0 <= iError < 2*iMajor
+			if (kFirst)
+			{
+				unsigned long long uiProduct = (unsigned long long) kFirst*(unsigned long long) iMinor;
+				long long iRemainder = (long long) (uiProduct % (unsigned long long) iMajor);
+				bool bRound = 2*iRemainder >= iMajor;
+				iMinorPos	= (long long) (uiProduct/(unsigned long long) iMajor) + bRound;
+				iError		= 2*iRemainder + iMajor - (bRound ? 2*iMajor : 0);
+			}
+
+			// Walk the steps, moving a pixel offset -- by iStride along the major axis, and iMinorStride when the minor coordinate steps
+
+			long long iMinorCoord	= iMinorStart + iMinorStep*iMinorPos;
+			long long iMajorCoord	= iStart + iStep*kFirst;
+			long long iPitch		= m_stCanvas.iWidthBytes/4;
+			long long iStride		= bXMajor ? iStep : iStep*iPitch;
+			long long iMinorStride	= bXMajor ? iMinorStep*iPitch : iMinorStep;
+			long long iOffset		= bXMajor ? iMinorCoord*iPitch + iMajorCoord : iMajorCoord*iPitch + iMinorCoord;
+			unsigned int * pCanvas	= (unsigned int *) m_stCanvas.stMem;
+
+			for (long long k=kFirst;k<=kLast;k++)
+			{
+				if ((unsigned long long) iMinorCoord < (unsigned long long) iMinorSize) pCanvas[iOffset] = uiPixel;
+				else if ((iMinorStep > 0) == (iMinorCoord >= iMinorSize)) break;		// Past the canvas, going away from it
+
+				iOffset += iStride;
+				iError += 2*iMinor;
+				if (iError >= 2*iMajor) { iError -= 2*iMajor; iMinorCoord += iMinorStep; iOffset += iMinorStride; }
+			}
+		}
+
+		void Line(int ix1,int iy1,int ix2,int iy2,unsigned int uiPixel)
+		{
+			if (m_iPenThickness <= 1) { ThinLine(ix1,iy1,ix2,iy2,uiPixel); return; }
+
+			// Thick lines -- the line as a quadrangle, pen-thickness wide, centered on the line
+
+			float fDX = (float) ((long long) ix2 - ix1), fDY = (float) ((long long) iy2 - iy1);
+			float fLength = sqrtf(fDX*fDX + fDY*fDY);
+			float fHalf = m_iPenThickness*0.5f;
+			if (fLength == 0) { FillRect(ix1 - m_iPenThickness/2,iy1 - m_iPenThickness/2,ix1 - m_iPenThickness/2 + m_iPenThickness,iy1 - m_iPenThickness/2 + m_iPenThickness,uiPixel); return; }
+			float fNX = -fDY/fLength*fHalf, fNY = fDX/fLength*fHalf;
+			float fX1 = ix1 + 0.5f, fY1 = iy1 + 0.5f, fX2 = ix2 + 0.5f, fY2 = iy2 + 0.5f;
+			float pfX[4] = { fX1 + fNX, fX2 + fNX, fX2 - fNX, fX1 - fNX };
+			float pfY[4] = { fY1 + fNY, fY2 + fNY, fY2 - fNY, fY1 - fNY };
+			FillPolygon(pfX,pfY,4,uiPixel);
+		}
+
+		// Clip() -- Clip a bitmap copy to the canvas.  Returns false if nothing is left.
+
+		bool Clip(int & iX,int & iY,int & iSourceX,int & iSourceY,int & iWidth,int & iHeight) const
+		{
+			iSourceX = iX < 0 ? -iX : 0;
+			iSourceY = iY < 0 ? -iY : 0;
+			iX += iSourceX; iY += iSourceY;
+			iWidth	= std::min(iWidth - iSourceX,m_stCanvas.iWidth - iX);
+			iHeight	= std::min(iHeight - iSourceY,m_stCanvas.iHeight - iY);
+			return iWidth > 0 && iHeight > 0;
+		}
+
+	public:
+		CSoftRender(const Bitmap32_t & stCanvas) : m_stCanvas(stCanvas) { }
+
+		// SetCanvas() -- Draw into another bitmap
+		//
+		void SetCanvas(const Bitmap32_t & stCanvas) { m_stCanvas = stCanvas; }
+		const Bitmap32_t & GetCanvas() const { return m_stCanvas; }
+
+		Size_t GetSize() override { return m_stCanvas.isValid() ? m_stCanvas.GetSize() : Size_t{ 0, 0 }; }
+
+		bool SetPenThickness(int iThickness) override
+		{
+			if (iThickness < 1) return false;
+			m_iPenThickness = iThickness;
+			return true;
+		}
+
+		// GetPixel() -- The color at (iX,iY) (0 outside the canvas)
+		//
+		Color_t GetPixel(int iX,int iY) const
+		{
+			if (!m_stCanvas.isValid() || (unsigned) iX >= (unsigned) m_stCanvas.iWidth || (unsigned) iY >= (unsigned) m_stCanvas.iHeight) return 0;
+			unsigned int uiPixel = m_stCanvas.Row(iY)[iX];
+			return MakeRGB((uiPixel >> 16) & 0xFF,(uiPixel >> 8) & 0xFF,uiPixel & 0xFF);
+		}
+
+		bool SetPixel(int iX,int iY,Color_t rgbColor) override
+		{
+			if (!m_stCanvas.isValid() || (unsigned) iX >= (unsigned) m_stCanvas.iWidth || (unsigned) iY >= (unsigned) m_stCanvas.iHeight) return false;
+			m_stCanvas.Row(iY)[iX] = Pixel(rgbColor);
+			return true;
+		}
+
+		bool DrawLine(int ix1,int iy1,int ix2,int iy2,int iColor) override
+		{
+			if (!m_stCanvas.isValid() || iColor < 0) return false;
+			Line(ix1,iy1,ix2,iy2,Pixel((Color_t) iColor));
+			return true;
+		}
+
+		bool DrawRectangle(int iX,int iY,int iWidth,int iHeight,int iColor,int iColor2 = -1) override
+		{
+			if (!m_stCanvas.isValid() || iWidth <= 0 || iHeight <= 0) return false;
+			if (iColor >= 0) FillRect(iX,iY,iX + iWidth,iY + iHeight,Pixel((Color_t) iColor));
+			if (iColor2 >= 0)
+			{
+				unsigned int uiPixel = Pixel((Color_t) iColor2);
+				int t = std::min(m_iPenThickness,std::min(iWidth,iHeight));
+				FillRect(iX,iY,iX + iWidth,iY + t,uiPixel);
+				FillRect(iX,iY + iHeight - t,iX + iWidth,iY + iHeight,uiPixel);
+				FillRect(iX,iY + t,iX + t,iY + iHeight - t,uiPixel);
+				FillRect(iX + iWidth - t,iY + t,iX + iWidth,iY + iHeight - t,uiPixel);
+			}
+			return true;
+		}
+
+		bool DrawCircle(int iX,int iY,int iRadius,int iColor,int iColor2 = -1) override
+		{
+			if (!m_stCanvas.isValid() || iRadius < 0) return false;
+			int iInner = iColor2 >= 0 ? iRadius - m_iPenThickness : iRadius;
+			unsigned int uiFill = Pixel((Color_t) iColor), uiOutline = Pixel((Color_t) iColor2);
+			int iFirst = std::max(-iRadius,-iY), iLast = std::min(iRadius,m_stCanvas.iHeight - 1 - iY);
+
+			for (int dy=iFirst;dy<=iLast;dy++)
+			{
+				int iOuterX = (int) sqrt((double) iRadius*iRadius - (double) dy*dy + 0.25);
+				int iInnerX = abs(dy) <= iInner ? (int) sqrt((double) iInner*iInner - (double) dy*dy + 0.25) : -1;
+				if (iColor >= 0 && iInnerX >= 0) FillSpan(iX - iInnerX,iX + iInnerX,iY + dy,uiFill);
+				if (iColor2 >= 0)
+				{
+					if (iInnerX < 0) FillSpan(iX - iOuterX,iX + iOuterX,iY + dy,uiOutline);
+					else
+					{
+						FillSpan(iX - iOuterX,iX - iInnerX - 1,iY + dy,uiOutline);
+						FillSpan(iX + iInnerX + 1,iX + iOuterX,iY + dy,uiOutline);
+					}
+				}
+			}
+			return true;
+		}
+
+		bool DrawPolygon(const Point_t * pPoints,int iVertices,int iColor,int iColor2 = -1) override
+		{
+			if (!m_stCanvas.isValid() || !pPoints || iVertices < 2) return false;
+			if (iColor >= 0 && iVertices >= 3)
+			{
+				m_vX.resize(iVertices);
+				m_vY.resize(iVertices);
+				for (int i=0;i<iVertices;i++) { m_vX[i] = pPoints[i].x + 0.5f; m_vY[i] = pPoints[i].y + 0.5f; }
+				FillPolygon(m_vX.data(),m_vY.data(),iVertices,Pixel((Color_t) iColor));
+			}
+			if (iColor2 >= 0)
+			{
+				unsigned int uiPixel = Pixel((Color_t) iColor2);
+				for (int i=0,j=iVertices-1;i<iVertices;j=i++) Line(pPoints[j].x,pPoints[j].y,pPoints[i].x,pPoints[i].y,uiPixel);
+			}
+			return true;
+		}
+
+		void Cls(int iColor1 = -1,int iColor2 = -1) override
+		{
+			if (!m_stCanvas.isValid()) return;
+			if (iColor1 >= 0) m_uiClsColor = Pixel((Color_t) iColor1);
+			if (iColor1 < 0 || iColor2 < 0) { FillRect(0,0,m_stCanvas.iWidth,m_stCanvas.iHeight,m_uiClsColor); return; }
+
+			// Gradient -- top to bottom
+
+			Color_t rgb1 = (Color_t) iColor1, rgb2 = (Color_t) iColor2;
+			int iLast = std::max(1,m_stCanvas.iHeight - 1);
+			for (int y=0;y<m_stCanvas.iHeight;y++)
+			{
+				auto fMix = [&](int i1,int i2) { return i1 + ((i2 - i1)*y + iLast/2)/iLast; };
+				FillSpan(0,m_stCanvas.iWidth - 1,y,Pixel(MakeRGB(fMix(GetRed(rgb1),GetRed(rgb2)),fMix(GetGreen(rgb1),GetGreen(rgb2)),fMix(GetBlue(rgb1),GetBlue(rgb2)))));
+			}
+		}
+
+		bool DisplayBitmap(int iX,int iY,const Bitmap_t & stBitmap) override
+		{
+			if (!m_stCanvas.isValid() || !stBitmap.isValid()) return false;
+			int iSourceX, iSourceY, iWidth = stBitmap.iWidth, iHeight = stBitmap.iHeight;
+			if (!Clip(iX,iY,iSourceX,iSourceY,iWidth,iHeight)) return true;
+			for (int y=0;y<iHeight;y++)
+			{
+				const unsigned char * sSource = stBitmap.Row(iSourceY + y) + iSourceX*3;
+				unsigned int * pDest = m_stCanvas.Row(iY + y) + iX;
+				for (int x=0;x<iWidth;x++,sSource+=3) pDest[x] = 0xFF000000 | (sSource[2] << 16) | (sSource[1] << 8) | sSource[0];
+			}
+			return true;
+		}
+
+		bool DisplayBitmap(int iX,int iY,const Bitmap32_t & stBitmap) override
+		{
+			if (!m_stCanvas.isValid() || !stBitmap.isValid()) return false;
+			int iSourceX, iSourceY, iWidth = stBitmap.iWidth, iHeight = stBitmap.iHeight;
+			if (!Clip(iX,iY,iSourceX,iSourceY,iWidth,iHeight)) return true;
+			for (int y=0;y<iHeight;y++) memcpy(m_stCanvas.Row(iY + y) + iX,stBitmap.Row(iSourceY + y) + iSourceX,(size_t) iWidth*4);
+			return true;
+		}
+
+		bool BlendBitmap(int iX,int iY,const Bitmap32_t & stBitmap) override
+		{
+			if (!m_stCanvas.isValid() || !stBitmap.isValid()) return false;
+			int iSourceX, iSourceY, iWidth = stBitmap.iWidth, iHeight = stBitmap.iHeight;
+			if (!Clip(iX,iY,iSourceX,iSourceY,iWidth,iHeight)) return true;
+			for (int y=0;y<iHeight;y++)
+			{
+				const unsigned int * pSource = stBitmap.Row(iSourceY + y) + iSourceX;
+				unsigned int * pDest = m_stCanvas.Row(iY + y) + iX;
+				for (int x=0;x<iWidth;x++)
+				{
+					unsigned int uiSource = pSource[x], uiAlpha = uiSource >> 24;
+					if (uiAlpha == 255) { pDest[x] = uiSource; continue; }
+					if (!uiAlpha) continue;
+
+					// Red and blue, then green, blended at once with x/255 as (x + 1 + (x >> 8)) >> 8
+
+					unsigned int uiDest = pDest[x], uiInverse = 255 - uiAlpha;
+					unsigned int uiRB = (uiSource & 0xFF00FF)*uiAlpha + (uiDest & 0xFF00FF)*uiInverse + 0x800080;
+					unsigned int uiG  = ((uiSource >> 8) & 0xFF)*uiAlpha + ((uiDest >> 8) & 0xFF)*uiInverse + 0x80;
+					uiRB = ((uiRB + ((uiRB >> 8) & 0xFF00FF)) >> 8) & 0xFF00FF;
+					uiG	 = ((uiG + (uiG >> 8)) >> 8) & 0xFF;
+					pDest[x] = 0xFF000000 | uiRB | (uiG << 8);
+				}
+			}
+			return true;
+		}
+	};
+
+}; // namespace Core
+}; // namespace Sage
+#endif // _CSoftRender_H_
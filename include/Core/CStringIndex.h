@@ -0,0 +1,162 @@
+//#pragma once
+#if !defined(_CStringIndex_H_)
+#define _CStringIndex_H_
+
+// -----------------------------------------------------------
+// CStringIndex.H -- Hashed name lookup, with prefix searches
+// -----------------------------------------------------------
+//
+// CStringIndex indexes a fixed table of names (i.e. the key names in a PGR file) so that, once built,
+//
+//		Find()			-- finds a name in O(1), through an open-addressing hash table, and
+//		FindPrefix()	-- finds the first name starting with a prefix in O(log n), through a sorted array of the names.
+//
+// Both return the same index a linear walk through the table would: the lowest index that matches.
+//
+// The names are not copied -- the index keeps pointers to them, so the table of names must stay valid (and unchanged)
+// for as long as the index is used.
+//
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+namespace Sage
+{
+namespace Core
+{
+	class CStringIndex
+	{
+		struct Slot_t
+		{
+			unsigned int uiHash;
+			int iIndex;					// -1 = empty
+		};
+
+		std::vector<const char *> m_vNames;
+		std::vector<Slot_t> m_vSlots;				// Power-of-two size, at most half full
+		std::vector<int> m_vSorted;					// Name indexes, sorted by name (then index)
+		std::vector<int> m_vLowest;					// Sparse table: lowest index in each power-of-two run of m_vSorted, per level
+		unsigned int m_uiMask = 0;
+
+		// Lowest() -- Lowest name index in m_vSorted[iStart,iEnd)
+
+		int Lowest(int iStart,int iEnd) const
+		{
+			int iLevel = 0;
+			while ((2 << iLevel) <= iEnd - iStart) iLevel++;
+			const int * iRow = m_vLowest.data() + (size_t) iLevel*m_vSorted.size();
+			return std::min(iRow[iStart],iRow[iEnd - (1 << iLevel)]);
+		}
+
+	public:
+
+		// Hash() -- FNV-1a hash of a name
+
+		static unsigned int Hash(const char * sName)
+		{
+			unsigned int uiHash = 2166136261u;
+			while (*sName) uiHash = (uiHash ^ (unsigned char) *sName++)*16777619u;
+			return uiHash;
+		}
+
+		// Build() -- Index iCount names, where fGetName(i) returns name i.  nullptr names are left out.
+
+		template <class _t>
+		void Build(int iCount,_t fGetName)
+		{
+			Clear();
+			if (iCount <= 0) return;
+
+			m_vNames.resize(iCount);
+			for (int i=0;i<iCount;i++) m_vNames[i] = fGetName(i);
+
+			// Hash table -- the first of any duplicate names is kept, as a linear search would find it
+
+			unsigned int uiSize = 4;
+			while (uiSize < (unsigned int) iCount*2) uiSize <<= 1;
+			m_uiMask = uiSize - 1;
+			m_vSlots.assign(uiSize,{ 0, -1 });
+
+			for (int i=0;i<iCount;i++)
+			{
+				if (!m_vNames[i]) continue;
+				unsigned int uiHash = Hash(m_vNames[i]);
+				unsigned int uiSlot = uiHash & m_uiMask;
+				bool bDuplicate = false;
+				while (m_vSlots[uiSlot].iIndex >= 0)
+				{
+					if (m_vSlots[uiSlot].uiHash == uiHash && !strcmp(m_vNames[m_vSlots[uiSlot].iIndex],m_vNames[i])) { bDuplicate = true; break; }
+					uiSlot = (uiSlot + 1) & m_uiMask;
+				}
+				if (!bDuplicate) m_vSlots[uiSlot] = { uiHash, i };
+			}
+
+			// Sorted names for prefix searches, with a sparse table of the lowest index over each run
+
+			for (int i=0;i<iCount;i++) if (m_vNames[i]) m_vSorted.push_back(i);
+			std::sort(m_vSorted.begin(),m_vSorted.end(),[&](int i1,int i2)
+			{
+				int iCompare = strcmp(m_vNames[i1],m_vNames[i2]);
+				return iCompare < 0 || (!iCompare && i1 < i2);
+			});
+
+			size_t iSorted = m_vSorted.size();
+			int iLevels = 1;
+			while (((size_t) 1 << iLevels) <= iSorted) iLevels++;
+			m_vLowest.resize((size_t) iLevels*iSorted);
+			std::copy(m_vSorted.begin(),m_vSorted.end(),m_vLowest.begin());
+			for (int iLevel=1;iLevel<iLevels;iLevel++)
+			{
+				const int * iLast	= m_vLowest.data() + (size_t) (iLevel-1)*iSorted;
+				int * iRow			= m_vLowest.data() + (size_t) iLevel*iSorted;
+				size_t iHalf		= (size_t) 1 << (iLevel-1);
+				for (size_t i=0;i + 2*iHalf <= iSorted;i++) iRow[i] = std::min(iLast[i],iLast[i + iHalf]);
+			}
+		}
+
+		void Clear()
+		{
+			m_vNames.clear();
+			m_vSlots.clear();
+			m_vSorted.clear();
+			m_vLowest.clear();
+			m_uiMask = 0;
+		}
+
+		int GetCount() const { return (int) m_vNames.size(); }
+
+		// Find() -- Index of sName, or -1 if it isn't in the table
+
+		int Find(const char * sName) const
+		{
+			if (!sName || m_vSlots.empty()) return -1;
+			unsigned int uiHash = Hash(sName);
+			for (unsigned int uiSlot = uiHash & m_uiMask;m_vSlots[uiSlot].iIndex >= 0;uiSlot = (uiSlot + 1) & m_uiMask)
+			{
+				const Slot_t & stSlot = m_vSlots[uiSlot];
+				if (stSlot.uiHash == uiHash && !strcmp(m_vNames[stSlot.iIndex],sName)) return stSlot.iIndex;
+			}
+			return -1;
+		}
+
+		// FindPrefix() -- Lowest index of a name starting with sPrefix, or -1 if there are none
+
+		int FindPrefix(const char * sPrefix) const
+		{
+			if (!sPrefix || m_vSorted.empty()) return -1;
+			size_t iLength = strlen(sPrefix);
+
+			// Names starting with sPrefix are a single run in the sorted array
+
+			auto itStart = std::lower_bound(m_vSorted.begin(),m_vSorted.end(),sPrefix,
+											[&](int i,const char * s) { return strcmp(m_vNames[i],s) < 0; });
+			auto itEnd = std::upper_bound(itStart,m_vSorted.end(),sPrefix,
+											[&](const char * s,int i) { return strncmp(s,m_vNames[i],iLength) < 0; });
+			if (itStart == itEnd) return -1;
+			return Lowest((int) (itStart - m_vSorted.begin()),(int) (itEnd - m_vSorted.begin()));
+		}
+	};
+
+}; // namespace Core
+}; // namespace Sage
+#endif // _CStringIndex_H_
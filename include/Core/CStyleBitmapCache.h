@@ -0,0 +1,187 @@
+//#pragma once
+#if !defined(_CStyleBitmapCache_H_)
+#define _CStyleBitmapCache_H_
+
+// -------------------------------------------------------------------------
+// CStyleBitmapCache.H -- One shared bitmap per (style, colors, size, state)
+// -------------------------------------------------------------------------
+//
+// Buttons created with the same style, color style and size end up with identical state bitmaps.  CStyleBitmapCache interns
+// them: the first Get() for a key builds the bitmap, and every later Get() for the same key returns the same bitmap, shared
+// through a reference count, so a grid of 1,000 identical buttons holds one set of bitmaps instead of 1,000.
+//
+// The bitmaps are immutable once built (SharedBitmap_t points to a const Bitmap_t).  A button that needs to change its bitmap must
+// make its own copy.
+//
+// Bitmaps stay in the cache while anything holds them.  Trim() frees the ones only the cache holds (i.e. after the buttons
+// using a style are deleted).
+//
+// Hits and misses are counted (see GetStats()) so the sharing can be checked, i.e. in a debug overlay.
+//
+// Example:
+//
+//		StyleBitmapKey_t stKey = { "Panel", "Blue", 120, 32, StyleBitmapState::High };
+//		SharedBitmap_t spBitmap = GetStyleBitmapCache().Get(stKey,[&](Bitmap_t & stBitmap) { return BuildHighBitmap(stBitmap,120,32); });
+//
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "SageCore.h"
+#include "CStringIndex.h"
+
+namespace Sage
+{
+namespace Core
+{
+	// StyleBitmapState -- The button state bitmaps (as in Sage::stButtonBitmaps_t), plus the background
+
+	enum class StyleBitmapState
+	{
+		Normal,
+		High,
+		Pressed,
+		Disabled,
+		CheckedHigh,
+		DisabledChecked,
+		Background,
+	};
+
+	struct StyleBitmapKey_t
+	{
+		std::string sStyle;
+		std::string sColorStyle;
+		int iWidth;
+		int iHeight;
+		StyleBitmapState eState;
+
+		bool operator == (const StyleBitmapKey_t & stKey) const
+		{
+			return iWidth == stKey.iWidth && iHeight == stKey.iHeight && eState == stKey.eState && sStyle == stKey.sStyle && sColorStyle == stKey.sColorStyle;
+		}
+	};
+
+	struct StyleBitmapStats_t
+	{
+		long long iHits;				// Get() calls that returned a bitmap already in the cache
+		long long iMisses;				// Get() calls that built the bitmap
+		long long iBytesShared;			// Bitmap memory not allocated, thanks to the hits
+		int iBitmaps;					// Bitmaps in the cache now
+	};
+
+	// SharedBitmap_t -- A reference-counted, immutable bitmap.  The memory is freed with the last reference.
+
+	typedef std::shared_ptr<const Bitmap_t> SharedBitmap_t;
+
+	class CStyleBitmapCache
+	{
+	private:
+		struct KeyHash_t
+		{
+			size_t operator () (const StyleBitmapKey_t & stKey) const
+			{
+				unsigned int uiHash = CStringIndex::Hash(stKey.sStyle.c_str())*31u ^ CStringIndex::Hash(stKey.sColorStyle.c_str());
+				return (size_t) (((uiHash*31u + (unsigned int) stKey.iWidth)*31u + (unsigned int) stKey.iHeight)*31u + (unsigned int) stKey.eState);
+			}
+		};
+
+		std::unordered_map<StyleBitmapKey_t,SharedBitmap_t,KeyHash_t> m_mapBitmaps;
+		std::mutex m_mutex;
+		std::atomic<long long> m_iHits			{ 0 };
+		std::atomic<long long> m_iMisses		{ 0 };
+		std::atomic<long long> m_iBytesShared	{ 0 };
+
+		static size_t BitmapBytes(const Bitmap_t & stBitmap)
+		{
+			return (size_t) stBitmap.iWidthBytes*stBitmap.iHeight + (stBitmap.sMask ? (size_t) stBitmap.iWidth*stBitmap.iHeight : 0);
+		}
+
+	public:
+
+		// Get() -- The bitmap for stKey, built with fBuild(Bitmap_t &) -> bool if it isn't in the cache yet.
+		// fBuild must allocate the bitmap with CreateBitmap().  Returns an empty SharedBitmap_t if fBuild fails.
+		//
+		// fBuild runs without the cache locked, so it can be slow (or use the cache itself).  If two threads build the same
+		// key at once, the first one stored is kept and returned to both.
+		//
+		template <class _t>
+		SharedBitmap_t Get(const StyleBitmapKey_t & stKey,_t fBuild)
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				auto itBitmap = m_mapBitmaps.find(stKey);
+				if (itBitmap != m_mapBitmaps.end())
+				{
+					m_iHits.fetch_add(1,std::memory_order_relaxed);
+					m_iBytesShared.fetch_add((long long) BitmapBytes(*itBitmap->second),std::memory_order_relaxed);
+					return itBitmap->second;
+				}
+			}
+
+			m_iMisses.fetch_add(1,std::memory_order_relaxed);
+			Bitmap_t stBitmap = {};
+			if (!fBuild(stBitmap) || !stBitmap.isValid())
+			{
+				DeleteBitmap(stBitmap);
+				return SharedBitmap_t();
+			}
+			SharedBitmap_t spBitmap(new Bitmap_t(stBitmap),[](const Bitmap_t * stShared)
+			{
+				Bitmap_t stDelete = *stShared;
+				DeleteBitmap(stDelete);
+				delete stShared;
+			});
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			return m_mapBitmaps.emplace(stKey,std::move(spBitmap)).first->second;
+		}
+
+		// Find() -- The bitmap for stKey if it is in the cache (not counted as a hit or a miss)
+
+		SharedBitmap_t Find(const StyleBitmapKey_t & stKey)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			auto itBitmap = m_mapBitmaps.find(stKey);
+			return itBitmap != m_mapBitmaps.end() ? itBitmap->second : SharedBitmap_t();
+		}
+
+		// Trim() -- Free the bitmaps nothing outside the cache holds.  Returns the number freed.
+
+		int Trim()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			int iFreed = 0;
+			for (auto itBitmap = m_mapBitmaps.begin();itBitmap != m_mapBitmaps.end();)
+			{
+				if (itBitmap->second.use_count() == 1) { itBitmap = m_mapBitmaps.erase(itBitmap); iFreed++; }
+				else ++itBitmap;
+			}
+			return iFreed;
+		}
+
+		// Clear() -- Remove every bitmap from the cache.  Bitmaps still held elsewhere stay valid until released.
+
+		void Clear()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_mapBitmaps.clear();
+		}
+
+		StyleBitmapStats_t GetStats()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			return { m_iHits.load(std::memory_order_relaxed), m_iMisses.load(std::memory_order_relaxed),
+					 m_iBytesShared.load(std::memory_order_relaxed), (int) m_mapBitmaps.size() };
+		}
+
+		void ResetStats() { m_iHits = 0; m_iMisses = 0; m_iBytesShared = 0; }
+	};
+
+	// GetStyleBitmapCache() -- The shared cache used for control styles
+
+	inline CStyleBitmapCache & GetStyleBitmapCache() { static CStyleBitmapCache cCache; return cCache; }
+
+}; // namespace Core
+}; // namespace Sage
+#endif // _CStyleBitmapCache_H_
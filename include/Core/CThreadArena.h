@@ -0,0 +1,92 @@
+//#pragma once
+#if !defined(_CThreadArena_H_)
+#define _CThreadArena_H_
+
+// -----------------------------------------------------------------
+// CThreadArena.H -- Per-thread bump allocator for temporary objects
+// -----------------------------------------------------------------
+//
+// CThreadArena hands out temporary objects (i.e. the cwfOpt objects behind opt::fgColor(), Transparent(), etc.) from a
+// per-thread arena.  Each call to Next() returns the next object in the calling thread's arena -- there are no locks, and
+// objects handed to one thread are never handed to another.
+//
+// The arena is a bump allocator: Next() moves forward through the objects, growing the arena one block at a time, and
+// Release() moves it back to a mark.  Scope does this automatically, so everything allocated within a scope is reused once
+// the scope ends:
+//
+//		for (int i=0;i<iButtons;i++)
+//		{
+//			CThreadArena<cwfOpt>::Scope cScope;			// (cwfOpt::TempScope)
+//			cWin.NewButton(x,y,sName,fgColor("red") | Style("Panel"));
+//		}
+//
+// Without a Scope, the arena wraps back to the start after iMaxObjects objects (so a thread that never uses Scope keeps a fixed
+// amount of memory).  Only the calling thread's own objects are reused, and only after iMaxObjects others.
+//
+// Objects are constructed once, when their block is allocated, and destroyed when the thread exits.  Next() does not reset them;
+// the caller does.
+//
+// So an object from Next() must not be used on another thread: it is reused by its own thread, and freed when that thread exits
+// even if another thread still has it.  Copy it into an object the other thread owns instead (i.e. cwfOpt cOpt = fgColor("red")
+// on the building thread, then cOpt is passed on).
+//
+#include <memory>
+#include <vector>
+
+namespace Sage
+{
+namespace Core
+{
+	template <class _t,int iBlockSize = 256,int iMaxObjects = 5000>
+	class CThreadArena
+	{
+	private:
+		static_assert(iBlockSize > 0 && iMaxObjects > 0,"CThreadArena sizes must be positive");
+
+		struct Arena_t
+		{
+			std::vector<std::unique_ptr<_t[]>> vBlocks;
+			int iNext = 0;
+		};
+
+		static Arena_t & GetArena() { thread_local Arena_t stArena; return stArena; }
+
+	public:
+
+		// Next() -- The next object in the calling thread's arena
+		//
+		static _t * Next()
+		{
+			Arena_t & stArena = GetArena();
+			if (stArena.iNext >= iMaxObjects) stArena.iNext = 0;
+			int iBlock = stArena.iNext/iBlockSize;
+			if (iBlock >= (int) stArena.vBlocks.size()) stArena.vBlocks.emplace_back(new _t[iBlockSize]);
+			return &stArena.vBlocks[iBlock][stArena.iNext++ % iBlockSize];
+		}
+
+		// GetMark(), Release() -- Save the arena position, and go back to it (objects handed out after the mark are reused)
+		//
+		static int GetMark() { return GetArena().iNext; }
+		static void Release(int iMark) { Arena_t & stArena = GetArena(); if (iMark >= 0 && iMark < stArena.iNext) stArena.iNext = iMark; }
+
+		// GetCount() -- Objects allocated (constructed) by the calling thread so far
+		//
+		static int GetCount() { return (int) GetArena().vBlocks.size()*iBlockSize; }
+
+		// Scope -- Releases the objects handed out while it exists, when it goes out of scope
+		//
+		class Scope
+		{
+		private:
+			int m_iMark;
+		public:
+			Scope() : m_iMark(GetMark()) {}
+			~Scope() { Release(m_iMark); }
+			Scope(const Scope &) = delete;
+			Scope & operator = (const Scope &) = delete;
+		};
+	};
+
+}; // namespace Core
+}; // namespace Sage
+#endif // _CThreadArena_H_
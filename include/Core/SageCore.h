@@ -0,0 +1,127 @@
+//#pragma once
+#if !defined(_SageCore_H_)
+#define _SageCore_H_
+
+// ---------------------------------------------------
+// SageCore.H -- Portable types for SageBox core code
+// ---------------------------------------------------
+//
+// Everything under include/Core is self-contained and does not include <Windows.h>, so it compiles with MSVC, GCC and Clang
+// on Windows or Linux.  This allows the pixel kernels and other hot paths to be built, profiled and checked on
+// any system, separate from the Windows-bound parts of SageBox.
+//
+// The types here are layout-compatible with their Windows counterparts:
+//
+//		Core::Point_t	-- POINT
+//		Core::Size_t	-- SIZE
+//		Core::Rect_t	-- RECT (right and bottom are exclusive)
+//		Core::RGB24_t	-- Sage::RGBColor24
+//		Core::Color_t	-- DWORD/COLORREF, as made by RGB()
+//		Core::Bitmap_t	-- the memory fields of Sage::RawBitmap_t
+//
+// See SageKernels.h for the bridge from RawBitmap_t, POINT, SIZE, etc. to the Core types.
+//
+#include <stdlib.h>
+#include <string.h>
+
+namespace Sage
+{
+namespace Core
+{
+	struct Point_t
+	{
+		int x;
+		int y;
+	};
+
+	struct Size_t
+	{
+		int cx;
+		int cy;
+	};
+
+	struct Rect_t
+	{
+		int left;
+		int top;
+		int right;
+		int bottom;
+	};
+
+	struct RGB24_t
+	{
+		unsigned char Blue;
+		unsigned char Green;
+		unsigned char Red;
+	};
+
+	// Color_t -- a 0x00BBGGRR value, the same as a Windows COLORREF made with RGB()
+
+	typedef unsigned int Color_t;
+
+	static constexpr Color_t MakeRGB(int iRed,int iGreen,int iBlue) { return (Color_t) ((iRed & 0xFF) | ((iGreen & 0xFF) << 8) | ((iBlue & 0xFF) << 16)); }
+	static constexpr int GetRed(Color_t rgbColor)		{ return (int) (rgbColor & 0xFF);			}
+	static constexpr int GetGreen(Color_t rgbColor)		{ return (int) ((rgbColor >> 8) & 0xFF);	}
+	static constexpr int GetBlue(Color_t rgbColor)		{ return (int) ((rgbColor >> 16) & 0xFF);	}
+
+	// WidthBytes24() -- Row size in bytes for a 24-bit bitmap, padded to a 4-byte boundary as with Windows DIBs
+
+	static constexpr int WidthBytes24(int iWidth) { return (iWidth*3 + 3) & ~3; }
+
+	// --------------------------------------
+	// Bitmap_t -- 24-bit bitmap memory view
+	// --------------------------------------
+	//
+	// This mirrors the memory portion of Sage::RawBitmap_t.  Rows are addressed in memory order (row 0 is the first row in stMem).
+	// Bitmap_t does not own its memory -- use CreateBitmap()/DeleteBitmap() below, or wrap memory owned by a RawBitmap_t.
+	//
+	// sMask is an optional 8-bit mask plane with iWidth bytes per row, used by the 8-bit mask kernels.
+	//
+	struct Bitmap_t
+	{
+		int iWidth;
+		int iHeight;
+		int iWidthBytes;
+		unsigned char * stMem;
+		unsigned char * sMask;
+
+		bool isValid() const { return stMem && iWidth > 0 && iHeight > 0 && iWidthBytes >= iWidth*3; }
+		unsigned char * Row(int iY) const { return stMem + (size_t) iY*iWidthBytes; }
+		unsigned char * MaskRow(int iY) const { return sMask + (size_t) iY*iWidth; }
+		Size_t GetSize() const { return { iWidth, iHeight }; }
+	};
+
+	// CreateBitmap() -- Allocate a 24-bit bitmap.  The memory is not cleared.
+	// Returns an empty Bitmap_t (isValid() == false) on failure.
+	//
+	inline Bitmap_t CreateBitmap(int iWidth,int iHeight,bool bWithMask = false)
+	{
+		Bitmap_t stBitmap = {};
+		if (iWidth <= 0 || iHeight <= 0) return stBitmap;
+
+		int iWidthBytes = WidthBytes24(iWidth);
+		stBitmap.stMem = (unsigned char *) malloc((size_t) iWidthBytes*iHeight);
+		if (!stBitmap.stMem) return stBitmap;
+		if (bWithMask)
+		{
+			stBitmap.sMask = (unsigned char *) malloc((size_t) iWidth*iHeight);
+			if (!stBitmap.sMask) { free(stBitmap.stMem); stBitmap.stMem = nullptr; return stBitmap; }
+		}
+		stBitmap.iWidth			= iWidth;
+		stBitmap.iHeight		= iHeight;
+		stBitmap.iWidthBytes	= iWidthBytes;
+		return stBitmap;
+	}
+
+	// DeleteBitmap() -- Free memory allocated with CreateBitmap() and clear the structure
+
+	inline void DeleteBitmap(Bitmap_t & stBitmap)
+	{
+		if (stBitmap.stMem) free(stBitmap.stMem);
+		if (stBitmap.sMask) free(stBitmap.sMask);
+		stBitmap = {};
+	}
+
+}; // namespace Core
+}; // namespace Sage
+#endif // _SageCore_H_
@@ -0,0 +1,53 @@
+//#pragma once
+#if !defined(_SageColorTable_H_)
+#define _SageColorTable_H_
+
+// ----------------------------------------------------------------------
+// SageColorTable.H -- Resolve Core::CColorTable names with CWindow colors
+// ----------------------------------------------------------------------
+//
+// Core::CColorTable (see Core/CColorTable.h) only has the few stock colors whose values are confirmed against the library, and
+// the user colors made with its MakeColor().  SetColorResolver() passes every other name to CWindow::GetColor(), so the colors
+// COptParse and COptConst resolve are the library's own (including colors made with CWindow::MakeColor()):
+//
+//		CWindow & cWin = cSageBox.NewWindow(...);
+//		SetColorResolver(cWin);
+//
+// The resolver is removed when the window is destroyed.  Call ClearColorResolver() to remove it before then.
+//
+#include "CSageBox.h"
+#include "Core/CColorTable.h"
+
+namespace Sage
+{
+	namespace ColorTable_Internal
+	{
+		inline bool ResolveColor(const char * sName,Core::Color_t & rgbColor,void * pWin)
+		{
+			DWORD dwColor = 0;
+			if (!((CWindow *) pWin)->GetColor(sName,dwColor)) return false;
+			rgbColor = (Core::Color_t) dwColor;
+			return true;
+		}
+
+		inline void WindowDestroyed(void *) { Core::GetColorTable().SetResolver(nullptr); }
+	};
+
+	// SetColorResolver() -- Resolve names the color table doesn't know with cWin.GetColor(), until cWin is destroyed
+
+	inline void SetColorResolver(CWindow & cWin)
+	{
+		cWin.RemoveDeleter(&Core::GetColorTable());
+		cWin.AttachDeleter(&Core::GetColorTable(),ColorTable_Internal::WindowDestroyed);
+		Core::GetColorTable().SetResolver(ColorTable_Internal::ResolveColor,&cWin);
+	}
+
+	// ClearColorResolver() -- Stop resolving names with cWin (the window passed to SetColorResolver())
+
+	inline void ClearColorResolver(CWindow & cWin)
+	{
+		cWin.RemoveDeleter(&Core::GetColorTable());
+		Core::GetColorTable().SetResolver(nullptr);
+	}
+}; // namespace Sage
+#endif // _SageColorTable_H_
@@ -0,0 +1,397 @@
+//#pragma once
+#if !defined(_SageKernels_H_)
+#define _SageKernels_H_
+
+// -----------------------------------------------------------
+// SageKernels.H -- RawBitmap_t bridge to the Core pixel kernels
+// -----------------------------------------------------------
+//
+// The pixel kernels live in include/Core (see Core/CPixelKernels.h) and do not depend on <Windows.h>.
+// This file maps RawBitmap_t, POINT, SIZE, RGBColor_t and DWORD colors onto the Core types so the kernels can be
+// called with the usual SageBox types, i.e.
+//
+//		Core::ApplyMaskColor(rgbColor,stMask,{ 0,0 },stDest,{ 10,10 },stMask.GetSize());
+//
+// The Core types are layout-compatible with the Windows types, so no pixel data is converted or copied.
+//
+#include "Sage.h"
+#include "CRawBitmap.h"
+#include "Core/CPixelKernels.h"
+#include "Core/CFloatKernels.h"
+#include "Core/CBitmapPool.h"
+#include "Core/CResample.h"
+#include "Core/CJpegDecoder.h"
+#include "Core/CLazyBitmaps.h"
+#include "Core/CSoftRender.h"
+#include "CJpeg.h"
+
+namespace Sage
+{
+namespace Core
+{
+	static_assert(sizeof(RGB24_t) == sizeof(Sage::RGBColor24),"Core::RGB24_t must match Sage::RGBColor24");
+
+	// toCore() -- Convert SageBox/Windows types to Core types.  The returned Bitmap_t refers to the RawBitmap_t memory.
+
+	static inline Bitmap_t toCore(const Sage::RawBitmap_t & stBitmap)
+	{
+		return { stBitmap.iWidth, stBitmap.iHeight < 0 ? -stBitmap.iHeight : stBitmap.iHeight, stBitmap.iWidthBytes, stBitmap.stMem, stBitmap.sMask };
+	}
+	static inline Bitmap32_t toCore(const Sage::RawBitmap32_t & stBitmap)
+	{
+		return { stBitmap.iWidth, stBitmap.iHeight < 0 ? -stBitmap.iHeight : stBitmap.iHeight, stBitmap.iWidthBytes, stBitmap.stMem };
+	}
+	static inline FloatBitmap_t toCore(const Sage::FloatBitmap_t & fBitmap)
+	{
+		return { fBitmap.iWidth, fBitmap.iHeight, fBitmap.fRed, fBitmap.fGreen, fBitmap.fBlue };
+	}
+	static inline Point_t toCore(const POINT & pPoint)				{ return { (int) pPoint.x, (int) pPoint.y };	}
+	static inline Size_t toCore(const SIZE & szSize)				{ return { (int) szSize.cx, (int) szSize.cy };	}
+	static inline Color_t toCore(const Sage::RGBColor_t & rgbColor)	{ return MakeRGB(rgbColor.iRed,rgbColor.iGreen,rgbColor.iBlue); }
+
+	// ----------------------------------------------------------
+	// RawBitmap_t versions of the kernels in Core/CPixelKernels.h
+	// ----------------------------------------------------------
+
+	// iThreads = 0 splits large bitmaps into tiles across every thread in the Core thread pool (see Core/CParallel.h)
+
+	inline bool CopyBitmap(Sage::RawBitmap_t & stSource,POINT pSourceStart,Sage::RawBitmap_t & stDest,POINT pDestStart,const SIZE & szSize,int iThreads = 1)
+	{
+		Bitmap_t stCoreDest = toCore(stDest);
+		return CopyBitmap(toCore(stSource),toCore(pSourceStart),stCoreDest,toCore(pDestStart),toCore(szSize),iThreads);
+	}
+	inline bool CopyBitmap(Sage::RawBitmap_t & stSource,Sage::RawBitmap_t & stDest,int iThreads = 1)
+	{
+		Bitmap_t stCoreDest = toCore(stDest);
+		return CopyBitmap(toCore(stSource),stCoreDest,iThreads);
+	}
+	inline bool FillBitmap(Sage::RawBitmap_t & stDest,DWORD dwColor,POINT pStart = { 0,0 },SIZE szSize = { 0,0 },int iThreads = 1)
+	{
+		Bitmap_t stCoreDest = toCore(stDest);
+		return FillBitmap(stCoreDest,(Color_t) dwColor,toCore(pStart),toCore(szSize),iThreads);
+	}
+	inline bool FillBitmap(Sage::RawBitmap_t & stDest,Sage::RGBColor_t rgbColor,POINT pStart = { 0,0 },SIZE szSize = { 0,0 },int iThreads = 1)
+	{
+		return FillBitmap(stDest,(DWORD) toCore(rgbColor),pStart,szSize,iThreads);
+	}
+	inline bool ApplyMaskColor(Sage::RGBColor_t rgbColor,Sage::RawBitmap_t & stMask,POINT pMaskStart,Sage::RawBitmap_t & stDest,POINT pDestStart,const SIZE & szSize,int iThreads = 1)
+	{
+		Bitmap_t stCoreDest = toCore(stDest);
+		return ApplyMaskColor(toCore(rgbColor),toCore(stMask),toCore(pMaskStart),stCoreDest,toCore(pDestStart),toCore(szSize),false,iThreads);
+	}
+	inline bool ApplyMaskColorR(Sage::RGBColor_t rgbColor,Sage::RawBitmap_t & stMask,POINT pMaskStart,Sage::RawBitmap_t & stDest,POINT pDestStart,const SIZE & szSize,int iThreads = 1)
+	{
+		Bitmap_t stCoreDest = toCore(stDest);
+		return ApplyMaskColor(toCore(rgbColor),toCore(stMask),toCore(pMaskStart),stCoreDest,toCore(pDestStart),toCore(szSize),true,iThreads);
+	}
+	inline bool ApplyMaskGraphic(Sage::RawBitmap_t & stSource,Sage::RawBitmap_t & stBackground,Sage::RawBitmap_t & stDest,Sage::RawBitmap_t & stMask,int iThreads = 1)
+	{
+		Bitmap_t stCoreDest = toCore(stDest);
+		return ApplyMaskGraphic(toCore(stSource),toCore(stMask),toCore(stBackground),stCoreDest,iThreads);
+	}
+	inline bool ApplyMaskGraphic(Sage::RawBitmap_t & stSource,POINT pSourceStart,Sage::RawBitmap_t & stDest,POINT pDestStart,const SIZE & szSize,int iThreads = 1)
+	{
+		Bitmap_t stCoreDest = toCore(stDest);
+		return ApplyMaskGraphic(toCore(stSource),toCore(pSourceStart),stCoreDest,toCore(pDestStart),toCore(szSize),false,iThreads);
+	}
+	inline bool ApplyMaskGraphicR(Sage::RawBitmap_t & stSource,POINT pSourceStart,Sage::RawBitmap_t & stDest,POINT pDestStart,const SIZE & szSize,int iThreads = 1)
+	{
+		Bitmap_t stCoreDest = toCore(stDest);
+		return ApplyMaskGraphic(toCore(stSource),toCore(pSourceStart),stCoreDest,toCore(pDestStart),toCore(szSize),true,iThreads);
+	}
+	inline bool ReverseBitmap(Sage::RawBitmap_t & stBitmap,int iThreads = 1)
+	{
+		Bitmap_t stCore = toCore(stBitmap);
+		return ReverseBitmap(stCore,iThreads);
+	}
+	inline bool MasktoBmp(Sage::RawBitmap_t & stSource,Sage::RawBitmap_t & stDest,int iThreads = 1)
+	{
+		Bitmap_t stCoreDest = toCore(stDest);
+		return MasktoBmp(toCore(stSource),stCoreDest,iThreads);
+	}
+
+	// ConverttoBitmap() -- Convert a FloatBitmap_t into an existing RawBitmap_t of the same size, reusing its memory.
+	// iThreads = 0 splits large images across every thread in the Core thread pool.
+	//
+	inline bool ConverttoBitmap(Sage::FloatBitmap_t & fSource,Sage::RawBitmap_t & stDest,int iThreads = 1)
+	{
+		Bitmap_t stCoreDest = toCore(stDest);
+		return ConverttoBitmap(toCore(fSource),stCoreDest,iThreads);
+	}
+
+	// ConverttoFloat() -- Convert a RawBitmap_t into an existing FloatBitmap_t of the same size, reusing its memory.
+	// iThreads = 0 splits large images across every thread in the Core thread pool.
+	//
+	inline bool ConverttoFloat(Sage::RawBitmap_t & stSource,Sage::FloatBitmap_t & fDest,int iThreads = 1)
+	{
+		FloatBitmap_t fCoreDest = toCore(fDest);
+		return ConverttoFloat(toCore(stSource),fCoreDest,iThreads);
+	}
+
+	// GetThumbSize() -- Output size of a thumbnail of a szSource bitmap, the same as QuickThumbnail() uses:
+	//
+	//		BestFit			-- Largest size that fits in iWidth x iHeight, keeping the aspect ratio.  Never enlarged.
+	//		BestExactFit	-- Largest size that fits in iWidth x iHeight, keeping the aspect ratio.  Enlarged if smaller.
+	//		ExactWidth		-- iWidth wide, height kept in proportion (iHeight is ignored)
+	//		ExactHeight		-- iHeight high, width kept in proportion (iWidth is ignored)
+	//		Percentage		-- iWidth percent of the original size (iHeight is ignored)
+	//		MaxWidth		-- Reduced to iWidth wide if wider, otherwise unchanged (iHeight is ignored)
+	//		MaxHeight		-- Reduced to iHeight high if higher, otherwise unchanged (iWidth is ignored)
+	//
+	// Returns { 0,0 } for an empty source or invalid size.
+	//
+	inline SIZE GetThumbSize(SIZE szSource,int iWidth,int iHeight,Sage::ThumbType eType)
+	{
+		if (szSource.cx <= 0 || szSource.cy <= 0) return { 0,0 };
+
+		double fScale = 0;
+		switch (eType)
+		{
+			case Sage::ThumbType::BestFit:
+			case Sage::ThumbType::BestExactFit:
+			{
+				if (iWidth <= 0 || iHeight <= 0) return { 0,0 };
+				double fWidthScale	= (double) iWidth/szSource.cx;
+				double fHeightScale	= (double) iHeight/szSource.cy;
+				fScale = fWidthScale < fHeightScale ? fWidthScale : fHeightScale;
+				if (eType == Sage::ThumbType::BestFit && fScale > 1.0) fScale = 1.0;
+				break;
+			}
+			case Sage::ThumbType::ExactWidth:	fScale = (double) iWidth/szSource.cx;		break;
+			case Sage::ThumbType::ExactHeight:	fScale = (double) iHeight/szSource.cy;		break;
+			case Sage::ThumbType::Percentage:	fScale = iWidth/100.0;						break;
+			case Sage::ThumbType::MaxWidth:		fScale = iWidth < szSource.cx ? (double) iWidth/szSource.cx : 1.0;		break;
+			case Sage::ThumbType::MaxHeight:	fScale = iHeight < szSource.cy ? (double) iHeight/szSource.cy : 1.0;	break;
+			default:							break;
+		}
+		if (fScale <= 0) return { 0,0 };
+
+		// The exact sides are set directly so rounding can't make them a pixel off
+
+		LONG iOutWidth	= eType == Sage::ThumbType::ExactWidth  ? iWidth  : (LONG) (szSource.cx*fScale + 0.5);
+		LONG iOutHeight	= eType == Sage::ThumbType::ExactHeight ? iHeight : (LONG) (szSource.cy*fScale + 0.5);
+		return { iOutWidth < 1 ? 1 : iOutWidth, iOutHeight < 1 ? 1 : iOutHeight };
+	}
+
+	// ResizeBitmap() -- Scale stSource into stDest (any size), i.e. to make thumbnails without a window.  See Core/CResample.h.
+
+	inline bool ResizeBitmap(Sage::RawBitmap_t & stSource,Sage::RawBitmap_t & stDest,ResizeFilter eFilter = ResizeFilter::Lanczos3,int iThreads = 1)
+	{
+		Bitmap_t stCoreDest = toCore(stDest);
+		return ResizeBitmap(toCore(stSource),stCoreDest,eFilter,iThreads);
+	}
+
+	// ResizeBitmap() -- Scale stSource to a new bitmap sized by eType (see GetThumbSize()).
+	// The CSageBitmap is returned empty if the source is empty or the size is invalid.
+	//
+	[[nodiscard]] inline CSageBitmap ResizeBitmap(Sage::RawBitmap_t & stSource,Sage::ThumbType eType,int iWidth,int iHeight,
+												  ResizeFilter eFilter = ResizeFilter::Lanczos3,int iThreads = 1,bool * bSuccess = nullptr)
+	{
+		CSageBitmap cBitmap;
+		Bitmap_t stCoreSource = toCore(stSource);
+		SIZE szSize = GetThumbSize({ stCoreSource.iWidth, stCoreSource.iHeight },iWidth,iHeight,eType);
+
+		bool bResult = stCoreSource.isValid() && szSize.cx > 0 && cBitmap.CreateBitmap((int) szSize.cx,(int) szSize.cy) &&
+						ResizeBitmap(stSource,*cBitmap,eFilter,iThreads);
+		if (!bResult) cBitmap.Delete();
+		if (bSuccess) *bSuccess = bResult;
+		return cBitmap;
+	}
+
+	// CreatePooledBitmap() -- Create a RawBitmap_t from the bitmap pool (see Core/CBitmapPool.h) instead of calling Sage::CreateBitmap().
+	//
+	// The memory is 64-byte aligned, but rows keep the usual 4-byte DIB padding so the bitmap can still be displayed with the
+	// normal Windows functions.  Use Core::CreatePooledBitmap() with a Core::Bitmap_t for 64-byte rows.
+	//
+	// Important: release the bitmap with ReleasePooledBitmap() -- not stBitmap.Delete() or freeBitmap().
+	//
+	inline bool CreatePooledBitmap(Sage::RawBitmap_t & stBitmap,int iWidth,int iHeight,bool bWithMask = false)
+	{
+		stBitmap = {};
+		if (iWidth <= 0 || iHeight <= 0) return false;
+
+		int iWidthBytes = WidthBytes24(iWidth);
+		stBitmap.stMem = (unsigned char *) CBitmapPool::Alloc((size_t) iWidthBytes*iHeight);
+		if (!stBitmap.stMem) return false;
+		if (bWithMask)
+		{
+			stBitmap.sMask = (unsigned char *) CBitmapPool::Alloc((size_t) iWidth*iHeight);
+			if (!stBitmap.sMask) { CBitmapPool::Release(stBitmap.stMem); stBitmap = {}; return false; }
+		}
+		stBitmap.iWidth			= iWidth;
+		stBitmap.iHeight		= iHeight;
+		stBitmap.iWidthBytes	= iWidthBytes;
+		stBitmap.iTotalSize		= iWidthBytes*iHeight;
+		stBitmap.stRGB			= (Sage::RGBColor24 *) stBitmap.stMem;
+		return true;
+	}
+
+	// ReleasePooledBitmap() -- Return a bitmap from CreatePooledBitmap() to the pool and clear the structure
+
+	inline void ReleasePooledBitmap(Sage::RawBitmap_t & stBitmap)
+	{
+		CBitmapPool::Release(stBitmap.stMem);
+		CBitmapPool::Release(stBitmap.sMask);
+		stBitmap = {};
+	}
+
+	// --------------------------------------------------------------
+	// JPEG decoding with Core::CJpegDecoder (see Core/CJpegDecoder.h)
+	// --------------------------------------------------------------
+	//
+	// Unlike Sage::CJpeg, these don't share a busy lock, so any number of threads can decode at once.
+	// JPEG types CJpegDecoder doesn't handle (i.e. progressive JPEGs) are passed on to Sage::CJpeg, which still decodes one at a time.
+	//
+
+	// DecodeJpeg() -- Finish a decode started with ReadHeader()/ReadHeaderFile(), into a new CSageBitmap.  Returns the decode status.
+
+	inline JpegStatus DecodeJpeg(CJpegDecoder & cDecoder,JpegStatus eStatus,CSageBitmap & cBitmap)
+	{
+		cBitmap.Delete();
+		if (eStatus != JpegStatus::Ok) return eStatus;
+
+		if (!cBitmap.CreateBitmap(cDecoder.GetWidth(),cDecoder.GetHeight())) return JpegStatus::Error;
+		Bitmap_t stBitmap = toCore(*cBitmap);
+		eStatus = cDecoder.Decode(stBitmap);
+		if (eStatus != JpegStatus::Ok) cBitmap.Delete();
+		return eStatus;
+	}
+
+	// ScaleJpegFallback() -- For JPEGs decoded by Sage::CJpeg: reduce a full-size decode to 1/iScale size, as CJpegDecoder would
+
+	inline JpegStatus ScaleJpegFallback(Sage::CJpeg & cJpeg,CSageBitmap & cBitmap,int iScale)
+	{
+		if (cJpeg.GetStatus() != Sage::CJpeg::Status::Ok || !cBitmap.isValid()) { cBitmap.Delete(); return JpegStatus::Error; }
+		if (iScale <= 1) return JpegStatus::Ok;
+
+		CSageBitmap cScaled;
+		Bitmap_t stFull = toCore(*cBitmap);
+		if (!cScaled.CreateBitmap((stFull.iWidth + iScale - 1)/iScale,(stFull.iHeight + iScale - 1)/iScale) ||
+			!ResizeBitmap(*cBitmap,*cScaled,ResizeFilter::Box)) { cBitmap.Delete(); return JpegStatus::Error; }
+		cBitmap = std::move(cScaled);
+		return JpegStatus::Ok;
+	}
+
+	// ReadJpeg() -- Decode a JPEG in memory to a CSageBitmap, at 1/iScale size (1, 2, 4 or 8).  The CSageBitmap is empty on failure.
+	// A scaled decode is much faster than a full decode, as the size is reduced in the inverse DCT (see CJpegDecoder::SetScale()).
+	//
+	[[nodiscard]] inline CSageBitmap ReadJpeg(const unsigned char * sData,int iDataLength,int iScale,bool * bSuccess = nullptr)
+	{
+		CSageBitmap cBitmap;
+		CJpegDecoder & cDecoder = GetThreadJpegDecoder();
+		JpegStatus eStatus = cDecoder.ReadHeader(sData,iDataLength > 0 ? (size_t) iDataLength : 0);
+		if (eStatus == JpegStatus::Ok && !cDecoder.SetScale(iScale)) eStatus = JpegStatus::Error;
+		eStatus = DecodeJpeg(cDecoder,eStatus,cBitmap);
+
+		if (eStatus == JpegStatus::Unsupported)
+		{
+			Sage::CJpeg cJpeg;
+			cBitmap = cJpeg.ReadJpeg(sData,iDataLength);
+			eStatus = ScaleJpegFallback(cJpeg,cBitmap,iScale);
+		}
+		if (bSuccess) *bSuccess = eStatus == JpegStatus::Ok;
+		return cBitmap;
+	}
+	[[nodiscard]] inline CSageBitmap ReadJpeg(const unsigned char * sData,int iDataLength,bool * bSuccess = nullptr) { return ReadJpeg(sData,iDataLength,1,bSuccess); }
+
+	// ReadJpegFile() -- Decode a JPEG file to a CSageBitmap, at 1/iScale size (1, 2, 4 or 8).  The CSageBitmap is empty on failure.
+
+	[[nodiscard]] inline CSageBitmap ReadJpegFile(const char * sPath,int iScale,bool * bSuccess = nullptr)
+	{
+		CSageBitmap cBitmap;
+		CJpegDecoder & cDecoder = GetThreadJpegDecoder();
+		JpegStatus eStatus = cDecoder.ReadHeaderFile(sPath);
+		if (eStatus == JpegStatus::Ok && !cDecoder.SetScale(iScale)) eStatus = JpegStatus::Error;
+		eStatus = DecodeJpeg(cDecoder,eStatus,cBitmap);
+
+		if (eStatus == JpegStatus::Unsupported)
+		{
+			Sage::CJpeg cJpeg;
+			cBitmap = cJpeg.ReadJpegFile(sPath);
+			eStatus = ScaleJpegFallback(cJpeg,cBitmap,iScale);
+		}
+		if (bSuccess) *bSuccess = eStatus == JpegStatus::Ok;
+		return cBitmap;
+	}
+	[[nodiscard]] inline CSageBitmap ReadJpegFile(const char * sPath,bool * bSuccess = nullptr) { return ReadJpegFile(sPath,1,bSuccess); }
+
+	// DecodeJpegFallback() -- Decode a JPEG in memory with Sage::CJpeg, into a new Bitmap_t.  This is the JPEG fallback of
+	// CLazyBitmaps (see Core/CLazyBitmaps.h), set for every program that includes this file.
+
+	inline bool DecodeJpegFallback(Bitmap_t & stBitmap,const void * pSource,size_t iSize)
+	{
+		if (!pSource || !iSize || iSize > 0x7FFFFFFF) return false;
+		Sage::CJpeg cJpeg;
+		CSageBitmap cBitmap;
+		cBitmap = cJpeg.ReadJpeg((const unsigned char *) pSource,(int) iSize);
+		if (cJpeg.GetStatus() != Sage::CJpeg::Status::Ok || !cBitmap.isValid()) return false;
+
+		Bitmap_t stSource = toCore(*cBitmap);
+		stBitmap = CreateBitmap(stSource.iWidth,stSource.iHeight);
+		if (stBitmap.isValid() && CopyBitmap(stSource,stBitmap)) return true;
+		DeleteBitmap(stBitmap);
+		return false;
+	}
+
+	inline const bool kJpegFallbackSet = (SetJpegFallback(DecodeJpegFallback),true);
+
+	// ReadJpegThumbnail() -- Decode a JPEG file straight to a thumbnail sized by eType (see GetThumbSize()).
+	//
+	// The image is decoded at the smallest DCT scale (1/2, 1/4 or 1/8) that is still no smaller than the thumbnail, then resized
+	// to the exact size with eFilter.  For a 256x256 thumbnail of a 24MP photo, this decodes at 1/8 size -- 1/64th of the pixels.
+	//
+	[[nodiscard]] inline CSageBitmap ReadJpegThumbnail(const char * sPath,Sage::ThumbType eType,int iWidth,int iHeight,
+													   ResizeFilter eFilter = ResizeFilter::Lanczos3,bool * bSuccess = nullptr)
+	{
+		CSageBitmap cThumb;
+		CJpegDecoder & cDecoder = GetThreadJpegDecoder();
+		JpegStatus eStatus = cDecoder.ReadHeaderFile(sPath);
+
+		if (eStatus == JpegStatus::Ok)
+		{
+			SIZE szThumb = GetThumbSize({ cDecoder.GetImageWidth(), cDecoder.GetImageHeight() },iWidth,iHeight,eType);
+			if (szThumb.cx <= 0) eStatus = JpegStatus::Error;
+			else
+			{
+				cDecoder.SetScale(CJpegDecoder::GetScaleFor(cDecoder.GetImageWidth(),cDecoder.GetImageHeight(),(int) szThumb.cx,(int) szThumb.cy));
+
+				CSageBitmap cBitmap;
+				eStatus = DecodeJpeg(cDecoder,eStatus,cBitmap);
+				if (eStatus == JpegStatus::Ok)
+				{
+					if (cDecoder.GetWidth() == szThumb.cx && cDecoder.GetHeight() == szThumb.cy) cThumb = std::move(cBitmap);
+					else if (!cThumb.CreateBitmap((int) szThumb.cx,(int) szThumb.cy) || !ResizeBitmap(*cBitmap,*cThumb,eFilter))
+					{
+						cThumb.Delete();
+						eStatus = JpegStatus::Error;
+					}
+				}
+			}
+		}
+		else if (eStatus == JpegStatus::Unsupported)
+		{
+			Sage::CJpeg cJpeg;
+			CSageBitmap cBitmap;
+			cBitmap = cJpeg.ReadJpegFile(sPath);
+			bool bResult = false;
+			if (cJpeg.GetStatus() == Sage::CJpeg::Status::Ok && cBitmap.isValid()) cThumb = ResizeBitmap(*cBitmap,eType,iWidth,iHeight,eFilter,1,&bResult);
+			eStatus = bResult ? JpegStatus::Ok : JpegStatus::Error;
+		}
+		if (bSuccess) *bSuccess = eStatus == JpegStatus::Ok;
+		return cThumb;
+	}
+
+	// ReadJpegFiles() -- Decode a list of JPEG files on up to iThreads threads (0 = every thread in the Core thread pool).
+	// Returns one CSageBitmap per file, in the same order.  Files that can't be read are empty CSageBitmaps.
+	//
+	[[nodiscard]] inline std::vector<CSageBitmap> ReadJpegFiles(const std::vector<std::string> & vPaths,int iThreads = 0)
+	{
+		std::vector<CSageBitmap> vBitmaps(vPaths.size());
+		auto fTile = [&](int iFile) { vBitmaps[iFile] = ReadJpegFile(vPaths[iFile].c_str()); };
+		GetThreadPool().Run((int) vPaths.size(),GetThreadCount(iThreads),fTile);
+		return vBitmaps;
+	}
+
+}; // namespace Core
+}; // namespace Sage
+#endif // _SageKernels_H_
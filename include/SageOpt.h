@@ -93,6 +93,8 @@
 #include <windows.h>
 #include "ControlGroup.h"
 #include "Sage.h"
+#include "Core/CThreadArena.h"
+#include "Core/COptConst.h"
 
 // $$$$ NOTE $$$$$
 //
@@ -108,13 +110,25 @@
 //
 // Though not how I would like to implment this; In the real world, an overlap would only occur with a runaway program where it wouldn't make a difference anyway.
 //
+// The opt:: functions now get their objects from ThreadTemp() instead of Temp(): each thread has its own arena of cwfOpt objects
+// (see Core/CThreadArena.h), so there is no global lock, and threads building options at the same time never share objects.
+// A cwfOpt::TempScope releases the objects used within a scope, i.e. in a loop that creates controls.
+//
+// The temporaries belong to the thread that built them, and are destroyed when that thread exits -- so an opt:: chain must not
+// be handed to another thread.  To build options on one thread and use them on another (i.e. on a worker for the UI thread),
+// copy the chain into a cwfOpt first, which owns its string:
+//
+//		cwfOpt cOpt = fgColor("red") | Style("Panel");		// On the worker -- a copy, not a temporary
+//		...
+//		cWin.NewButton(10,10,"OK",cOpt);					// On the UI thread
+//
 
 
 // --------------------------------------
 // This file is still under construction
 // --------------------------------------
 
-#define defOpt (*cwfOpt::Temp())
+#define defOpt (*cwfOpt::ThreadTemp())
 #define optRet cwfOpt &
 namespace Sage
 {
@@ -138,6 +152,25 @@ private:
 	void InitTemp();
 public:
 	static cwfOpt * Temp();
+
+	// ThreadTemp() -- A cleared temporary cwfOpt from the calling thread's arena (no locks).  Used by the opt:: functions.
+	// The object is only valid on the calling thread, and only until that thread exits -- copy it to a cwfOpt to use it elsewhere.
+	//
+	static cwfOpt * ThreadTemp()
+	{
+		cwfOpt * cOpt = Core::CThreadArena<cwfOpt>::Next();
+		cOpt->ClearMem();
+		cOpt->sOpt[1] = 0;
+		return cOpt;
+	}
+
+	// TempScope -- Releases the ThreadTemp() objects used while it exists, when it goes out of scope
+	//
+	typedef Core::CThreadArena<cwfOpt>::Scope TempScope;
+
+	// FromConst() -- A cwfOpt with the options of a constant (copt::) chain.  See SAGE_OPT() below.
+	//
+	static cwfOpt FromConst(const Core::COptConst & cOpt) { cwfOpt cNew; cNew.literal(cOpt.s()); return cNew; }
 	static cwfOpt m_cEmpty; 
 	static cwfOpt * GetEmptyObj() { return &m_cEmpty; };	// This should only be used for default Empty on prototypes or in case of allocation error.
 	const char * s();
@@ -1269,6 +1302,26 @@ namespace opt
 
 
 };
+
+// copt:: -- constexpr versions of the opt:: functions, for constant chains built at compile time (see Core/COptConst.h)
+//
+namespace copt = Core::copt;
+
 }; // namespace Sage
 
+// SAGE_OPT() -- Pass a constant copt:: chain where a cwfOpt is taken.  The chain is built at compile time, and the cwfOpt
+// once, the first time the line runs; after that the same cwfOpt is passed with no string building or allocation.
+//
+// i.e. cWin.NewButton(10,10,"OK",SAGE_OPT(copt::Style("Panel") | copt::fgColor("red") | copt::Transparent()));
+//
+// The cwfOpt is shared and const, so run-time options are put in front of it: opt::Width(iWidth) << SAGE_OPT(copt::Style("Panel"))
+//
+#define SAGE_OPT(...) ([]() -> const Sage::cwfOpt &																\
+	{																											\
+		static constexpr Sage::Core::COptConst kOpt = (__VA_ARGS__);											\
+		static_assert(!kOpt.isOverflow(),"SAGE_OPT(): the options are longer than COptConst::kMaxLength");	\
+		static const Sage::cwfOpt cOpt = Sage::cwfOpt::FromConst(kOpt);											\
+		return cOpt;																							\
+	}())
+
 #endif // _SageOpt_h_
\ No newline at end of file